@@ -0,0 +1,87 @@
+#include "Bench.h"
+#include "SyntheticVault.h"
+#include "agent/AgentClient.h"
+#include "agent/VaultAgent.h"
+#include "core/SecureVault.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+using crimson::agent::AgentClient;
+using crimson::agent::VaultAgent;
+using crimson::core::SecureVault;
+
+enum class AgentMode {
+    RoundTrips,   // One request, then wait for its reply, per secret
+    Pipelined,    // Every request queued, then every reply read
+    Batched       // One multi-get frame
+};
+
+static void benchAgentGet(crimson::bench::State& state, size_t secrets, AgentMode mode) {
+    std::string path = "crimson_bench_agent.gpg";
+    std::string socket = "crimson_bench_agent.sock";
+    crimson::bench::writeSyntheticVault(path, secrets);
+    
+    SecureVault vault;
+    vault.openVault(crimson::bench::SYNTHETIC_MASTER_PASSWORD, path);
+    vault.setAutoLockTimeout(0);
+    
+    // Collected before the agent thread owns the vault
+    std::vector<std::string> keys;
+    vault.forEachEntry([&keys](const crimson::core::EntryView& view) {
+        keys.push_back(view.id.toString());
+        return true;
+    });
+    
+    VaultAgent agent(vault, path, socket);
+    std::thread server([&agent] {
+        try {
+            agent.run();
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "agent: %s\n", e.what());
+        }
+    });
+    
+    std::unique_ptr<AgentClient> client;
+    for (int attempt = 0; !client && attempt < 1000; ++attempt) {
+        try {
+            client = std::make_unique<AgentClient>(socket);
+        } catch (const std::runtime_error&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    
+    size_t fetched = 0;
+    while (client && state.keepRunning()) {
+        if (mode == AgentMode::Batched) {
+            fetched += client->get(keys).size();
+        } else if (mode == AgentMode::Pipelined) {
+            for (const auto& key : keys) {
+                client->queueGet({key});
+            }
+            for (size_t i = 0; i < keys.size(); ++i) {
+                fetched += AgentClient::readEntryResults(client->receive()).size();
+            }
+        } else {
+            for (const auto& key : keys) {
+                fetched += client->get({key}).size();
+            }
+        }
+    }
+    
+    client.reset();
+    agent.stop();
+    server.join();
+    vault.closeVault();
+    std::remove(path.c_str());
+    state.setItemsProcessed(fetched);
+    state.setItemLabel("secrets");
+}
+
+CRIMSON_BENCHMARK("Agent/get/roundTrips/500",
+                  [](crimson::bench::State& state) { benchAgentGet(state, 500, AgentMode::RoundTrips); });
+CRIMSON_BENCHMARK("Agent/get/pipelined/500",
+                  [](crimson::bench::State& state) { benchAgentGet(state, 500, AgentMode::Pipelined); });
+CRIMSON_BENCHMARK("Agent/get/batched/500",
+                  [](crimson::bench::State& state) { benchAgentGet(state, 500, AgentMode::Batched); });
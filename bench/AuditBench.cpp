@@ -0,0 +1,119 @@
+#include "Bench.h"
+#include "SyntheticVault.h"
+#include "core/BreachCorpus.h"
+#include "core/SecureVault.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using crimson::core::BreachCorpus;
+using crimson::core::SecureVault;
+
+constexpr size_t CORPUS_RECORDS = 1000000;
+constexpr size_t CORPUS_KNOWN = 1000;   // Records that are the hash of breachedPassword(i)
+
+static std::string breachedPassword(size_t index) {
+    return "breached-password-" + std::to_string(index);
+}
+
+// Sorted SHA-1 corpus of uniformly random records plus a known set of
+// real password hashes, so lookups exercise both hits and misses
+static const std::string& corpusPath() {
+    static const std::string path = [] {
+        std::string built = "crimson_bench_corpus.bin";
+
+        std::vector<std::array<uint8_t, 20>> records(CORPUS_RECORDS);
+        std::mt19937_64 rng(42);
+        for (size_t i = CORPUS_KNOWN; i < records.size(); ++i) {
+            for (uint8_t& byte : records[i]) {
+                byte = static_cast<uint8_t>(rng());
+            }
+        }
+        for (size_t i = 0; i < CORPUS_KNOWN; ++i) {
+            std::vector<uint8_t> hash = BreachCorpus::hashPassword(breachedPassword(i), BreachCorpus::HashType::Sha1);
+            std::copy_n(hash.begin(), std::min(hash.size(), records[i].size()), records[i].begin());
+        }
+        std::sort(records.begin(), records.end());
+
+        std::ofstream file(built, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(records.data()),
+                   static_cast<std::streamsize>(records.size() * sizeof(records[0])));
+        if (!file) {
+            throw std::runtime_error("Failed to write synthetic breach corpus");
+        }
+        return built;
+    }();
+    return path;
+}
+
+static void runLookups(crimson::bench::State& state, size_t bloomBitsPerEntry) {
+    BreachCorpus corpus(corpusPath(), BreachCorpus::HashType::Sha1);
+    if (bloomBitsPerEntry > 0) {
+        corpus.buildBloomFilter(bloomBitsPerEntry);
+    }
+
+    // Half the lookups hit the corpus, half miss it
+    std::vector<std::string> passwords;
+    for (size_t i = 0; i < CORPUS_KNOWN; ++i) {
+        passwords.push_back(breachedPassword(i));
+        passwords.push_back("unbreached-password-" + std::to_string(i));
+    }
+
+    size_t lookups = 0;
+    size_t hits = 0;
+    while (state.keepRunning()) {
+        for (const std::string& password : passwords) {
+            hits += corpus.contains(password) ? 1 : 0;
+        }
+        lookups += passwords.size();
+    }
+
+    state.setItemsProcessed(lookups);
+    state.setItemLabel("lookups");
+    state.setCounter("us_per_lookup", lookups > 0 ? state.elapsedSeconds() * 1e6 / static_cast<double>(lookups) : 0.0);
+    state.setCounter("hit_ratio", lookups > 0 ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0);
+}
+
+static void benchLookup(crimson::bench::State& state) {
+    runLookups(state, 0);
+}
+
+static void benchLookupBloom(crimson::bench::State& state) {
+    runLookups(state, 10);
+}
+
+// Full audit (decrypt, strength, reuse, age and breach check) of every entry
+static void benchAudit(crimson::bench::State& state, size_t entries) {
+    std::string path = "crimson_bench_audit.gpg";
+    crimson::bench::writeSyntheticVault(path, entries);
+
+    SecureVault vault;
+    if (!vault.openVault(crimson::bench::SYNTHETIC_MASTER_PASSWORD, path)) {
+        throw std::runtime_error("Failed to open synthetic vault");
+    }
+    vault.setAutoLockTimeout(0);
+    vault.setBreachCorpus(std::make_shared<BreachCorpus>(corpusPath(), BreachCorpus::HashType::Sha1));
+
+    size_t audited = 0;
+    size_t delivered = 0;
+    while (state.keepRunning()) {
+        SecureVault::AuditSummary summary = vault.auditVault(SecureVault::AuditOptions(),
+            [&delivered](const SecureVault::EntryAudit&) { ++delivered; });
+        audited += summary.entries;
+    }
+
+    vault.closeVault();
+    state.setItemsProcessed(delivered == audited ? audited : 0);
+    state.setItemLabel("entries");
+    std::remove(path.c_str());
+}
+
+CRIMSON_BENCHMARK("BreachCorpus/lookup", benchLookup);
+CRIMSON_BENCHMARK("BreachCorpus/lookup_bloom", benchLookupBloom);
+CRIMSON_BENCHMARK_ARGS("Vault/audit", benchAudit, 100000);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace crimson {
+namespace bench {
+
+/**
+ * @brief Per-run state handed to a benchmark body
+ *
+ * The body runs its measured loop while keepRunning() returns true and
+ * reports how many items (passwords, entries, bytes...) it processed.
+ */
+class State {
+public:
+    explicit State(std::chrono::milliseconds minTime) : min_time_(minTime) {}
+
+    bool keepRunning();
+
+    void setItemsProcessed(size_t items) { items_ = items; }
+    void setItemLabel(const std::string& label) { item_label_ = label; }
+
+    /**
+     * @brief Report an extra figure (e.g. resident memory) alongside the rate
+     */
+    void setCounter(const std::string& name, double value) { counters_.emplace_back(name, value); }
+
+    size_t iterations() const { return iterations_; }
+    size_t items() const { return items_; }
+    const std::string& itemLabel() const { return item_label_; }
+    const std::vector<std::pair<std::string, double>>& counters() const { return counters_; }
+    double elapsedSeconds() const;
+
+private:
+    std::chrono::milliseconds min_time_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point stop_;
+    size_t iterations_ = 0;
+    size_t items_ = 0;
+    std::string item_label_ = "items";
+    std::vector<std::pair<std::string, double>> counters_;
+};
+
+using BenchmarkFn = std::function<void(State&)>;
+
+/**
+ * @brief Register a benchmark with the crimson_bench runner
+ */
+bool registerBenchmark(const std::string& name, BenchmarkFn fn);
+
+using ParameterizedFn = std::function<void(State&, size_t)>;
+
+/**
+ * @brief Register one benchmark per argument, named "<name>/<argument>"
+ */
+bool registerBenchmarkArgs(const std::string& name, const std::vector<size_t>& args, ParameterizedFn fn);
+
+} // namespace bench
+} // namespace crimson
+
+#define CRIMSON_BENCH_CONCAT_IMPL(a, b) a##b
+#define CRIMSON_BENCH_CONCAT(a, b) CRIMSON_BENCH_CONCAT_IMPL(a, b)
+
+#define CRIMSON_BENCHMARK(name, fn) \
+    static const bool CRIMSON_BENCH_CONCAT(crimson_bench_registered_, __LINE__) = \
+        ::crimson::bench::registerBenchmark(name, fn)
+
+// CRIMSON_BENCHMARK_ARGS("Suite/case", fn, 10, 100, 1000) registers
+// Suite/case/10, Suite/case/100 and Suite/case/1000
+#define CRIMSON_BENCHMARK_ARGS(name, fn, ...) \
+    static const bool CRIMSON_BENCH_CONCAT(crimson_bench_registered_, __LINE__) = \
+        ::crimson::bench::registerBenchmarkArgs(name, std::vector<size_t>{__VA_ARGS__}, fn)
@@ -0,0 +1,175 @@
+#include "Bench.h"
+#include "core/EntryCodec.h"
+#include "core/Executor.h"
+#include "core/Timestamp.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+
+namespace crimson {
+namespace bench {
+
+static std::map<std::string, BenchmarkFn>& registry() {
+    static std::map<std::string, BenchmarkFn> benchmarks;
+    return benchmarks;
+}
+
+bool registerBenchmark(const std::string& name, BenchmarkFn fn) {
+    return registry().emplace(name, std::move(fn)).second;
+}
+
+bool registerBenchmarkArgs(const std::string& name, const std::vector<size_t>& args, ParameterizedFn fn) {
+    bool registered = true;
+    for (size_t arg : args) {
+        registered &= registerBenchmark(name + "/" + std::to_string(arg),
+                                        [fn, arg](State& state) { fn(state, arg); });
+    }
+    return registered;
+}
+
+bool State::keepRunning() {
+    auto now = std::chrono::steady_clock::now();
+    if (iterations_ == 0) {
+        start_ = now;
+    }
+
+    if (iterations_ > 0 && now - start_ >= min_time_) {
+        stop_ = now;
+        return false;
+    }
+
+    ++iterations_;
+    return true;
+}
+
+double State::elapsedSeconds() const {
+    return std::chrono::duration<double>(stop_ - start_).count();
+}
+
+} // namespace bench
+} // namespace crimson
+
+namespace {
+
+void appendNumber(double value, std::string& out) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+    out += buffer;
+}
+
+void printText(const std::string& name, const crimson::bench::State& state, double perSecond) {
+    std::cout << std::left << std::setw(48) << name
+              << std::right << std::setw(10) << state.iterations() << " iters  "
+              << std::fixed << std::setprecision(1) << std::setw(14) << perSecond
+              << " " << state.itemLabel() << "/s";
+    for (const auto& [counter, value] : state.counters()) {
+        std::cout << "  " << counter << "=" << value;
+    }
+    std::cout << std::endl;
+}
+
+// One element of the "benchmarks" array
+std::string toJson(const std::string& name, const crimson::bench::State& state, double perSecond) {
+    using crimson::core::EntryCodec;
+    double seconds = state.elapsedSeconds();
+
+    std::string out = "{\"name\": ";
+    EntryCodec::appendJsonString(name, out);
+    out += ", \"iterations\": " + std::to_string(state.iterations());
+    out += ", \"seconds\": ";
+    appendNumber(seconds, out);
+    out += ", \"ns_per_iteration\": ";
+    appendNumber(state.iterations() ? seconds * 1e9 / static_cast<double>(state.iterations()) : 0.0, out);
+    out += ", \"items\": " + std::to_string(state.items());
+    out += ", \"item_label\": ";
+    EntryCodec::appendJsonString(state.itemLabel(), out);
+    out += ", \"items_per_second\": ";
+    appendNumber(perSecond, out);
+    out += ", \"counters\": {";
+    bool first = true;
+    for (const auto& [counter, value] : state.counters()) {
+        out += first ? "" : ", ";
+        first = false;
+        EntryCodec::appendJsonString(counter, out);
+        out += ": ";
+        appendNumber(value, out);
+    }
+    out += "}}";
+    return out;
+}
+
+int usage(const char* program) {
+    std::cerr << "Usage: " << program << " [--json] [--list] [--min-time MS] [FILTER]\n"
+              << "  FILTER     run only benchmarks whose name contains it\n"
+              << "  --json     print results as JSON, for comparing releases\n"
+              << "  --list     print the benchmark names and exit\n"
+              << "  --min-time measured time per benchmark (default 500 ms)\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace crimson::bench;
+
+    std::string filter;
+    bool json = false;
+    bool list = false;
+    long minTimeMs = 500;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--json") {
+            json = true;
+        } else if (arg == "--list") {
+            list = true;
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            char* end = nullptr;
+            minTimeMs = std::strtol(argv[++i], &end, 10);
+            if (*end != '\0' || minTimeMs <= 0) {
+                return usage(argv[0]);
+            }
+        } else if (arg.compare(0, 2, "--") == 0 || !filter.empty()) {
+            return usage(argv[0]);
+        } else {
+            filter = arg;
+        }
+    }
+
+    std::string results;
+    for (const auto& [name, fn] : registry()) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (list) {
+            std::cout << name << std::endl;
+            continue;
+        }
+
+        State state{std::chrono::milliseconds(minTimeMs)};
+        fn(state);
+
+        double seconds = state.elapsedSeconds();
+        double perSecond = seconds > 0.0 ? static_cast<double>(state.items()) / seconds : 0.0;
+
+        if (json) {
+            results += results.empty() ? "\n    " : ",\n    ";
+            results += toJson(name, state, perSecond);
+            std::cerr << name << std::endl;   // Progress; stdout stays valid JSON
+        } else {
+            printText(name, state, perSecond);
+        }
+    }
+
+    if (json && !list) {
+        std::string out = "{\"context\": {\"date\": ";
+        crimson::core::EntryCodec::appendJsonString(crimson::core::Timestamp::now().toIso(), out);
+        out += ", \"threads\": " + std::to_string(crimson::core::Executor::shared().threadCount());
+        out += ", \"min_time_ms\": " + std::to_string(minTimeMs);
+        out += "},\n\"benchmarks\": [" + results + (results.empty() ? "]}" : "\n]}");
+        std::cout << out << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,170 @@
+#include "Bench.h"
+#include "core/CryptoManager.h"
+#include "core/SecureMemory.h"
+#include "core/VaultEntry.h"
+#include <cstring>
+#include <stdexcept>
+
+#ifdef HAVE_CRYPTO_LIBS
+#include <argon2.h>
+#endif
+
+using crimson::core::CryptoManager;
+using crimson::core::SecureMemory;
+
+constexpr const char* BENCH_PASSWORD = "correct horse battery staple";
+
+static std::string plaintextOf(size_t bytes) {
+    std::string text(bytes, '\0');
+    for (size_t i = 0; i < bytes; ++i) {
+        text[i] = static_cast<char>('!' + i % 94);
+    }
+    return text;
+}
+
+// Key derivation as the vault does it, with its built-in Argon2 settings
+static void benchDeriveKey(crimson::bench::State& state) {
+    CryptoManager crypto;
+    crypto.initialize();
+    std::string salt = crypto.generateSalt();
+    
+    size_t derived = 0;
+    while (state.keepRunning()) {
+        auto key = crypto.deriveKey(BENCH_PASSWORD, salt);
+        derived += key->size() == 32;
+    }
+    
+    state.setItemsProcessed(derived);
+    state.setItemLabel("keys");
+}
+
+CRIMSON_BENCHMARK("Crypto/deriveKey/default", benchDeriveKey);
+
+#ifdef HAVE_CRYPTO_LIBS
+// Argon2id directly, for settings CryptoManager does not expose
+static void benchArgon2id(crimson::bench::State& state, uint32_t timeCost, uint32_t memoryKiB, uint32_t lanes) {
+    const uint8_t salt[32] = {};
+    uint8_t key[32];
+    
+    size_t derived = 0;
+    while (state.keepRunning()) {
+        int ret = argon2id_hash_raw(timeCost, memoryKiB, lanes, BENCH_PASSWORD, std::strlen(BENCH_PASSWORD),
+                                    salt, sizeof(salt), key, sizeof(key));
+        if (ret != ARGON2_OK) {
+            throw std::runtime_error(argon2_error_message(ret));
+        }
+        ++derived;
+    }
+    
+    SecureMemory::secureZero(key, sizeof(key));
+    state.setItemsProcessed(derived);
+    state.setItemLabel("keys");
+}
+
+// Memory cost in KiB at the vault's time cost and parallelism; 19456 is
+// the OWASP minimum, 65536 what the vault uses
+CRIMSON_BENCHMARK_ARGS("Crypto/argon2id/t3/p4/memoryKiB",
+                       [](crimson::bench::State& state, size_t memoryKiB) {
+                           benchArgon2id(state, 3, static_cast<uint32_t>(memoryKiB), 4);
+                       }, 19456, 65536, 262144);
+CRIMSON_BENCHMARK_ARGS("Crypto/argon2id/m65536/p4/timeCost",
+                       [](crimson::bench::State& state, size_t timeCost) {
+                           benchArgon2id(state, static_cast<uint32_t>(timeCost), 65536, 4);
+                       }, 1, 3, 6);
+CRIMSON_BENCHMARK_ARGS("Crypto/argon2id/t3/m65536/lanes",
+                       [](crimson::bench::State& state, size_t lanes) {
+                           benchArgon2id(state, 3, 65536, static_cast<uint32_t>(lanes));
+                       }, 1, 4);
+#endif
+
+static void benchEncrypt(crimson::bench::State& state, size_t bytes) {
+    CryptoManager crypto;
+    crypto.initialize();
+    std::string salt = crypto.generateSalt();
+    auto key = crypto.deriveKey(BENCH_PASSWORD, salt);
+    const std::string plaintext = plaintextOf(bytes);
+    
+    size_t processed = 0;
+    while (state.keepRunning()) {
+        processed += crypto.encrypt(plaintext, *key).size();
+    }
+    
+    state.setItemsProcessed(processed);
+    state.setItemLabel("bytes");
+}
+
+static void benchDecrypt(crimson::bench::State& state, size_t bytes, bool inPlace) {
+    CryptoManager crypto;
+    crypto.initialize();
+    std::string salt = crypto.generateSalt();
+    auto key = crypto.deriveKey(BENCH_PASSWORD, salt);
+    const std::vector<uint8_t> ciphertext = crypto.encrypt(plaintextOf(bytes), *key);
+    auto out = SecureMemory::createBuffer(ciphertext.size());
+    
+    size_t processed = 0;
+    while (state.keepRunning()) {
+        if (inPlace) {
+            processed += crypto.decrypt(ciphertext, *key, *out);
+        } else {
+            std::string plaintext = crypto.decrypt(ciphertext, *key);
+            processed += plaintext.size();
+            SecureMemory::secureZero(plaintext);
+        }
+    }
+    
+    state.setItemsProcessed(processed);
+    state.setItemLabel("bytes");
+}
+
+// Sizes in bytes: a password, a note, a large attachment
+CRIMSON_BENCHMARK_ARGS("Crypto/encrypt", benchEncrypt, 16, 256, 4096, 65536);
+CRIMSON_BENCHMARK_ARGS("Crypto/decrypt",
+                       [](crimson::bench::State& state, size_t bytes) { benchDecrypt(state, bytes, false); },
+                       16, 256, 4096, 65536);
+CRIMSON_BENCHMARK_ARGS("Crypto/decrypt/inPlace",
+                       [](crimson::bench::State& state, size_t bytes) { benchDecrypt(state, bytes, true); },
+                       16, 256, 4096, 65536);
+
+static void benchToBase64(crimson::bench::State& state, size_t bytes) {
+    const std::string text = plaintextOf(bytes);
+    const std::vector<uint8_t> data(text.begin(), text.end());
+    
+    size_t processed = 0;
+    while (state.keepRunning()) {
+        processed += CryptoManager::toBase64(data).size() * 3 / 4;
+    }
+    
+    state.setItemsProcessed(processed);
+    state.setItemLabel("bytes");
+}
+
+static void benchFromBase64(crimson::bench::State& state, size_t bytes) {
+    const std::string text = plaintextOf(bytes);
+    const std::string encoded = CryptoManager::toBase64(std::vector<uint8_t>(text.begin(), text.end()));
+    
+    size_t processed = 0;
+    while (state.keepRunning()) {
+        processed += CryptoManager::fromBase64(encoded).size();
+    }
+    
+    state.setItemsProcessed(processed);
+    state.setItemLabel("bytes");
+}
+
+// Decoded sizes in bytes: a stored password (64), a salt (32), 64 KiB
+CRIMSON_BENCHMARK_ARGS("Crypto/toBase64", benchToBase64, 32, 64, 65536);
+CRIMSON_BENCHMARK_ARGS("Crypto/fromBase64", benchFromBase64, 32, 64, 65536);
+
+// Computed once per process and cached; this measures the cached call
+// that every saved entry and vault header makes
+static void benchDeviceFingerprint(crimson::bench::State& state) {
+    size_t calls = 0;
+    while (state.keepRunning()) {
+        calls += !crimson::core::VaultEntry::getDeviceFingerprint().empty();
+    }
+    
+    state.setItemsProcessed(calls);
+    state.setItemLabel("calls");
+}
+
+CRIMSON_BENCHMARK("VaultEntry/getDeviceFingerprint", benchDeviceFingerprint);
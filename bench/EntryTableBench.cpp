@@ -0,0 +1,79 @@
+#include "Bench.h"
+#include "SyntheticVault.h"
+#include "core/EntryTable.h"
+#include "core/VaultEntry.h"
+#include <fstream>
+
+using crimson::core::EntryTable;
+using crimson::core::Timestamp;
+using crimson::core::VaultEntry;
+using crimson::bench::syntheticEntry;
+
+static constexpr size_t SCAN_ENTRIES = 1000000;
+
+// Resident set size in bytes (0 where /proc is unavailable)
+static double residentBytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0, resident = 0;
+    statm >> pages >> resident;
+    return static_cast<double>(resident) * 4096.0;
+#else
+    return 0.0;
+#endif
+}
+
+// Row-per-entry layout the vault used before EntryTable
+static void benchVectorScan(crimson::bench::State& state) {
+    double before = residentBytes();
+    std::vector<VaultEntry> entries;
+    entries.reserve(SCAN_ENTRIES);
+    for (size_t i = 0; i < SCAN_ENTRIES; ++i) {
+        entries.push_back(syntheticEntry(i));
+    }
+    double resident = residentBytes() - before;
+
+    const Timestamp cutoff(1600000000 + 30000000);
+    size_t scanned = 0;
+    size_t matched = 0;
+
+    while (state.keepRunning()) {
+        for (const auto& entry : entries) {
+            matched += entry.created_at < cutoff && !entry.label.empty();
+        }
+        scanned += entries.size();
+    }
+
+    state.setItemsProcessed(matched > 0 ? scanned : 0);
+    state.setItemLabel("entries");
+    state.setCounter("rss_mb", resident / (1024.0 * 1024.0));
+}
+
+static void benchTableScan(crimson::bench::State& state) {
+    double before = residentBytes();
+    EntryTable table;
+    table.reserve(SCAN_ENTRIES, SCAN_ENTRIES * 128);
+    for (size_t i = 0; i < SCAN_ENTRIES; ++i) {
+        table.append(syntheticEntry(i));
+    }
+    double resident = residentBytes() - before;
+
+    const Timestamp cutoff(1600000000 + 30000000);
+    size_t scanned = 0;
+    size_t matched = 0;
+
+    while (state.keepRunning()) {
+        for (size_t row = 0; row < table.size(); ++row) {
+            matched += table.createdAt(row) < cutoff && !table.label(row).empty();
+        }
+        scanned += table.size();
+    }
+
+    state.setItemsProcessed(matched > 0 ? scanned : 0);
+    state.setItemLabel("entries");
+    state.setCounter("rss_mb", resident / (1024.0 * 1024.0));
+    state.setCounter("table_mb", static_cast<double>(table.memoryUsage()) / (1024.0 * 1024.0));
+}
+
+CRIMSON_BENCHMARK("EntryScan/vector/1000000", benchVectorScan);
+CRIMSON_BENCHMARK("EntryScan/table/1000000", benchTableScan);
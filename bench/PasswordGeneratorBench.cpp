@@ -0,0 +1,51 @@
+#include "Bench.h"
+#include "core/PasswordGenerator.h"
+
+using crimson::core::PasswordGenerator;
+using crimson::core::PasswordPolicy;
+
+static void benchGeneratePassword(crimson::bench::State& state, size_t length) {
+    PasswordGenerator generator;
+    size_t generated = 0;
+
+    while (state.keepRunning()) {
+        std::string password = generator.generatePassword(length, true);
+        generated += password.size() == length;
+    }
+
+    state.setItemsProcessed(generated);
+    state.setItemLabel("passwords");
+}
+
+static void benchGeneratePasswords(crimson::bench::State& state) {
+    PasswordGenerator generator;
+    size_t generated = 0;
+
+    while (state.keepRunning()) {
+        auto batch = generator.generatePasswords(10000, 64, PasswordPolicy::standard());
+        generated += batch.count();
+    }
+
+    state.setItemsProcessed(generated);
+    state.setItemLabel("passwords");
+}
+
+CRIMSON_BENCHMARK_ARGS("PasswordGenerator/generatePassword", benchGeneratePassword, 16, 32, 64, 128);
+CRIMSON_BENCHMARK("PasswordGenerator/generatePasswords/10000x64", benchGeneratePasswords);
+
+static void benchGeneratePolicyInPlace(crimson::bench::State& state) {
+    PasswordGenerator generator;
+    char buffer[20];
+    size_t generated = 0;
+
+    while (state.keepRunning()) {
+        generator.generatePassword(crimson::core::policies::LEGACY_WEB, buffer, sizeof(buffer));
+        ++generated;
+    }
+
+    crimson::core::SecureMemory::secureZero(buffer, sizeof(buffer));
+    state.setItemsProcessed(generated);
+    state.setItemLabel("passwords");
+}
+
+CRIMSON_BENCHMARK("PasswordGenerator/generatePassword/legacyWeb/inPlace", benchGeneratePolicyInPlace);
@@ -0,0 +1,59 @@
+#include "Bench.h"
+#include "core/SearchIndex.h"
+#include <cstdio>
+
+using crimson::core::SearchIndex;
+
+// One million entries with realistic-looking labels and usernames
+static const SearchIndex& millionEntryIndex() {
+    static const SearchIndex index = [] {
+        static const char* services[] = {
+            "Gmail", "GitHub", "Bank of Somewhere", "Netflix", "Amazon",
+            "Work VPN", "Router admin", "Steam", "Dropbox", "Service account"
+        };
+        SearchIndex built;
+        char id[40];
+        for (size_t i = 0; i < 1000000; ++i) {
+            std::snprintf(id, sizeof(id), "%08zx-0000-4000-8000-%012zx", i, i);
+            built.add(crimson::core::EntryId::fromString(id),
+                      std::string(services[i % 10]) + " " + std::to_string(i),
+                      "user_" + std::to_string(i * 7919 % 1000003));
+        }
+        return built;
+    }();
+    return index;
+}
+
+// Replays typing a query one keystroke at a time
+static void runKeystrokes(crimson::bench::State& state, const std::string& query) {
+    const SearchIndex& index = millionEntryIndex();
+    size_t keystrokes = 0;
+    size_t matched = 0;
+
+    while (state.keepRunning()) {
+        for (size_t length = 1; length <= query.size(); ++length) {
+            auto results = index.search(query.substr(0, length), 200);
+            matched += results.size();
+            ++keystrokes;
+        }
+    }
+
+    state.setItemsProcessed(matched > 0 ? keystrokes : 0);
+    state.setItemLabel("keystrokes");
+}
+
+static void benchSearchPrefix(crimson::bench::State& state) {
+    runKeystrokes(state, "netflix 4242");
+}
+
+static void benchSearchSubstring(crimson::bench::State& state) {
+    runKeystrokes(state, "account 99");
+}
+
+static void benchSearchFuzzy(crimson::bench::State& state) {
+    runKeystrokes(state, "githbu 12345");
+}
+
+CRIMSON_BENCHMARK("SearchIndex/prefix/1000000", benchSearchPrefix);
+CRIMSON_BENCHMARK("SearchIndex/substring/1000000", benchSearchSubstring);
+CRIMSON_BENCHMARK("SearchIndex/fuzzy/1000000", benchSearchFuzzy);
@@ -0,0 +1,79 @@
+#include "SyntheticVault.h"
+#include "core/CryptoManager.h"
+#include "core/SecureVault.h"
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace crimson {
+namespace bench {
+
+void writeSyntheticVault(const std::string& path, size_t entries) {
+    {
+        core::SecureVault vault;
+        if (!vault.createVault(SYNTHETIC_MASTER_PASSWORD, path)) {
+            throw std::runtime_error("Failed to create synthetic vault");
+        }
+    }
+    
+    std::ifstream in(path);
+    std::string header((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+    
+    QJsonObject root = QJsonDocument::fromJson(QByteArray::fromStdString(header)).object();
+    std::string salt = root["salt"].toString().toStdString();
+    
+    core::CryptoManager crypto;
+    crypto.initialize();
+    auto key = crypto.deriveKey(SYNTHETIC_MASTER_PASSWORD, salt);
+    
+    std::ofstream out(path, std::ios::trunc);
+    out << "{\n"
+        << "    \"created_at\": \"" << root["created_at"].toString().toStdString() << "\",\n"
+        << "    \"device_fingerprint\": \"" << root["device_fingerprint"].toString().toStdString() << "\",\n"
+        << "    \"entries\": [\n";
+    
+    for (size_t i = 0; i < entries; ++i) {
+        std::string password = "Synthetic!Password#" + std::to_string(i % 50000);
+        std::string encrypted = core::CryptoManager::toBase64(crypto.encrypt(password, *key));
+        
+        char id[40];
+        std::snprintf(id, sizeof(id), "%08zx-0000-4000-8000-%012zx", i, i);
+        
+        out << "        {\n"
+            << "            \"created_at\": \"20" << (15 + i % 10) << "-0" << (1 + i % 9)
+            << "-1" << (i % 10) << "T12:00:00Z\",\n"
+            << "            \"device_fingerprint\": \"" << root["device_fingerprint"].toString().toStdString() << "\",\n"
+            << "            \"id\": \"" << id << "\",\n"
+            << "            \"label\": \"Service account " << i << "\",\n"
+            << "            \"password\": \"" << encrypted << "\",\n"
+            << "            \"username\": \"user_" << i << "\"\n"
+            << "        }" << (i + 1 < entries ? "," : "") << "\n";
+    }
+    
+    out << "    ],\n"
+        << "    \"master_hash\": \"" << root["master_hash"].toString().toStdString() << "\",\n"
+        << "    \"salt\": \"" << salt << "\",\n"
+        << "    \"version\": \"1.0\"\n"
+        << "}\n";
+}
+
+core::VaultEntry syntheticEntry(size_t index) {
+    char id[40];
+    std::snprintf(id, sizeof(id), "%08zx-0000-4000-8000-%012zx", index, index);
+    
+    core::VaultEntry entry;
+    entry.id = core::EntryId::fromString(id);
+    entry.label = "Service account " + std::to_string(index);
+    entry.username = "user_" + std::to_string(index * 7919 % 1000003);
+    entry.password = std::string(88, 'A');   // Base64 of a 64-byte ciphertext
+    entry.created_at = core::Timestamp(1600000000 + static_cast<int64_t>(index) * 60);
+    entry.device_fingerprint = std::string(64, 'f');
+    return entry;
+}
+
+} // namespace bench
+} // namespace crimson
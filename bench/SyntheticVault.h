@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include "core/VaultEntry.h"
+
+namespace crimson {
+namespace bench {
+
+/**
+ * @brief Master password used for every synthetic vault
+ */
+constexpr const char* SYNTHETIC_MASTER_PASSWORD = "crimson-bench-master";
+
+/**
+ * @brief Write a vault file with the given number of entries
+ * 
+ * The header is produced by SecureVault::createVault so salt and master
+ * hash are genuine; entries are appended directly with real encrypted
+ * passwords, avoiding one full file rewrite per saveEntry().
+ * 
+ * @param path Output vault file
+ * @param entries Number of entries to generate
+ */
+void writeSyntheticVault(const std::string& path, size_t entries);
+
+/**
+ * @brief Deterministic in-memory entry for table and codec benchmarks
+ * 
+ * The password is placeholder Base64 of ciphertext length, not a real
+ * encryption, so building millions of these stays cheap.
+ * 
+ * @param index Entry number (determines id, label, username and time)
+ */
+core::VaultEntry syntheticEntry(size_t index);
+
+} // namespace bench
+} // namespace crimson
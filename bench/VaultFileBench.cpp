@@ -0,0 +1,205 @@
+#include "Bench.h"
+#include "SyntheticVault.h"
+#include "core/EntryCodec.h"
+#include "core/EntryTable.h"
+#include "core/Executor.h"
+#include "core/VaultReader.h"
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <algorithm>
+
+using crimson::core::EntryCodec;
+using crimson::core::EntryTable;
+using crimson::core::VaultEntry;
+using crimson::core::VaultReader;
+
+// Decoding tasks beyond the shared executor's size would only queue
+static unsigned hardwareThreads() {
+    return crimson::core::Executor::shared().threadCount();
+}
+
+static void fillTable(EntryTable& table, size_t entries) {
+    table.reserve(entries, entries * 128);
+    for (size_t i = 0; i < entries; ++i) {
+        table.append(crimson::bench::syntheticEntry(i));
+    }
+}
+
+// VaultEntry::toJson as it was before EntryCodec: a QJsonObject per entry
+// serialized through its own QJsonDocument
+static std::string legacyToJson(const VaultEntry& entry) {
+    QJsonObject obj;
+    obj["id"] = QString::fromStdString(entry.id.toString());
+    obj["label"] = QString::fromStdString(entry.label);
+    obj["username"] = QString::fromStdString(entry.username);
+    obj["password"] = QString::fromStdString(entry.password);
+    obj["created_at"] = QString::fromStdString(entry.created_at.toIso());
+    obj["device_fingerprint"] = QString::fromStdString(entry.device_fingerprint);
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact).toStdString();
+}
+
+// Save path before EntryCodec: entry -> JSON text -> re-parsed object -> document
+static std::string legacySave(const EntryTable& table) {
+    QJsonObject root;
+    root["version"] = "1.0";
+    QJsonArray entriesArray;
+    for (size_t row = 0; row < table.size(); ++row) {
+        QJsonDocument entryDoc = QJsonDocument::fromJson(QByteArray::fromStdString(legacyToJson(table.materialize(row))));
+        entriesArray.append(entryDoc.object());
+    }
+    root["entries"] = entriesArray;
+    return QJsonDocument(root).toJson().toStdString();
+}
+
+// Save path with EntryCodec, as in SecureVault::saveVaultFile
+static std::string directSave(const EntryTable& table) {
+    std::string content;
+    content.reserve(512 + table.size() * 384);
+    content += "{\n    \"version\": \"1.0\",\n    \"entries\": [";
+    VaultEntry entry;
+    for (size_t row = 0; row < table.size(); ++row) {
+        table.materialize(row, entry);
+        content += row == 0 ? "\n        " : ",\n        ";
+        EntryCodec::appendJson(entry, content);
+    }
+    content += table.empty() ? "]\n}\n" : "\n    ]\n}\n";
+    return content;
+}
+
+// Load path before EntryCodec: each parsed object is printed and parsed again
+static void legacyLoad(const std::string& content, EntryTable& table) {
+    QJsonObject root = QJsonDocument::fromJson(QByteArray::fromStdString(content)).object();
+    QJsonArray entriesArray = root["entries"].toArray();
+    table.clear();
+    table.reserve(static_cast<size_t>(entriesArray.size()));
+    for (const auto& value : entriesArray) {
+        QJsonDocument entryDoc(value.toObject());
+        table.append(VaultEntry::fromJson(entryDoc.toJson().toStdString()));
+    }
+}
+
+static void directLoad(const std::string& content, EntryTable& table) {
+    QJsonObject root = QJsonDocument::fromJson(QByteArray::fromStdString(content)).object();
+    QJsonArray entriesArray = root["entries"].toArray();
+    table.clear();
+    table.reserve(static_cast<size_t>(entriesArray.size()));
+    for (const auto& value : entriesArray) {
+        table.append(EntryCodec::fromJson(value.toObject()));
+    }
+}
+
+static void benchSave(crimson::bench::State& state, size_t entries, bool legacy) {
+    EntryTable table;
+    fillTable(table, entries);
+
+    size_t saved = 0;
+    size_t bytes = 0;
+    while (state.keepRunning()) {
+        bytes = (legacy ? legacySave(table) : directSave(table)).size();
+        saved += entries;
+    }
+
+    state.setItemsProcessed(saved);
+    state.setItemLabel("entries");
+    state.setCounter("file_mb", static_cast<double>(bytes) / (1024.0 * 1024.0));
+}
+
+static void benchLoad(crimson::bench::State& state, size_t entries, bool legacy) {
+    std::string content;
+    {
+        EntryTable source;
+        fillTable(source, entries);
+        content = directSave(source);
+    }
+
+    EntryTable table;
+    size_t loaded = 0;
+    while (state.keepRunning()) {
+        if (legacy) {
+            legacyLoad(content, table);
+        } else {
+            directLoad(content, table);
+        }
+        loaded += table.size();
+    }
+
+    state.setItemsProcessed(loaded);
+    state.setItemLabel("entries");
+}
+
+// Load path through the structural index, as in SecureVault::loadVaultFile
+static void benchStreamLoad(crimson::bench::State& state, size_t entries, unsigned threads) {
+    std::string content;
+    {
+        EntryTable source;
+        fillTable(source, entries);
+        content = directSave(source);
+    }
+
+    EntryTable table;
+    size_t loaded = 0;
+    size_t bytes = 0;
+    while (state.keepRunning()) {
+        VaultReader::read(content, table, threads);
+        loaded += table.size();
+        bytes += content.size();
+    }
+
+    state.setItemsProcessed(loaded);
+    state.setItemLabel("entries");
+    state.setCounter("mb_per_s", static_cast<double>(bytes) / (1024.0 * 1024.0) / state.elapsedSeconds());
+}
+
+static void benchBinaryRoundTrip(crimson::bench::State& state, size_t entries) {
+    EntryTable table;
+    fillTable(table, entries);
+
+    std::string buffer;
+    size_t decoded = 0;
+    VaultEntry entry;
+    while (state.keepRunning()) {
+        buffer.clear();
+        for (size_t row = 0; row < table.size(); ++row) {
+            table.materialize(row, entry);
+            EntryCodec::appendBinary(entry, buffer);
+        }
+
+        std::string_view remaining(buffer);
+        while (!remaining.empty()) {
+            remaining.remove_prefix(EntryCodec::readBinary(remaining, entry));
+            ++decoded;
+        }
+    }
+
+    state.setItemsProcessed(decoded);
+    state.setItemLabel("entries");
+    state.setCounter("buffer_mb", static_cast<double>(buffer.size()) / (1024.0 * 1024.0));
+}
+
+CRIMSON_BENCHMARK("VaultFile/save/legacy/100000",
+                  [](crimson::bench::State& state) { benchSave(state, 100000, true); });
+CRIMSON_BENCHMARK("VaultFile/save/direct/100000",
+                  [](crimson::bench::State& state) { benchSave(state, 100000, false); });
+CRIMSON_BENCHMARK("VaultFile/save/legacy/1000000",
+                  [](crimson::bench::State& state) { benchSave(state, 1000000, true); });
+CRIMSON_BENCHMARK("VaultFile/save/direct/1000000",
+                  [](crimson::bench::State& state) { benchSave(state, 1000000, false); });
+CRIMSON_BENCHMARK("VaultFile/load/legacy/100000",
+                  [](crimson::bench::State& state) { benchLoad(state, 100000, true); });
+CRIMSON_BENCHMARK("VaultFile/load/direct/100000",
+                  [](crimson::bench::State& state) { benchLoad(state, 100000, false); });
+CRIMSON_BENCHMARK("VaultFile/load/legacy/1000000",
+                  [](crimson::bench::State& state) { benchLoad(state, 1000000, true); });
+CRIMSON_BENCHMARK("VaultFile/load/direct/1000000",
+                  [](crimson::bench::State& state) { benchLoad(state, 1000000, false); });
+CRIMSON_BENCHMARK("VaultFile/load/stream/100000",
+                  [](crimson::bench::State& state) { benchStreamLoad(state, 100000, 1); });
+CRIMSON_BENCHMARK("VaultFile/load/stream/1000000",
+                  [](crimson::bench::State& state) { benchStreamLoad(state, 1000000, 1); });
+CRIMSON_BENCHMARK("VaultFile/load/parallel/100000",
+                  [](crimson::bench::State& state) { benchStreamLoad(state, 100000, hardwareThreads()); });
+CRIMSON_BENCHMARK("VaultFile/load/parallel/1000000",
+                  [](crimson::bench::State& state) { benchStreamLoad(state, 1000000, hardwareThreads()); });
+CRIMSON_BENCHMARK("EntryCodec/binary/1000000",
+                  [](crimson::bench::State& state) { benchBinaryRoundTrip(state, 1000000); });
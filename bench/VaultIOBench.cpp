@@ -0,0 +1,84 @@
+#include "Bench.h"
+#include "SyntheticVault.h"
+#include "core/Metrics.h"
+#include "core/SecureVault.h"
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+using crimson::core::MetricsRegistry;
+using crimson::core::OperationMetrics;
+using crimson::core::SecureVault;
+
+// loadVaultFile and saveVaultFile are private; they are timed through the
+// public calls that run them, and their own share is read back from the
+// operation metrics they record
+
+static double fileMegabytes(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return static_cast<double>(file.tellg()) / (1024.0 * 1024.0);
+}
+
+static double meanMilliseconds(OperationMetrics& metrics) {
+    return metrics.latency.snapshot().meanNanos() / 1e6;
+}
+
+static void benchOpen(crimson::bench::State& state, size_t entries) {
+    std::string path = "crimson_bench_io.gpg";
+    crimson::bench::writeSyntheticVault(path, entries);
+    
+    OperationMetrics& load = MetricsRegistry::global().operation("vault.load_file");
+    load.latency.reset();
+    
+    SecureVault vault;
+    size_t loaded = 0;
+    while (state.keepRunning()) {
+        if (!vault.openVault(crimson::bench::SYNTHETIC_MASTER_PASSWORD, path)) {
+            throw std::runtime_error("Failed to open synthetic vault");
+        }
+        loaded += vault.getEntryCount();
+        vault.closeVault();
+    }
+    
+    state.setItemsProcessed(loaded);
+    state.setItemLabel("entries");
+    state.setCounter("load_file_ms", meanMilliseconds(load));
+    state.setCounter("file_mb", fileMegabytes(path));
+    std::remove(path.c_str());
+}
+
+static void benchSave(crimson::bench::State& state, size_t entries) {
+    std::string path = "crimson_bench_io.gpg";
+    crimson::bench::writeSyntheticVault(path, entries);
+    
+    SecureVault vault;
+    if (!vault.openVault(crimson::bench::SYNTHETIC_MASTER_PASSWORD, path)) {
+        throw std::runtime_error("Failed to open synthetic vault");
+    }
+    vault.setAutoLockTimeout(0);
+    crimson::core::VaultEntry entry = vault.createEntry("Benchmark entry");
+    
+    OperationMetrics& save = MetricsRegistry::global().operation("vault.save_file");
+    save.latency.reset();
+    
+    // Each save rewrites the whole file
+    size_t written = 0;
+    while (state.keepRunning()) {
+        if (!vault.saveEntry(entry)) {
+            throw std::runtime_error("Failed to save synthetic vault");
+        }
+        written += vault.getEntryCount();
+    }
+    
+    vault.closeVault();
+    state.setItemsProcessed(written);
+    state.setItemLabel("entries");
+    state.setCounter("save_file_ms", meanMilliseconds(save));
+    state.setCounter("file_mb", fileMegabytes(path));
+    std::remove(path.c_str());
+}
+
+// openVault includes the key derivation, which dominates small vaults;
+// load_file_ms is the file read and decode alone
+CRIMSON_BENCHMARK_ARGS("Vault/open", benchOpen, 10, 100, 1000, 10000, 100000, 1000000);
+CRIMSON_BENCHMARK_ARGS("Vault/save", benchSave, 10, 100, 1000, 10000, 100000, 1000000);
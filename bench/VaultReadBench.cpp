@@ -0,0 +1,89 @@
+#include "Bench.h"
+#include "SyntheticVault.h"
+#include "core/SecureVault.h"
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using crimson::core::EntryId;
+using crimson::core::SecureVault;
+
+// Lookups per thread per iteration; large enough to hide thread start-up
+constexpr size_t LOOKUPS_PER_THREAD = 20000;
+
+enum class ReadKind {
+    View,     // getEntryView by ID
+    Search,   // search() on a label prefix
+    Recent    // Most recently used page, with every 16th lookup reading a password
+};
+
+static void benchConcurrentReads(crimson::bench::State& state, unsigned threads, ReadKind kind) {
+    const size_t entries = 10000;
+    std::string path = "crimson_bench_read.gpg";
+    crimson::bench::writeSyntheticVault(path, entries);
+    
+    SecureVault vault;
+    vault.openVault(crimson::bench::SYNTHETIC_MASTER_PASSWORD, path);
+    
+    std::vector<EntryId> ids;
+    vault.forEachEntry([&ids](const crimson::core::EntryView& view) {
+        ids.push_back(view.id);
+        return true;
+    });
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < ids.size(); i += 97) {
+        queries.emplace_back(vault.getEntryView(ids[i]).label.substr(0, 4));
+    }
+    
+    auto reader = [&](unsigned seed) {
+        size_t found = 0;
+        for (size_t i = 0; i < LOOKUPS_PER_THREAD; ++i) {
+            size_t pick = (i * 7919 + seed * 104729) % ids.size();
+            if (kind == ReadKind::View) {
+                found += vault.getEntryView(ids[pick]).label.size();
+            } else if (kind == ReadKind::Search) {
+                found += vault.search(queries[pick % queries.size()], 10).size();
+            } else if (i % 16 == 0) {
+                found += vault.getPassword(ids[pick]).size();
+            } else {
+                found += vault.listEntries(SecureVault::EntryOrder::LastUsed, std::string(), 10, true).entries.size();
+            }
+        }
+        return found;
+    };
+    
+    size_t lookups = 0;
+    while (state.keepRunning()) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(reader, t);
+        }
+        reader(0);
+        for (auto& thread : pool) {
+            thread.join();
+        }
+        lookups += LOOKUPS_PER_THREAD * threads;
+    }
+    
+    vault.closeVault();
+    std::remove(path.c_str());
+    state.setItemsProcessed(lookups);
+    state.setItemLabel("lookups");
+}
+
+CRIMSON_BENCHMARK("Vault/read/view/threads/1",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 1, ReadKind::View); });
+CRIMSON_BENCHMARK("Vault/read/view/threads/2",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 2, ReadKind::View); });
+CRIMSON_BENCHMARK("Vault/read/view/threads/4",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 4, ReadKind::View); });
+CRIMSON_BENCHMARK("Vault/read/view/threads/8",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 8, ReadKind::View); });
+CRIMSON_BENCHMARK("Vault/read/search/threads/1",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 1, ReadKind::Search); });
+CRIMSON_BENCHMARK("Vault/read/search/threads/8",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 8, ReadKind::Search); });
+CRIMSON_BENCHMARK("Vault/read/recent/threads/1",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 1, ReadKind::Recent); });
+CRIMSON_BENCHMARK("Vault/read/recent/threads/8",
+                  [](crimson::bench::State& state) { benchConcurrentReads(state, 8, ReadKind::Recent); });
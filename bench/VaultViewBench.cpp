@@ -0,0 +1,52 @@
+#include "Bench.h"
+#include "SyntheticVault.h"
+#include "core/AsyncVault.h"
+#include "core/SecureVault.h"
+#include "ui/VaultViewDialog.h"
+#include <QtWidgets/QApplication>
+#include <cstdio>
+
+using crimson::core::SecureVault;
+
+static void ensureApplication() {
+    if (!QApplication::instance()) {
+        if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+        }
+        static int argc = 1;
+        static char name[] = "crimson_bench";
+        static char* argv[] = {name, nullptr};
+        static QApplication app(argc, argv);
+    }
+}
+
+static void benchDialogOpen(crimson::bench::State& state, size_t entries) {
+    ensureApplication();
+    
+    std::string path = "crimson_bench_view_" + std::to_string(entries) + ".gpg";
+    crimson::bench::writeSyntheticVault(path, entries);
+    
+    SecureVault vault;
+    vault.openVault(crimson::bench::SYNTHETIC_MASTER_PASSWORD, path);
+    crimson::core::AsyncVault async(vault);
+    
+    size_t opened = 0;
+    while (state.keepRunning()) {
+        crimson::ui::VaultViewDialog dialog(&async);
+        dialog.show();
+        QApplication::processEvents();
+        ++opened;
+    }
+    
+    vault.closeVault();
+    std::remove(path.c_str());
+    state.setItemsProcessed(opened);
+    state.setItemLabel("dialogs");
+}
+
+CRIMSON_BENCHMARK("VaultViewDialog/open/1000",
+                  [](crimson::bench::State& state) { benchDialogOpen(state, 1000); });
+CRIMSON_BENCHMARK("VaultViewDialog/open/100000",
+                  [](crimson::bench::State& state) { benchDialogOpen(state, 100000); });
+CRIMSON_BENCHMARK("VaultViewDialog/open/1000000",
+                  [](crimson::bench::State& state) { benchDialogOpen(state, 1000000); });
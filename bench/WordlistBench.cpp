@@ -0,0 +1,51 @@
+#include "Bench.h"
+#include "core/PasswordGenerator.h"
+#include "core/Wordlist.h"
+#include <cstdio>
+#include <fstream>
+
+using crimson::core::PasswordGenerator;
+using crimson::core::Wordlist;
+
+// Synthetic EFF-style list: "<dice>\t<word>" per line
+static std::string writeSyntheticWordlist(size_t words) {
+    std::string path = "crimson_bench_wordlist.txt";
+    std::ofstream out(path, std::ios::trunc);
+    for (size_t i = 0; i < words; ++i) {
+        out << (10000 + i % 90000) << '\t' << "word" << i << "x" << '\n';
+    }
+    return path;
+}
+
+static void benchWordlistLoad(crimson::bench::State& state) {
+    std::string path = writeSyntheticWordlist(100000);
+    size_t loaded = 0;
+
+    while (state.keepRunning()) {
+        Wordlist wordlist(path);
+        loaded += wordlist.size();
+    }
+
+    std::remove(path.c_str());
+    state.setItemsProcessed(loaded);
+    state.setItemLabel("words");
+}
+
+static void benchGeneratePassphrase(crimson::bench::State& state) {
+    std::string path = writeSyntheticWordlist(7776);
+    Wordlist wordlist(path);
+    PasswordGenerator generator;
+    size_t generated = 0;
+
+    while (state.keepRunning()) {
+        auto passphrase = generator.generatePassphrase(wordlist, 6);
+        generated += passphrase.entropyBits > 0.0;
+    }
+
+    std::remove(path.c_str());
+    state.setItemsProcessed(generated);
+    state.setItemLabel("passphrases");
+}
+
+CRIMSON_BENCHMARK("Wordlist/load/100000", benchWordlistLoad);
+CRIMSON_BENCHMARK("PasswordGenerator/generatePassphrase/6", benchGeneratePassphrase);
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "AgentProtocol.h"
+#include "../core/VaultEntry.h"
+
+namespace crimson {
+namespace agent {
+
+/**
+ * @brief Pipelining client for the agent's binary protocol
+ *
+ * queue*() calls only append frames to a send buffer, so any number of
+ * requests go out in a few writes; receive() then returns responses as
+ * they arrive, matched by request ID. The get/put/list helpers do a
+ * single batched round trip each.
+ */
+class AgentClient {
+public:
+    struct EntryResult {
+        bool ok = false;
+        core::VaultEntry entry;   // Password in plain text when fetched
+        std::string error;
+    };
+    
+    struct PutItem {
+        std::string key;        // Label to add, or ID to update
+        std::string username;   // Empty keeps the current or generated one
+        std::string password;   // Empty keeps the current or generated one
+    };
+    
+    /**
+     * @brief Connect to an agent socket
+     * @throws std::runtime_error if no agent is listening there
+     */
+    explicit AgentClient(const std::string& socketPath);
+    ~AgentClient();
+    
+    // Non-copyable
+    AgentClient(const AgentClient&) = delete;
+    AgentClient& operator=(const AgentClient&) = delete;
+    
+    /**
+     * @brief Agent socket named by CRIMSON_AGENT_SOCK, or empty if unset
+     */
+    static std::string socketFromEnvironment();
+    
+    /**
+     * @brief Queue one request frame
+     * @return Request ID its responses will carry
+     */
+    uint32_t queueGet(const std::vector<std::string>& keys);
+    uint32_t queuePut(const std::vector<PutItem>& items);
+    uint32_t queueList(const std::string& search, uint32_t limit, uint8_t order, bool descending);
+    uint32_t queueGenerate(uint32_t count, uint32_t length, bool symbols);
+    
+    /**
+     * @brief Send every queued frame
+     *
+     * Replies are read into a buffer while sending, so a long pipeline
+     * cannot deadlock against the agent's own output.
+     *
+     * @throws std::runtime_error if the connection fails
+     */
+    void flush();
+    
+    /**
+     * @brief Next response frame, whichever request it answers
+     * @throws std::runtime_error if the connection fails
+     */
+    AgentProtocol::Frame receive();
+    
+    /**
+     * @brief Fetch entries with passwords in one round trip
+     * @throws std::runtime_error if the vault is locked or the request fails
+     */
+    std::vector<EntryResult> get(const std::vector<std::string>& keys);
+    
+    /**
+     * @brief Add or update entries in one round trip and one vault save
+     * @throws std::runtime_error if the vault is locked or cannot be saved
+     */
+    std::vector<EntryResult> put(const std::vector<PutItem>& items);
+    
+    /**
+     * @brief Collect a streamed list (entries without passwords)
+     * @param order A SecureVault::EntryOrder value
+     * @throws std::runtime_error if the vault is locked or the request fails
+     */
+    std::vector<core::VaultEntry> list(const std::string& search, uint32_t limit, uint8_t order, bool descending);
+    
+    /**
+     * @brief Decode a Get or Put response
+     * @throws std::runtime_error if the response reports an error
+     */
+    static std::vector<EntryResult> readEntryResults(const AgentProtocol::Frame& frame);
+    
+    /**
+     * @brief Decode one List frame, appending its entries
+     * @return true if more frames follow for this request
+     * @throws std::runtime_error if the response reports an error
+     */
+    static bool readListChunk(const AgentProtocol::Frame& frame, std::vector<core::VaultEntry>& entries);
+
+private:
+    int fd_;
+    uint32_t next_request_;
+    std::string output_;
+    std::string input_;
+    std::deque<AgentProtocol::Frame> pending_;   // Received while waiting for another request
+    
+    uint32_t beginRequest(AgentProtocol::Opcode opcode, size_t& frameStart);
+    
+    /**
+     * @brief Next frame from the socket, after sending anything queued
+     */
+    AgentProtocol::Frame readFrame();
+    
+    /**
+     * @brief Next response for one request, holding back others
+     */
+    AgentProtocol::Frame waitFor(uint32_t request);
+    
+    /**
+     * @brief Read whatever the socket has into input_
+     * @param wait Block until at least one byte arrives
+     */
+    void fill(bool wait);
+};
+
+} // namespace agent
+} // namespace crimson
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../core/VaultEntry.h"
+
+namespace crimson {
+namespace agent {
+
+/**
+ * @brief Length-prefixed binary framing for pipelined agent requests
+ *
+ * A binary connection opens with the four MAGIC bytes (JSON-lines
+ * clients never start with a NUL), then carries frames of:
+ *
+ *   uint32 length    bytes after this field
+ *   uint8  opcode    a request Opcode, or'ed with RESPONSE_FLAG in replies
+ *   uint32 request   caller-chosen ID, echoed by every response frame
+ *   payload
+ *
+ * Integers are little-endian; strings are a uint32 length and the bytes;
+ * entries use the EntryCodec binary layout. Every response payload
+ * starts with a Status byte; Error and Locked carry a message string.
+ *
+ * Request and Ok-response payloads:
+ *   Get       u32 n, n x key (ID or label)  ->  u32 n, n x (status, entry | message)
+ *   Put       u32 n, n x (key, username, password)  ->  as Get
+ *             (a label adds an entry, an ID updates one; an empty username
+ *             or password keeps the current or generated value)
+ *   List      search, u32 limit (0 = all), u8 order, u8 descending
+ *             ->  u32 n, n x entry without password, in frames of Status
+ *             More until a final Ok frame
+ *   Generate  u32 count, u32 length, u8 symbols  ->  u32 n, n x password
+ *   Status    (empty)  ->  u8 open, u32 entries
+ *   Lock      (empty)  ->  (empty)
+ *   Unlock    password  ->  (empty)
+ *
+ * Requests are answered in arrival order, except that a List stream is
+ * sent as the client drains it while later requests are answered in
+ * between; clients match responses by request ID.
+ */
+class AgentProtocol {
+public:
+    static constexpr char MAGIC[4] = {'\0', 'C', 'R', 'B'};
+    static constexpr size_t HEADER_BYTES = 9;               // length + opcode + request
+    static constexpr uint32_t MAX_FRAME_BYTES = 16 << 20;   // Larger frames close the connection
+    static constexpr size_t LIST_CHUNK_ENTRIES = 256;       // Entries per streamed List frame
+    static constexpr uint8_t RESPONSE_FLAG = 0x80;
+    
+    enum class Opcode : uint8_t {
+        Get = 1,
+        Put = 2,
+        List = 3,
+        Generate = 4,
+        Status = 5,
+        Lock = 6,
+        Unlock = 7
+    };
+    
+    enum class Status : uint8_t {
+        Ok = 0,
+        Error = 1,
+        Locked = 2,
+        More = 3     // List frame with more to follow
+    };
+    
+    struct Frame {
+        uint8_t opcode = 0;
+        uint32_t request = 0;
+        std::string payload;
+    };
+    
+    /**
+     * @brief Bounds-checked cursor over a frame payload
+     *
+     * Every read throws std::runtime_error if the payload is too short.
+     */
+    class Reader {
+    public:
+        explicit Reader(std::string_view data) : data_(data), position_(0) {}
+        
+        uint8_t u8();
+        uint32_t u32();
+        std::string string();
+        void entry(core::VaultEntry& entry);
+        bool atEnd() const { return position_ == data_.size(); }
+
+    private:
+        std::string_view data_;
+        size_t position_;
+        
+        const char* take(size_t count);
+    };
+    
+    /**
+     * @brief Start a frame; finish it with endFrame() once the payload is appended
+     * @return Offset of the frame in out
+     */
+    static size_t beginFrame(uint8_t opcode, uint32_t request, std::string& out);
+    
+    /**
+     * @brief Fill in the length of the frame started at offset
+     * @throws std::length_error if the frame exceeds MAX_FRAME_BYTES
+     */
+    static void endFrame(size_t offset, std::string& out);
+    
+    /**
+     * @brief Decode one frame from the front of a buffer
+     * @return Bytes consumed, or 0 if the frame is not complete yet
+     * @throws std::runtime_error if the frame is malformed or too large
+     */
+    static size_t readFrame(std::string_view data, Frame& frame);
+    
+    static void appendU8(uint8_t value, std::string& out);
+    static void appendU32(uint32_t value, std::string& out);
+    static void appendString(std::string_view text, std::string& out);
+    
+    /**
+     * @brief Overwrite a uint32 appended earlier (e.g. a count placeholder)
+     */
+    static void patchU32(size_t offset, uint32_t value, std::string& out);
+};
+
+} // namespace agent
+} // namespace crimson
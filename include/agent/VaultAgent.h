@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include <memory>
+#include "AgentProtocol.h"
+#include "../core/EntryId.h"
+
+namespace crimson {
+namespace core {
+class SecureVault;
+class PasswordGenerator;
+}
+}
+
+namespace crimson {
+namespace agent {
+
+/**
+ * @brief Serves an unlocked vault to local processes, like ssh-agent
+ *
+ * Listens on a Unix domain socket that only the owner can reach: the
+ * socket is created 0600 and every connection's peer user ID must match
+ * ours. A connection that opens with AgentProtocol::MAGIC speaks the
+ * pipelined binary protocol; otherwise requests and responses are one
+ * JSON object per line:
+ *
+ *   {"id": 1, "op": "get", "entry": "<id or label>"}
+ *   {"id": 1, "ok": true, "entry": {..., "password": "..."}}
+ *
+ * Operations: get, list (search, limit), generate (length, count,
+ * symbols), status, lock, unlock (password) and metrics (format:
+ * "json", the default, or "prometheus"). Failures answer
+ * {"ok": false, "error": "..."}; while locked, vault operations answer
+ * with the error "locked".
+ *
+ * The vault is closed once shouldAutoLock() reports the timeout has
+ * passed since the last request. Everything runs on the calling thread.
+ */
+class VaultAgent {
+public:
+    /**
+     * @param vault Vault to serve, normally already open
+     * @param vaultPath File the vault was opened from, for "unlock"
+     * @param socketPath Where to listen (see defaultSocketPath())
+     */
+    VaultAgent(core::SecureVault& vault, const std::string& vaultPath, const std::string& socketPath);
+    ~VaultAgent();
+    
+    // Non-copyable
+    VaultAgent(const VaultAgent&) = delete;
+    VaultAgent& operator=(const VaultAgent&) = delete;
+    
+    /**
+     * @brief Serve requests until stop() is called
+     * @throws std::runtime_error if the socket cannot be created, or
+     *         another agent already listens on it
+     */
+    void run();
+    
+    /**
+     * @brief Make run() return; safe to call from a signal handler
+     */
+    void stop();
+    
+    /**
+     * @brief $XDG_RUNTIME_DIR/crimson-agent.sock, or a socket in a private
+     *        per-user directory under /tmp
+     */
+    static std::string defaultSocketPath();
+
+private:
+    /**
+     * @brief Binary List response still being sent, a chunk at a time
+     */
+    struct ListStream {
+        uint32_t request;
+        std::vector<core::EntryId> ids;
+        size_t next;
+    };
+    
+    struct Client {
+        enum class Mode { Unknown, Json, Binary };
+        
+        explicit Client(int descriptor) : fd(descriptor) {}
+        
+        int fd;
+        Mode mode = Mode::Unknown;   // Decided by the first byte received
+        std::string input;
+        std::string output;
+        std::deque<ListStream> streams;
+    };
+    
+    core::SecureVault& vault_;
+    std::string vault_path_;
+    std::string socket_path_;
+    int listen_fd_;
+    int wake_fds_[2];   // Self-pipe written by stop()
+    std::vector<Client> clients_;
+    std::unique_ptr<core::PasswordGenerator> password_generator_;
+    
+    void openSocket();
+    void closeSocket();
+    void acceptClients();
+    
+    /**
+     * @brief Read and answer whatever a client has sent
+     * @return false once the client has gone away or misbehaved
+     */
+    bool readClient(Client& client);
+    bool writeClient(Client& client);
+    
+    /**
+     * @brief Answer every complete request in the client's input
+     * @return false if the input breaks the protocol
+     */
+    bool processInput(Client& client);
+    
+    /**
+     * @brief Answer one request line, appending the response line to out
+     */
+    void handleRequest(const std::string& line, std::string& out);
+    
+    /**
+     * @brief Answer one binary frame (List only queues a stream)
+     */
+    void handleFrame(const AgentProtocol::Frame& frame, Client& client);
+    
+    /**
+     * @brief Append List chunks until the output buffer is comfortably full
+     */
+    void pumpStreams(Client& client);
+    
+    bool peerAllowed(int fd) const;
+};
+
+} // namespace agent
+} // namespace crimson
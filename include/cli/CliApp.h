@@ -0,0 +1,94 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace crimson {
+namespace core {
+class SecureVault;
+}
+}
+
+namespace crimson {
+namespace cli {
+
+/**
+ * @brief Headless command-line frontend to the vault
+ *
+ * Every command writes one JSON value to stdout and returns a process
+ * exit code; errors go to stderr as {"error": "..."}. Only QtCore is
+ * used, so start-up costs nothing beyond opening the vault.
+ *
+ * The master password comes from CRIMSON_MASTER_PASSWORD if set,
+ * otherwise from the first line of stdin (read without echo on a
+ * terminal). The vault path comes from --vault, then CRIMSON_VAULT,
+ * then "vault.gpg".
+ */
+class CliApp {
+public:
+    enum ExitCode {
+        Success = 0,
+        Failure = 1,   // Vault or entry error
+        Usage = 2      // Bad command line
+    };
+    
+    CliApp();
+    ~CliApp();
+    
+    /**
+     * @brief Run one command
+     * @param args Command line without the program name
+     * @return Process exit code
+     */
+    int run(const std::vector<std::string>& args);
+
+private:
+    std::string vault_path_;
+    std::vector<std::string> args_;   // Command arguments after global options
+    
+    /**
+     * @brief Run the named command on args_
+     */
+    int dispatch(const std::string& command);
+    
+    int list();
+    int get();
+    int put();
+    int remove();
+    int importEntries();
+    int exportEntries();
+    int generate();
+    int agent();
+    int usage(const std::string& message = std::string()) const;
+    
+    /**
+     * @brief Open the vault with the master password
+     * @throws std::runtime_error if it cannot be opened
+     */
+    void openVault(core::SecureVault& vault) const;
+    
+    /**
+     * @brief Value of "--name value" in the command arguments (empty if absent)
+     */
+    std::string option(const std::string& name) const;
+    
+    /**
+     * @brief Whether a bare "--name" flag is in the command arguments
+     */
+    bool flag(const std::string& name) const;
+    
+    /**
+     * @brief Command arguments that are neither options nor their values
+     */
+    std::vector<std::string> positional() const;
+    
+    /**
+     * @brief Read one line of stdin, without echo if it is a terminal
+     */
+    static std::string readSecretLine(const char* prompt);
+    
+    static void writeError(const std::string& message);
+};
+
+} // namespace cli
+} // namespace crimson
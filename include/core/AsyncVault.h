@@ -0,0 +1,158 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <QtCore/QObject>
+#include "Executor.h"
+#include "SecureVault.h"
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Future-returning front end to a SecureVault
+ *
+ * Operations that change the vault (create, open, close, save, delete)
+ * run one at a time on the vault's strand, in the order they were called.
+ * Reads go straight to the shared executor and run alongside any change
+ * in progress, including a save that is still writing the file. They see
+ * the vault as of its last completed change, so a read that must observe
+ * a change belongs in that change's continuation.
+ *
+ * Every operation has two forms. One returns a std::future. The other
+ * hands the ready future to done() on the GUI thread; get() on it returns
+ * the result or throws what the operation threw. done() is skipped if
+ * context has been deleted by then.
+ *
+ * Cheap calls (isOpen, shouldAutoLock, views) stay synchronous through
+ * vault().
+ */
+class AsyncVault {
+public:
+    template <typename T>
+    using Done = std::function<void(std::future<T>)>;
+    
+    /**
+     * @param vault Vault to front; must outlive this object
+     */
+    explicit AsyncVault(SecureVault& vault, Executor& executor = Executor::shared());
+    
+    /**
+     * @brief Waits for every operation already started
+     */
+    ~AsyncVault();
+    
+    // Non-copyable
+    AsyncVault(const AsyncVault&) = delete;
+    AsyncVault& operator=(const AsyncVault&) = delete;
+    
+    SecureVault& vault() const { return vault_; }
+    
+    /**
+     * @brief Operations started and not yet finished
+     */
+    size_t pending() const;
+    
+    /**
+     * @brief Block until every operation started so far has finished
+     */
+    void wait() const;
+    
+    // Changes, run in call order. The master password is copied and wiped
+    // once used
+    
+    std::future<bool> createVault(const std::string& masterPassword, const std::string& vaultPath);
+    void createVault(const std::string& masterPassword, const std::string& vaultPath,
+                     QObject* context, Done<bool> done);
+    
+    std::future<bool> openVault(const std::string& masterPassword, const std::string& vaultPath);
+    void openVault(const std::string& masterPassword, const std::string& vaultPath,
+                   QObject* context, Done<bool> done);
+    
+    std::future<void> closeVault();
+    void closeVault(QObject* context, Done<void> done);
+    
+    std::future<bool> saveEntry(const VaultEntry& entry);
+    void saveEntry(const VaultEntry& entry, QObject* context, Done<bool> done);
+    
+    std::future<bool> saveEntries(std::vector<VaultEntry> entries);
+    void saveEntries(std::vector<VaultEntry> entries, QObject* context, Done<bool> done);
+    
+    std::future<bool> deleteEntry(const EntryId& entryId);
+    void deleteEntry(const EntryId& entryId, QObject* context, Done<bool> done);
+    
+    // Reads, run concurrently
+    
+    std::future<VaultEntry> createEntry(const std::string& label);
+    void createEntry(const std::string& label, QObject* context, Done<VaultEntry> done);
+    
+    std::future<VaultEntry> getEntry(const EntryId& entryId);
+    void getEntry(const EntryId& entryId, QObject* context, Done<VaultEntry> done);
+    
+    std::future<std::string> getPassword(const EntryId& entryId);
+    void getPassword(const EntryId& entryId, QObject* context, Done<std::string> done);
+    
+    using Labels = std::vector<std::pair<EntryId, std::string>>;
+    
+    std::future<Labels> search(const std::string& query, size_t limit = 200);
+    void search(const std::string& query, size_t limit, QObject* context, Done<Labels> done);
+    
+    std::future<SecureVault::EntryPage> listEntries(SecureVault::EntryOrder order, const std::string& cursor = std::string(),
+                                                    size_t pageSize = 50, bool descending = false);
+    void listEntries(SecureVault::EntryOrder order, const std::string& cursor, size_t pageSize, bool descending,
+                     QObject* context, Done<SecureVault::EntryPage> done);
+    
+    std::future<SecureVault::VaultStats> getStats();
+    void getStats(QObject* context, Done<SecureVault::VaultStats> done);
+    
+    std::future<bool> verifyIntegrity();
+    void verifyIntegrity(QObject* context, Done<bool> done);
+    
+    // Bulk work, behind everything interactive
+    
+    std::future<std::vector<EntryId>> findBreachedEntries();
+    void findBreachedEntries(QObject* context, Done<std::vector<EntryId>> done);
+    
+    /**
+     * @brief Audit the vault; callback runs on pool threads, as in SecureVault::auditVault
+     */
+    std::future<SecureVault::AuditSummary> auditVault(SecureVault::AuditOptions options,
+                                                      SecureVault::AuditCallback callback);
+    void auditVault(SecureVault::AuditOptions options, SecureVault::AuditCallback callback,
+                    QObject* context, Done<SecureVault::AuditSummary> done);
+
+private:
+    struct InFlight {
+        std::mutex mutex;
+        std::condition_variable drained;
+        size_t count = 0;
+    };
+    
+    SecureVault& vault_;
+    Executor& executor_;
+    std::shared_ptr<InFlight> in_flight_;
+    Strand changes_;
+    
+    /**
+     * @brief Run an operation on the strand, or on the executor at a priority
+     * @return The result's future, or an invalid one if done receives it
+     */
+    template <typename T, typename F>
+    std::future<T> start(bool serial, Executor::Priority priority, F operation,
+                         QObject* context, Done<T> done);
+    
+    template <typename F>
+    auto change(F operation, QObject* context = nullptr, Done<std::invoke_result_t<F&>> done = {});
+    
+    template <typename F>
+    auto read(F operation, QObject* context = nullptr, Done<std::invoke_result_t<F&>> done = {},
+              Executor::Priority priority = Executor::Priority::Interactive);
+};
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "MappedFile.h"
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Offline breached-password corpus (HIBP-style sorted hash file)
+ * 
+ * The corpus is a flat binary file of fixed-size records sorted in
+ * ascending byte order. Each record is a SHA-1 or NTLM hash, or a prefix
+ * of one (e.g. the first 8 bytes to halve the file size). The file is
+ * memory-mapped and probed with interpolation search, which needs only a
+ * handful of page touches because hashes are uniformly distributed. An
+ * optional in-memory Bloom filter answers most negative lookups without
+ * touching the mapping at all. No network access is ever made.
+ */
+class BreachCorpus {
+public:
+    enum class HashType {
+        Sha1,   // SHA-1 of the UTF-8 password (20 bytes)
+        Ntlm    // MD4 of the UTF-16LE password (16 bytes)
+    };
+    
+    /**
+     * @brief Map a corpus file
+     * @param path Sorted binary corpus
+     * @param type Hash algorithm the corpus was built with
+     * @param recordSize Bytes per record (0 = full hash length)
+     * @throws std::runtime_error if the file size is not a whole number of records
+     */
+    BreachCorpus(const std::string& path, HashType type, size_t recordSize = 0);
+    
+    // Non-copyable
+    BreachCorpus(const BreachCorpus&) = delete;
+    BreachCorpus& operator=(const BreachCorpus&) = delete;
+    
+    /**
+     * @brief Check whether a plaintext password appears in the corpus
+     */
+    bool contains(const std::string& password) const;
+    
+    /**
+     * @brief Check a plaintext password held in a buffer, without copying it
+     */
+    bool contains(const char* password, size_t length) const;
+    
+    /**
+     * @brief Check a precomputed hash (at least recordSize() bytes)
+     */
+    bool containsHash(const uint8_t* hash) const;
+    
+    /**
+     * @brief Build the Bloom filter front by scanning the whole corpus
+     * @param bitsPerEntry Filter size per record (10 bits gives ~1% false positives)
+     */
+    void buildBloomFilter(size_t bitsPerEntry = 10);
+    
+    bool hasBloomFilter() const { return !bloom_.empty(); }
+    
+    size_t recordCount() const { return record_count_; }
+    size_t recordSize() const { return record_size_; }
+    HashType hashType() const { return hash_type_; }
+    
+    /**
+     * @brief Full-length hash of a password for the given algorithm
+     */
+    static std::vector<uint8_t> hashPassword(const std::string& password, HashType type);
+    static std::vector<uint8_t> hashPassword(const char* password, size_t length, HashType type);
+    
+    /**
+     * @brief Full hash length in bytes for an algorithm
+     */
+    static size_t hashLength(HashType type);
+
+private:
+    MappedFile file_;
+    HashType hash_type_;
+    size_t record_size_;
+    size_t record_count_;
+    
+    std::vector<uint64_t> bloom_;
+    uint64_t bloom_bits_;
+    unsigned bloom_hashes_;
+    
+    const uint8_t* record(size_t index) const { return file_.data() + index * record_size_; }
+    
+    void bloomSeeds(const uint8_t* hash, uint64_t& h1, uint64_t& h2) const;
+    bool bloomMayContain(const uint8_t* hash) const;
+    void bloomInsert(const uint8_t* hash);
+    
+    /**
+     * @brief First eight bytes of a record as a big-endian integer
+     */
+    uint64_t leadingKey(const uint8_t* bytes) const;
+};
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include "Executor.h"
+#include "SecureMemory.h"
+
+namespace crimson {
+namespace core {
+
+class PasswordGenerator;
+
+/**
+ * @brief Small stock of pre-generated username/password pairs
+ * 
+ * Whenever it runs low while a vault is open, a bulk task on the shared
+ * executor tops the pool up, so that entry creation does not pay for PRNG
+ * seeding and generation on the GUI thread. Credentials live in locked memory and are wiped on stop().
+ */
+class CredentialPool {
+public:
+    /**
+     * @brief Construct an idle pool
+     * @param capacity Number of credential pairs kept ready
+     * @param passwordLength Length of every pooled password
+     */
+    explicit CredentialPool(size_t capacity = 4, size_t passwordLength = 64);
+    ~CredentialPool();
+    
+    // Non-copyable
+    CredentialPool(const CredentialPool&) = delete;
+    CredentialPool& operator=(const CredentialPool&) = delete;
+    
+    /**
+     * @brief Allocate the pool and start background refilling
+     */
+    void start();
+    
+    /**
+     * @brief Stop refilling and wipe every pooled credential
+     */
+    void stop();
+    
+    /**
+     * @brief Take one pre-generated pair out of the pool
+     * @param username Receives the username
+     * @param password Receives the password
+     * @return false if the pool is currently empty
+     */
+    bool take(std::string& username, std::string& password);
+    
+    /**
+     * @brief Number of pairs ready to be taken
+     */
+    size_t available() const;
+    
+    size_t passwordLength() const { return password_length_; }
+
+private:
+    static constexpr size_t USERNAME_SLOT_SIZE = 32;
+    
+    const size_t capacity_;
+    const size_t password_length_;
+    const size_t slot_size_;
+    
+    std::unique_ptr<SecureMemory::SecureBuffer> slots_;
+    size_t count_;
+    bool stopping_;
+    bool refilling_;   // A refill task is queued or running
+    
+    mutable std::mutex mutex_;
+    std::unique_ptr<PasswordGenerator> generator_;   // Only touched by the refill task
+    TaskGroup refill_;
+    
+    /**
+     * @brief Queue a refill task unless one is pending or the pool is full
+     * 
+     * Called with mutex_ held.
+     */
+    void scheduleRefill();
+    
+    /**
+     * @brief Generate credentials until the pool is full or stopped
+     */
+    void refill();
+    
+    char* slot(size_t index) const { return slots_->as<char>() + index * slot_size_; }
+};
+
+} // namespace core
+} // namespace crimson
@@ -55,6 +55,19 @@ public:
         const std::vector<uint8_t>& ciphertext,
         const SecureMemory::SecureBuffer& key);
     
+    /**
+     * @brief Decrypt data straight into locked memory
+     * @param ciphertext Encrypted data
+     * @param key Decryption key
+     * @param out Secure buffer receiving the plaintext
+     * @return Plaintext length in bytes
+     * @throws std::length_error if out is too small
+     */
+    size_t decrypt(
+        const std::vector<uint8_t>& ciphertext,
+        const SecureMemory::SecureBuffer& key,
+        SecureMemory::SecureBuffer& out) const;
+    
     /**
      * @brief Generate cryptographically secure salt
      * @param size Salt size in bytes (default: 32)
@@ -84,6 +97,35 @@ public:
         const std::string& masterPassword,
         const std::string& salt);
     
+    /**
+     * @brief Verify the master password and derive the key, concurrently
+     * 
+     * The check and the derivation are separate Argon2id runs over the
+     * same input; the derivation runs on the shared executor while the
+     * check runs on the calling thread, so unlocking costs one run of
+     * wall time instead of two.
+     * @param masterPassword Password to verify
+     * @param storedHash Stored password hash
+     * @param salt Salt used for both
+     * @return Derived key, or nullptr if the password is wrong
+     */
+    std::unique_ptr<SecureMemory::SecureBuffer> unlock(
+        const std::string& masterPassword,
+        const std::string& storedHash,
+        const std::string& salt);
+    
+    /**
+     * @brief Derive the key and the stored hash for a new master password, concurrently
+     * @param masterPassword Master password
+     * @param salt Salt for both
+     * @param hash Receives the Base64-encoded hash
+     * @return Derived key in secure memory
+     */
+    std::unique_ptr<SecureMemory::SecureBuffer> deriveKeyAndHash(
+        const std::string& masterPassword,
+        const std::string& salt,
+        std::string& hash);
+    
     /**
      * @brief Calculate SHA256 hash
      * @param data Data to hash
@@ -104,6 +146,16 @@ public:
 private:
     class Impl;
     std::unique_ptr<Impl> impl_;
+    
+    /**
+     * @brief The one decryption both decrypt() overloads forward to
+     * @param out Receives the plaintext; must hold outSize bytes
+     * @throws std::length_error if outSize is smaller than the plaintext
+     */
+    void decryptInto(
+        const std::vector<uint8_t>& ciphertext,
+        const SecureMemory::SecureBuffer& key,
+        uint8_t* out, size_t outSize) const;
 };
 
 } // namespace core
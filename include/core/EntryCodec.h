@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include "VaultEntry.h"
+
+class QJsonObject;
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief One serialized member of VaultEntry
+ */
+template <typename T>
+struct FieldDescriptor {
+    const char* name;          // JSON key
+    T VaultEntry::*member;
+    bool optional;             // Left out of JSON when empty / null
+};
+
+/**
+ * @brief Direct JSON and binary codecs for VaultEntry
+ *
+ * Both codecs are generated from the field list in fields(), so a new
+ * VaultEntry member needs one new descriptor and nothing else. JSON is
+ * written straight into a text buffer and read straight from an already
+ * parsed QJsonObject; no per-entry QJsonDocument is built either way.
+ *
+ * Binary layout, field by field in fields() order:
+ * - text: uint32 little-endian length, then the bytes
+ * - EntryId: 16 raw bytes
+ * - Timestamp: int64 little-endian epoch seconds
+ */
+class EntryCodec {
+public:
+    static constexpr auto fields() {
+        return std::make_tuple(
+            FieldDescriptor<EntryId>{"id", &VaultEntry::id, false},
+            FieldDescriptor<std::string>{"label", &VaultEntry::label, false},
+            FieldDescriptor<std::string>{"username", &VaultEntry::username, false},
+            FieldDescriptor<std::string>{"password", &VaultEntry::password, false},
+            FieldDescriptor<Timestamp>{"created_at", &VaultEntry::created_at, false},
+            FieldDescriptor<Timestamp>{"last_used_at", &VaultEntry::last_used_at, true},
+            FieldDescriptor<std::string>{"device_fingerprint", &VaultEntry::device_fingerprint, false});
+    }
+    
+    /**
+     * @brief Append an entry as a compact JSON object
+     */
+    static void appendJson(const VaultEntry& entry, std::string& out);
+    
+    /**
+     * @brief Decode an entry from a parsed JSON object
+     * 
+     * An id that is missing or not a UUID is replaced by a generated one,
+     * with a warning, rather than failing the whole vault.
+     */
+    static VaultEntry fromJson(const QJsonObject& object);
+    
+    /**
+     * @brief Append an entry in the binary layout
+     * @throws std::length_error if a text field exceeds 4 GiB
+     */
+    static void appendBinary(const VaultEntry& entry, std::string& out);
+    
+    /**
+     * @brief Decode one entry from the front of a binary buffer
+     * @return Number of bytes consumed
+     * @throws std::runtime_error if the buffer is truncated
+     */
+    static size_t readBinary(std::string_view data, VaultEntry& entry);
+    
+    /**
+     * @brief Set the field with a given JSON key from its (unescaped) text
+     * @return false if no field has that key
+     * 
+     * Id text that is not a UUID is replaced as in fromJson().
+     */
+    static bool assignField(std::string_view name, std::string_view text, VaultEntry& entry);
+    
+    /**
+     * @brief Reset every field, keeping string capacity for reuse
+     */
+    static void clear(VaultEntry& entry);
+    
+    /**
+     * @brief Append the user-facing fields of an entry as a JSON object
+     * 
+     * Shape used by the CLI and the agent: id, label, username, the
+     * password only if given, created_at and last_used_at if set.
+     */
+    static void appendSummaryJson(const EntryView& view, const std::string* password, std::string& out);
+    
+    /**
+     * @brief Append text as a quoted, escaped JSON string
+     */
+    static void appendJsonString(std::string_view text, std::string& out);
+};
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief 128-bit entry identifier (the raw bytes of a UUID)
+ *
+ * Sixteen bytes, trivially copyable and cheap to hash and compare. The
+ * canonical UUID text form is only produced at the serialization and UI
+ * edges via toString(). A default-constructed id is the null (all-zero)
+ * UUID, which is never generated.
+ */
+class EntryId {
+public:
+    using Bytes = std::array<uint8_t, 16>;
+    
+    constexpr EntryId() : bytes_{} {}
+    explicit constexpr EntryId(const Bytes& bytes) : bytes_(bytes) {}
+    
+    /**
+     * @brief Generate a new random (version 4) id
+     */
+    static EntryId generate();
+    
+    /**
+     * @brief Parse a UUID in canonical or braced form
+     * @return false if the text is not a UUID
+     */
+    static bool parse(std::string_view text, EntryId& id);
+    
+    /**
+     * @brief Parse a UUID in canonical or braced form
+     * @throws std::invalid_argument if the text is not a UUID
+     */
+    static EntryId fromString(std::string_view text);
+    
+    /**
+     * @brief Canonical lowercase UUID text
+     */
+    std::string toString() const;
+    
+    bool isNull() const { return *this == EntryId(); }
+    const Bytes& bytes() const { return bytes_; }
+    
+    /**
+     * @brief Hash of the id (UUIDs are random, so the halves are just folded)
+     */
+    size_t hash() const;
+    
+    friend bool operator==(const EntryId& a, const EntryId& b) { return a.bytes_ == b.bytes_; }
+    friend bool operator!=(const EntryId& a, const EntryId& b) { return a.bytes_ != b.bytes_; }
+    friend bool operator<(const EntryId& a, const EntryId& b) { return a.bytes_ < b.bytes_; }
+
+private:
+    Bytes bytes_;
+};
+
+} // namespace core
+} // namespace crimson
+
+namespace std {
+template <>
+struct hash<crimson::core::EntryId> {
+    size_t operator()(const crimson::core::EntryId& id) const { return id.hash(); }
+};
+}
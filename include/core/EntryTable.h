@@ -0,0 +1,151 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "VaultEntry.h"
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Column-oriented in-memory storage for vault entries
+ *
+ * Each field lives in its own array instead of six heap strings per entry:
+ * - ids as 16-byte EntryIds
+ * - created/last-used times as epoch-second Timestamps
+ * - device fingerprints interned, stored per row as a small index
+ * - label, username and password ciphertext back to back in one text
+ *   arena, addressed by offset and lengths
+ *
+ * Scans over one column touch only that column's memory. VaultEntry is
+ * built only when a caller asks for a whole entry (materialize()).
+ *
+ * Updates and erasures leave their old text in the arena as garbage, which
+ * is reclaimed by compact() once it outweighs the live text.
+ */
+class EntryTable {
+public:
+    EntryTable();
+    ~EntryTable();
+    
+    /**
+     * @brief Copy every row, leaving the arena's garbage behind
+     * 
+     * Explicit so that the one copy a vault change makes is never
+     * accidental.
+     */
+    explicit EntryTable(const EntryTable& other);
+    EntryTable& operator=(const EntryTable&) = delete;
+    
+    size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+    
+    void reserve(size_t rows, size_t textBytes = 0);
+    
+    /**
+     * @brief Drop every row, wiping the text arena
+     */
+    void clear();
+    
+    /**
+     * @brief Append an entry (password must already be ciphertext)
+     * @return Row index
+     * @throws std::invalid_argument if a field is too long
+     */
+    size_t append(const VaultEntry& entry);
+    
+    /**
+     * @brief Append every row of another table, in its order
+     * 
+     * Used to merge tables decoded in parallel; the source is unchanged.
+     * @throws std::length_error if the text arena would overflow
+     */
+    void appendRows(const EntryTable& other);
+    
+    /**
+     * @brief Replace the entry stored at a row
+     * @throws std::invalid_argument as for append()
+     */
+    void assign(size_t row, const VaultEntry& entry);
+    
+    /**
+     * @brief Remove a row, keeping the order of the rest
+     */
+    void erase(size_t row);
+    
+    // Column accessors
+    const EntryId& id(size_t row) const { return ids_[row]; }
+    std::string_view label(size_t row) const;
+    std::string_view username(size_t row) const;
+    std::string_view password(size_t row) const;   // Base64 ciphertext
+    Timestamp createdAt(size_t row) const { return created_at_[row]; }
+    Timestamp lastUsedAt(size_t row) const { return last_used_at_[row]; }
+    std::string_view deviceFingerprint(size_t row) const;
+    
+    void setLastUsedAt(size_t row, Timestamp time) { last_used_at_[row] = time; }
+    
+    /**
+     * @brief Metadata view of a row (valid until the table is modified)
+     */
+    EntryView view(size_t row) const;
+    
+    /**
+     * @brief Build a full VaultEntry for a row (password stays ciphertext)
+     */
+    VaultEntry materialize(size_t row) const;
+    
+    /**
+     * @brief Overwrite an existing VaultEntry with a row, reusing its buffers
+     */
+    void materialize(size_t row, VaultEntry& entry) const;
+    
+    /**
+     * @brief Bytes of arena text no longer referenced by any row
+     */
+    size_t garbageBytes() const { return garbage_bytes_; }
+    
+    /**
+     * @brief Total bytes held by the table's columns and arena
+     */
+    size_t memoryUsage() const;
+    
+    /**
+     * @brief Rewrite the arena without garbage
+     */
+    void compact();
+
+private:
+    struct TextSpan {
+        uint32_t offset;
+        uint16_t label_length;
+        uint16_t username_length;
+        uint16_t password_length;
+    };
+    
+    std::vector<EntryId> ids_;
+    std::vector<Timestamp> created_at_;
+    std::vector<Timestamp> last_used_at_;
+    std::vector<uint32_t> fingerprint_index_;
+    std::vector<TextSpan> text_spans_;
+    
+    std::string text_;
+    size_t garbage_bytes_;
+    
+    std::vector<std::string> fingerprints_;
+    std::unordered_map<std::string, uint32_t> fingerprint_lookup_;
+    
+    TextSpan appendText(const VaultEntry& entry);
+    void appendRaw(std::string_view text);
+    uint32_t internFingerprint(const std::string& fingerprint);
+    void maybeCompact();
+    
+    static size_t spanLength(const TextSpan& span) {
+        return static_cast<size_t>(span.label_length) + span.username_length + span.password_length;
+    }
+};
+
+} // namespace core
+} // namespace crimson
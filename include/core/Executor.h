@@ -0,0 +1,325 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <QtCore/QObject>
+#include <QtCore/QPointer>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Thrown by work that stopped because its token was cancelled
+ */
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled() : std::runtime_error("Operation cancelled") {}
+};
+
+/**
+ * @brief Cooperative cancellation flag shared by a task and its owner
+ *
+ * Copies share one flag. A default-constructed token can never be
+ * cancelled and costs nothing to check.
+ */
+class CancellationToken {
+public:
+    CancellationToken() = default;
+    
+    /**
+     * @brief A token that cancel() can trip
+     */
+    static CancellationToken create();
+    
+    void cancel() const;
+    bool isCancelled() const { return cancelled_ && cancelled_->load(std::memory_order_relaxed); }
+    
+    /**
+     * @throws OperationCancelled if cancel() has been called
+     */
+    void throwIfCancelled() const;
+
+private:
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+/**
+ * @brief Work-stealing thread pool shared by all core background work
+ *
+ * Each worker keeps its own deque per priority lane; tasks posted from a
+ * worker go to the back of its deque and are popped from there (newest
+ * first, while their data is still in cache), tasks posted from other
+ * threads go to a shared queue, and an idle worker steals the oldest task
+ * of another. A worker always runs the most urgent task it can find, so
+ * an unlock is never queued behind an audit, but a task that has started
+ * runs to completion: long work should check a CancellationToken.
+ *
+ * Code that waits for pool work must not block a worker on it; use a
+ * TaskGroup, whose wait() runs the group's unstarted tasks itself.
+ */
+class Executor {
+public:
+    enum class Priority {
+        Interactive,   // The user is waiting: unlock, key derivation
+        Normal,        // Loading, saving, indexing
+        Bulk           // Audits, imports, refilling pools
+    };
+    
+    /**
+     * @param threads Worker threads (0 = std::thread::hardware_concurrency)
+     */
+    explicit Executor(unsigned threads = 0);
+    
+    /**
+     * @brief Run every task already posted, then stop the workers
+     */
+    ~Executor();
+    
+    // Non-copyable
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    
+    /**
+     * @brief The process-wide pool, created on first use
+     */
+    static Executor& shared();
+    
+    /**
+     * @brief Size of the shared pool (0 = hardware concurrency)
+     *
+     * Reads CRIMSON_THREADS when not set here.
+     * @throws std::logic_error if the shared pool already exists
+     */
+    static void setSharedThreadCount(unsigned threads);
+    
+    unsigned threadCount() const { return static_cast<unsigned>(threads_.size()); }
+    
+    /**
+     * @brief Queue a task; it must not throw
+     */
+    void post(std::function<void()> task, Priority priority = Priority::Normal);
+    
+    /**
+     * @brief Queue a task and get its result
+     *
+     * A task whose token is cancelled before it starts is skipped and its
+     * future throws OperationCancelled. Do not wait on the future from a
+     * pool worker.
+     */
+    template <typename F>
+    auto submit(F task, Priority priority = Priority::Normal, CancellationToken token = CancellationToken())
+        -> std::future<std::invoke_result_t<F&>>;
+    
+    /**
+     * @brief Queue a task and hand its result to done() on the GUI thread
+     *
+     * done receives the ready std::future (get() returns the value or
+     * throws what the task threw). It is dropped if context is deleted
+     * first. Without a QCoreApplication, done runs on the worker.
+     */
+    template <typename F, typename Done>
+    void submit(F task, QObject* context, Done done, Priority priority = Priority::Normal,
+                CancellationToken token = CancellationToken());
+    
+    /**
+     * @brief Run fn on the thread of the QCoreApplication, unless guard has gone null
+     * @param guarded false to run fn even without a context object
+     */
+    static void postToMainThread(QPointer<QObject> guard, bool guarded, std::function<void()> fn);
+
+private:
+    static constexpr size_t PRIORITY_LANES = 3;
+    
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> lanes[PRIORITY_LANES];
+    };
+    
+    std::vector<std::unique_ptr<Queue>> local_;   // One per worker
+    Queue injected_;                              // Posted from outside the pool
+    std::vector<std::thread> threads_;
+    
+    std::atomic<size_t> queued_;   // Tasks in any queue
+    std::atomic<size_t> idle_;     // Workers asleep or about to be
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    bool stopping_;
+    
+    void workerLoop(size_t index);
+    
+    /**
+     * @brief Most urgent task visible to a worker (its own, injected, then stolen)
+     */
+    bool take(size_t index, std::function<void()>& task);
+    
+    template <typename F, typename Result>
+    static void fulfil(F& task, std::promise<Result>& promise, const CancellationToken& token);
+};
+
+/**
+ * @brief Runs the tasks posted to it one at a time, in order, on an Executor
+ *
+ * Each task is a separate executor task, so a strand occupies at most one
+ * worker and more urgent work can run between its tasks. Tasks on
+ * different strands, and on the executor itself, run in parallel.
+ */
+class Strand {
+public:
+    explicit Strand(Executor::Priority priority = Executor::Priority::Normal,
+                    Executor& executor = Executor::shared());
+    
+    /**
+     * @brief Waits for every posted task
+     */
+    ~Strand();
+    
+    // Non-copyable
+    Strand(const Strand&) = delete;
+    Strand& operator=(const Strand&) = delete;
+    
+    /**
+     * @brief Queue a task to run after every task already posted; it must not throw
+     */
+    void post(std::function<void()> task);
+    
+    /**
+     * @brief Wait until every task posted so far has run
+     *
+     * Must not be called from one of this strand's tasks.
+     */
+    void wait();
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::deque<std::function<void()>> tasks;
+        bool running = false;   // A task is queued on the executor or running
+    };
+    
+    Executor& executor_;
+    Executor::Priority priority_;
+    std::shared_ptr<State> state_;
+    
+    /**
+     * @brief Run the oldest task, then queue the next one if any
+     */
+    static void runNext(const std::shared_ptr<State>& state, Executor& executor, Executor::Priority priority);
+};
+
+/**
+ * @brief Tasks run on an Executor that one caller waits for together
+ *
+ * wait() runs the group's unstarted tasks on the calling thread and then
+ * sleeps until the rest finish, so it is safe to call from a pool worker
+ * and nested groups cannot deadlock the pool.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(Executor::Priority priority = Executor::Priority::Normal,
+                       CancellationToken token = CancellationToken(),
+                       Executor& executor = Executor::shared());
+    
+    /**
+     * @brief Waits for every task, discarding any error
+     */
+    ~TaskGroup();
+    
+    // Non-copyable
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    
+    /**
+     * @brief Queue a task; skipped if the group's token is cancelled first
+     */
+    void run(std::function<void()> task);
+    
+    /**
+     * @brief Wait for every task queued so far
+     *
+     * The group can be reused afterwards.
+     * @throws The first exception a task threw, or OperationCancelled if
+     *         tasks were skipped
+     */
+    void wait();
+    
+    const CancellationToken& token() const { return token_; }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::deque<std::function<void()>> unstarted;
+        size_t unfinished = 0;
+        std::exception_ptr error;
+    };
+    
+    Executor& executor_;
+    Executor::Priority priority_;
+    CancellationToken token_;
+    std::shared_ptr<State> state_;
+    
+    /**
+     * @brief Run the oldest unstarted task, if any is left
+     * @return false if none was
+     */
+    static bool runOne(State& state, const CancellationToken& token);
+};
+
+template <typename F, typename Result>
+void Executor::fulfil(F& task, std::promise<Result>& promise, const CancellationToken& token) {
+    try {
+        token.throwIfCancelled();
+        if constexpr (std::is_void_v<Result>) {
+            task();
+            promise.set_value();
+        } else {
+            promise.set_value(task());
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+template <typename F>
+auto Executor::submit(F task, Priority priority, CancellationToken token)
+    -> std::future<std::invoke_result_t<F&>> {
+    using Result = std::invoke_result_t<F&>;
+    auto promise = std::make_shared<std::promise<Result>>();
+    std::future<Result> future = promise->get_future();
+    
+    post([task = std::move(task), promise, token]() mutable {
+        fulfil(task, *promise, token);
+    }, priority);
+    return future;
+}
+
+template <typename F, typename Done>
+void Executor::submit(F task, QObject* context, Done done, Priority priority, CancellationToken token) {
+    using Result = std::invoke_result_t<F&>;
+    QPointer<QObject> guard(context);   // Taken here, on the caller's thread
+    bool guarded = context != nullptr;
+    
+    post([task = std::move(task), done = std::move(done), guard, guarded, token]() mutable {
+        auto promise = std::make_shared<std::promise<Result>>();
+        auto result = std::make_shared<std::future<Result>>(promise->get_future());
+        fulfil(task, *promise, token);
+        postToMainThread(guard, guarded, [done, result]() mutable {
+            done(std::move(*result));
+        });
+    }, priority);
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief A file replaced in one step through a temporary beside it
+ *
+ * Content goes to path + ".tmp". sync() flushes it to the disk, and
+ * commit() renames it over the file and makes the rename itself durable,
+ * so after a crash or power loss the file holds either the old content
+ * or all of the new, never an empty or torn one. The temporary is
+ * removed if the object is destroyed before commit() succeeds.
+ */
+class AtomicFile {
+public:
+    /**
+     * @brief Create the temporary; check isOpen()
+     */
+    explicit AtomicFile(const std::string& path);
+    ~AtomicFile();
+    
+    // Non-copyable
+    AtomicFile(const AtomicFile&) = delete;
+    AtomicFile& operator=(const AtomicFile&) = delete;
+    
+    bool isOpen() const;
+    
+    /**
+     * @brief Append to the temporary
+     */
+    bool write(const char* data, size_t size);
+    
+    /**
+     * @brief Flush the temporary's data to the disk (fsync, FlushFileBuffers)
+     */
+    bool sync();
+    
+    /**
+     * @brief Rename the temporary over the file, once sync() has succeeded
+     *
+     * On POSIX the parent directory is synced after the rename, which is
+     * what makes the new directory entry survive a power loss.
+     */
+    bool commit();
+
+private:
+    std::string path_;
+    std::string temporary_;
+#ifdef _WIN32
+    void* handle_;
+#else
+    int fd_;
+#endif
+    bool committed_;
+    
+    void close();
+};
+
+/**
+ * @brief Write a file through an AtomicFile, so readers see either the
+ * old content or all of the new, even after a crash or power loss
+ * @return false if it could not be written
+ */
+bool writeFileAtomically(const std::string& path, const std::string& content);
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Locates the structural characters of a JSON document
+ *
+ * First stage of a simdjson-style parser. Input is classified 64 bytes at
+ * a time into bitmasks (SSE2 compares where available, a scalar loop
+ * otherwise): quotes, backslashes and the operators { } [ ] : ,. Escaped
+ * quotes are dropped, string interiors are found with a prefix XOR over
+ * the quote mask, and what remains is emitted as document offsets:
+ * - every unescaped quote (opening and closing)
+ * - every operator outside a string
+ *
+ * Scalars (numbers, true, false, null) are not indexed; they are the text
+ * between two consecutive offsets. State carries across calls, so a large
+ * document can be indexed one window at a time.
+ */
+class JsonStructuralIndex {
+public:
+    static constexpr size_t BLOCK_BYTES = 64;
+    
+    JsonStructuralIndex();
+    
+    /**
+     * @brief Forget carried state before indexing a new document
+     */
+    void reset();
+    
+    /**
+     * @brief Index the next window of the document
+     * @param data Window start
+     * @param length Window size; a multiple of BLOCK_BYTES except for the last window
+     * @param base Offset of data within the document, added to emitted offsets
+     * @param offsets Receives the offsets, in increasing order
+     */
+    void scan(const char* data, size_t length, uint64_t base, std::vector<uint64_t>& offsets);
+    
+    /**
+     * @brief Whether everything scanned so far ends inside a string
+     */
+    bool inString() const { return prev_in_string_ != 0; }
+
+private:
+    uint64_t prev_in_string_;   // All ones if the last block ended inside a string
+    uint64_t prev_escaped_;     // 1 if the last block ended with an escaping backslash
+    
+    void scanBlock(const char* block, uint64_t base, std::vector<uint64_t>& offsets);
+};
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ * 
+ * Lets large read-mostly inputs (wordlists, hash corpora, vault exports)
+ * be scanned in place without copying them onto the heap.
+ */
+class MappedFile {
+public:
+    MappedFile();
+    
+    /**
+     * @brief Map a file
+     * @param path File to map
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     */
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    
+    // Non-copyable
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    // Movable
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return open_; }
+    
+    /**
+     * @brief Hint that the mapping will be read front to back
+     */
+    void adviseSequential() const;
+    
+    /**
+     * @brief Hint that the mapping will be read at random offsets
+     */
+    void adviseRandom() const;
+    
+    /**
+     * @brief Hint that a range has been read and its pages can be dropped
+     * 
+     * Only whole pages inside the range are released; the data stays
+     * readable and is faulted back in from the file if touched again.
+     */
+    void discard(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    bool open_;
+#ifdef _WIN32
+    void* file_handle_;
+    void* mapping_handle_;
+#endif
+    
+    void release();
+};
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Lock-free latency histogram with HDR-style log-linear buckets
+ *
+ * Durations are kept in nanoseconds. Below 16 ns every value has its own
+ * bucket; above, each power of two is split into 16 equal buckets, so a
+ * reported percentile is within about 3% of the true value across the
+ * whole range. Recording is a handful of relaxed atomic increments and
+ * never blocks; reading takes a copy that may be a few records behind.
+ */
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKETS = size_t(1) << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+    
+    /**
+     * @brief Point-in-time copy of a histogram
+     */
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sumNanos = 0;
+        uint64_t maxNanos = 0;
+        std::vector<uint64_t> buckets;   // Empty if count is 0
+        
+        /**
+         * @brief Value at a quantile, in nanoseconds
+         * @param quantile In [0, 1]
+         * @return 0 if nothing was recorded
+         */
+        uint64_t percentile(double quantile) const;
+        
+        double meanNanos() const { return count ? double(sumNanos) / double(count) : 0.0; }
+    };
+    
+    LatencyHistogram();
+    
+    // Non-copyable
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    
+    void record(uint64_t nanos);
+    
+    void record(std::chrono::steady_clock::duration elapsed) {
+        auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        record(nanos > 0 ? static_cast<uint64_t>(nanos) : 0);
+    }
+    
+    Snapshot snapshot() const;
+    
+    void reset();
+    
+    /**
+     * @brief Bucket holding a value, and the smallest value in a bucket
+     */
+    static size_t bucketOf(uint64_t nanos);
+    static uint64_t bucketFloor(size_t bucket);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+/**
+ * @brief Monotonic event count
+ */
+class Counter {
+public:
+    void add(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+    void reset() { value_.store(0, std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+/**
+ * @brief Latency and failure count of one named operation
+ */
+struct OperationMetrics {
+    LatencyHistogram latency;
+    Counter failures;
+};
+
+/**
+ * @brief Process-wide set of operation metrics, exportable for monitoring
+ *
+ * Operations are named "<component>.<operation>", e.g. "vault.open" or
+ * "crypto.derive_key". Entries are never removed, so references handed
+ * out stay valid for the life of the process; call sites look theirs up
+ * once and keep it in a function-local static.
+ */
+class MetricsRegistry {
+public:
+    /**
+     * @brief Summary of one operation, durations in seconds
+     */
+    struct OperationSummary {
+        std::string name;
+        uint64_t count;
+        uint64_t failures;
+        double sumSeconds;
+        double meanSeconds;
+        double p50Seconds;
+        double p90Seconds;
+        double p99Seconds;
+        double p999Seconds;
+        double maxSeconds;
+    };
+    
+    static MetricsRegistry& global();
+    
+    /**
+     * @brief Metrics for an operation, created on first use
+     */
+    OperationMetrics& operation(const std::string& name);
+    
+    /**
+     * @brief Every operation recorded at least once, by name
+     */
+    std::vector<OperationSummary> summaries() const;
+    
+    /**
+     * @brief Zero every histogram and counter
+     */
+    void reset();
+    
+    /**
+     * @brief Prometheus text exposition format (one summary per operation)
+     */
+    std::string toPrometheus() const;
+    
+    /**
+     * @brief {"operations": [{"name": ..., "count": ..., "p99_seconds": ...}, ...]}
+     */
+    std::string toJson() const;
+    
+    /**
+     * @brief Write toPrometheus() or toJson() to a file, replacing it atomically
+     *
+     * Suitable for the node_exporter textfile collector, which must never
+     * see a half-written file.
+     * @return false if the file could not be written
+     */
+    bool writeFile(const std::string& path, bool prometheus) const;
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<OperationMetrics>> operations_;
+};
+
+/**
+ * @brief Times a scope into an operation's histogram
+ *
+ * Counts a failure if the scope is left by an exception or fail() was
+ * called.
+ */
+class ScopedOperation {
+public:
+    explicit ScopedOperation(OperationMetrics& metrics)
+        : metrics_(metrics)
+        , exceptions_(std::uncaught_exceptions())
+        , failed_(false)
+        , start_(std::chrono::steady_clock::now()) {}
+    
+    ~ScopedOperation() {
+        metrics_.latency.record(std::chrono::steady_clock::now() - start_);
+        if (failed_ || std::uncaught_exceptions() > exceptions_) {
+            metrics_.failures.add();
+        }
+    }
+    
+    ScopedOperation(const ScopedOperation&) = delete;
+    ScopedOperation& operator=(const ScopedOperation&) = delete;
+    
+    /**
+     * @brief Mark the operation failed
+     * @return false, so a bool operation can `return timed.fail();`
+     */
+    bool fail() {
+        failed_ = true;
+        return false;
+    }
+
+private:
+    OperationMetrics& metrics_;
+    int exceptions_;
+    bool failed_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace core
+} // namespace crimson
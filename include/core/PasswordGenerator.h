@@ -1,13 +1,51 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <random>
+#include <memory>
+#include <array>
 #include "SecureMemory.h"
+#include "PasswordPolicy.h"
+#include "Wordlist.h"
 
 namespace crimson {
 namespace core {
 
+/**
+ * @brief Fixed-width passwords stored back to back in one secure buffer
+ */
+class PasswordBatch {
+public:
+    PasswordBatch(size_t count, size_t length);
+    
+    size_t count() const { return count_; }
+    size_t length() const { return length_; }
+    
+    /**
+     * @brief View of the i-th password (valid while the batch is alive)
+     */
+    std::string_view operator[](size_t index) const {
+        return std::string_view(buffer_->as<const char>() + index * length_, length_);
+    }
+    
+    char* data() { return buffer_->as<char>(); }
+    
+private:
+    size_t count_;
+    size_t length_;
+    std::unique_ptr<SecureMemory::SecureBuffer> buffer_;
+};
+
+/**
+ * @brief Generated passphrase and the entropy it carries
+ */
+struct Passphrase {
+    std::string text;
+    double entropyBits;
+};
+
 /**
  * @brief Hardware-based secure password generator
  * 
@@ -27,6 +65,41 @@ public:
      */
     std::string generatePassword(size_t length = 64, bool includeSymbols = true);
     
+    /**
+     * @brief Generate a password that satisfies a policy
+     * @param length Password length (must be within the policy's limits)
+     * @param policy Resolved password policy
+     * @return Randomly generated password
+     */
+    std::string generatePassword(size_t length, const PasswordPolicy& policy);
+    
+    /**
+     * @brief Generate a password into a caller-provided buffer
+     * 
+     * Performs no allocation; out must hold at least length characters.
+     */
+    void generatePassword(const PasswordPolicy& policy, char* out, size_t length);
+    
+    /**
+     * @brief Generate many passwords into one contiguous secure buffer
+     * @param count Number of passwords
+     * @param length Length of every password
+     * @param policy Character classes to draw from
+     * @return Batch holding count * length characters
+     */
+    PasswordBatch generatePasswords(size_t count, size_t length,
+                                    const PasswordPolicy& policy = PasswordPolicy::standard());
+    
+    /**
+     * @brief Generate a memorable passphrase from a wordlist
+     * @param wordlist Wordlist to sample from
+     * @param wordCount Number of words (default: 6)
+     * @param separator Character placed between words (default: '-')
+     * @return Passphrase with its entropy in bits
+     */
+    Passphrase generatePassphrase(const Wordlist& wordlist, size_t wordCount = 6,
+                                  char separator = '-');
+    
     /**
      * @brief Generate a secure random username
      * @param basePrefix Base prefix for username (default: "user_")
@@ -50,12 +123,11 @@ public:
 private:
     std::random_device hardware_rng_;
     std::mt19937_64 secure_prng_;
+    size_t bytes_since_seed_;   // Output since the last reseed
     
-    // Character sets for password generation
-    static const std::string LOWERCASE_CHARS;
-    static const std::string UPPERCASE_CHARS;
-    static const std::string DIGIT_CHARS;
-    static const std::string SYMBOL_CHARS;
+    // Bulk random bytes consumed by rejection sampling
+    std::array<uint8_t, 512> random_pool_;
+    size_t random_pool_pos_;
     
     /**
      * @brief Seed the PRNG with hardware entropy
@@ -63,9 +135,24 @@ private:
     void seedPrng();
     
     /**
-     * @brief Generate random string from character set
+     * @brief Unbiased random integer in [0, bound)
+     */
+    uint64_t uniformIndex(uint64_t bound);
+    
+    /**
+     * @brief Fill buffer with PRNG output, eight bytes per draw
+     */
+    void fillRandom(uint8_t* buffer, size_t size);
+    
+    /**
+     * @brief Fill output with characters from table using rejection sampling
+     */
+    void generateFromTable(const CharsetTable& table, char* out, size_t length);
+    
+    /**
+     * @brief Write one password honouring the policy's required classes
      */
-    std::string generateFromCharset(const std::string& charset, size_t length);
+    void generateInto(const PasswordPolicy& policy, char* out, size_t length);
 };
 
 } // namespace core
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Character classes a password policy can draw from
+ */
+enum class CharClass : uint8_t {
+    Lowercase = 0,
+    Uppercase,
+    Digit,
+    Symbol
+};
+
+constexpr size_t CHAR_CLASS_COUNT = 4;
+
+// Default character sets for password generation
+constexpr char LOWERCASE_CHARS[] = "abcdefghijklmnopqrstuvwxyz";
+constexpr char UPPERCASE_CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+constexpr char DIGIT_CHARS[] = "0123456789";
+constexpr char SYMBOL_CHARS[] = "!@#$%^&*()_+-=[]{}|;:,.<>?";
+
+// Glyphs that are easily confused when read or typed by hand
+constexpr char AMBIGUOUS_CHARS[] = "0O1lI|";
+
+/**
+ * @brief Precomputed byte-to-character lookup table for one alphabet
+ *
+ * Maps a uniformly random byte straight to a character. Bytes at or above
+ * limit() would bias the distribution and must be rejected by the caller.
+ */
+class CharsetTable {
+public:
+    constexpr CharsetTable() : lookup_{}, limit_(0), size_(0) {}
+    
+    constexpr CharsetTable(const char* alphabet, size_t size)
+        : lookup_{}, limit_(0), size_(static_cast<uint16_t>(size)) {
+        
+        if (size == 0 || size > 256) {
+            throw std::invalid_argument("Charset must contain between 1 and 256 characters");
+        }
+        
+        // Bytes below limit_ map evenly onto the alphabet
+        limit_ = static_cast<uint16_t>(256 - (256 % size));
+        for (size_t i = 0; i < lookup_.size(); ++i) {
+            lookup_[i] = alphabet[i % size];
+        }
+    }
+    
+    /**
+     * @brief Character for a random byte (only meaningful if byte < limit())
+     */
+    constexpr char lookup(uint8_t byte) const { return lookup_[byte]; }
+    
+    /**
+     * @brief Rejection threshold: largest multiple of size() not above 256
+     */
+    constexpr uint16_t limit() const { return limit_; }
+    
+    constexpr size_t size() const { return size_; }
+    
+    /**
+     * @brief Whether the table contains the character
+     */
+    constexpr bool contains(char c) const {
+        for (size_t i = 0; i < size_; ++i) {
+            if (lookup_[i] == c) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::array<char, 256> lookup_;
+    uint16_t limit_;
+    uint16_t size_;
+};
+
+/**
+ * @brief Declarative password rules, resolved into a PasswordPolicy
+ *
+ * Built with chained setters so presets stay usable in constant expressions:
+ *
+ *     PolicySpec().maxLength(20).symbols("!@#$").minimum(CharClass::Digit, 2)
+ *
+ * String arguments are only read while the PasswordPolicy is constructed.
+ */
+class PolicySpec {
+public:
+    constexpr PolicySpec()
+        : min_length_(8)
+        , max_length_(512)
+        , minimums_{1, 1, 1, 1}
+        , allowed_{true, true, true, true}
+        , symbols_(SYMBOL_CHARS)
+        , exclude_("")
+        , exclude_ambiguous_(false) {}
+    
+    constexpr PolicySpec minLength(size_t length) const {
+        PolicySpec spec = *this;
+        spec.min_length_ = length;
+        return spec;
+    }
+    
+    constexpr PolicySpec maxLength(size_t length) const {
+        PolicySpec spec = *this;
+        spec.max_length_ = length;
+        return spec;
+    }
+    
+    /**
+     * @brief Require at least count characters of the class (0 = optional)
+     */
+    constexpr PolicySpec minimum(CharClass cls, uint8_t count) const {
+        PolicySpec spec = *this;
+        spec.minimums_[static_cast<size_t>(cls)] = count;
+        spec.allowed_[static_cast<size_t>(cls)] = true;
+        return spec;
+    }
+    
+    /**
+     * @brief Remove a class from the alphabet entirely
+     */
+    constexpr PolicySpec without(CharClass cls) const {
+        PolicySpec spec = *this;
+        spec.minimums_[static_cast<size_t>(cls)] = 0;
+        spec.allowed_[static_cast<size_t>(cls)] = false;
+        return spec;
+    }
+    
+    /**
+     * @brief Replace the symbol alphabet
+     */
+    constexpr PolicySpec symbols(const char* chars) const {
+        PolicySpec spec = *this;
+        spec.symbols_ = chars;
+        return spec;
+    }
+    
+    /**
+     * @brief Characters removed from every class
+     */
+    constexpr PolicySpec exclude(const char* chars) const {
+        PolicySpec spec = *this;
+        spec.exclude_ = chars;
+        return spec;
+    }
+    
+    constexpr PolicySpec excludeAmbiguous() const {
+        PolicySpec spec = *this;
+        spec.exclude_ambiguous_ = true;
+        return spec;
+    }
+
+private:
+    friend class PasswordPolicy;
+    
+    size_t min_length_;
+    size_t max_length_;
+    std::array<uint8_t, CHAR_CLASS_COUNT> minimums_;
+    std::array<bool, CHAR_CLASS_COUNT> allowed_;
+    const char* symbols_;
+    const char* exclude_;
+    bool exclude_ambiguous_;
+};
+
+/**
+ * @brief Resolved password policy: per-class and full lookup tables
+ *
+ * Presets below are evaluated entirely at compile time. User-defined
+ * policies run the same constructor at runtime; either way generation only
+ * reads the tables and needs no allocation or charset construction.
+ */
+class PasswordPolicy {
+public:
+    constexpr explicit PasswordPolicy(const PolicySpec& spec)
+        : full_()
+        , classes_()
+        , minimums_{}
+        , required_length_(0)
+        , min_length_(spec.min_length_)
+        , max_length_(spec.max_length_) {
+        
+        const char* sources[CHAR_CLASS_COUNT] = {
+            LOWERCASE_CHARS, UPPERCASE_CHARS, DIGIT_CHARS, spec.symbols_
+        };
+        
+        std::array<bool, 256> seen{};
+        std::array<char, 256> all{};
+        size_t allSize = 0;
+        
+        for (size_t cls = 0; cls < CHAR_CLASS_COUNT; ++cls) {
+            if (!spec.allowed_[cls]) {
+                continue;
+            }
+            
+            std::array<char, 256> chars{};
+            size_t size = 0;
+            for (const char* p = sources[cls]; *p; ++p) {
+                auto byte = static_cast<uint8_t>(*p);
+                if (seen[byte] || contains(spec.exclude_, *p) ||
+                    (spec.exclude_ambiguous_ && contains(AMBIGUOUS_CHARS, *p))) {
+                    continue;
+                }
+                seen[byte] = true;
+                chars[size++] = *p;
+                all[allSize++] = *p;
+            }
+            
+            if (size == 0) {
+                if (spec.minimums_[cls] > 0) {
+                    throw std::invalid_argument("Password policy requires a class with no characters");
+                }
+                continue;
+            }
+            
+            classes_[cls] = CharsetTable(chars.data(), size);
+            minimums_[cls] = spec.minimums_[cls];
+            required_length_ += spec.minimums_[cls];
+        }
+        
+        if (allSize == 0) {
+            throw std::invalid_argument("Password policy allows no characters");
+        }
+        
+        if (min_length_ > max_length_ || required_length_ > max_length_) {
+            throw std::invalid_argument("Password policy length limits are inconsistent");
+        }
+        
+        if (min_length_ < required_length_) {
+            min_length_ = required_length_;
+        }
+        
+        full_ = CharsetTable(all.data(), allSize);
+    }
+    
+    /**
+     * @brief Table covering every allowed character
+     */
+    constexpr const CharsetTable& full() const { return full_; }
+    
+    /**
+     * @brief Table for one class (empty if the class is not allowed)
+     */
+    constexpr const CharsetTable& classTable(CharClass cls) const {
+        return classes_[static_cast<size_t>(cls)];
+    }
+    
+    /**
+     * @brief Minimum number of characters required from a class
+     */
+    constexpr uint8_t minimum(CharClass cls) const {
+        return minimums_[static_cast<size_t>(cls)];
+    }
+    
+    constexpr size_t minLength() const { return min_length_; }
+    constexpr size_t maxLength() const { return max_length_; }
+    
+    /**
+     * @brief Throw if a password of this length cannot satisfy the policy
+     */
+    void validateLength(size_t length) const;
+    
+    /**
+     * @brief Lowercase, uppercase, digits and symbols (one of each required)
+     */
+    static const PasswordPolicy& standard();
+    
+    /**
+     * @brief Lowercase, uppercase and digits (one of each required)
+     */
+    static const PasswordPolicy& alphanumeric();
+
+private:
+    CharsetTable full_;
+    std::array<CharsetTable, CHAR_CLASS_COUNT> classes_;
+    std::array<uint8_t, CHAR_CLASS_COUNT> minimums_;
+    size_t required_length_;
+    size_t min_length_;
+    size_t max_length_;
+    
+    static constexpr bool contains(const char* chars, char c) {
+        for (const char* p = chars; *p; ++p) {
+            if (*p == c) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief Common policies, resolved at compile time
+ */
+namespace policies {
+
+// Default generator output: 8-512 chars, every class, one of each
+inline constexpr PasswordPolicy STANDARD{PolicySpec()};
+
+// No symbols at all, for systems that reject them
+inline constexpr PasswordPolicy ALPHANUMERIC{PolicySpec().without(CharClass::Symbol)};
+
+// Safe to read aloud or retype from paper
+inline constexpr PasswordPolicy NO_AMBIGUOUS{PolicySpec().excludeAmbiguous()};
+
+// Typical legacy web form: max 20 chars, limited symbols, 2+ digits
+inline constexpr PasswordPolicy LEGACY_WEB{
+    PolicySpec()
+        .maxLength(20)
+        .symbols("!@#$%&*")
+        .minimum(CharClass::Digit, 2)
+        .excludeAmbiguous()};
+
+// Numeric PIN of 4-12 digits
+inline constexpr PasswordPolicy PIN{
+    PolicySpec()
+        .minLength(4)
+        .maxLength(12)
+        .without(CharClass::Lowercase)
+        .without(CharClass::Uppercase)
+        .without(CharClass::Symbol)};
+
+static_assert(STANDARD.full().size() == 88, "standard alphabet is lower+upper+digit+symbol");
+static_assert(ALPHANUMERIC.full().size() == 62, "alphanumeric alphabet has 62 characters");
+static_assert(!NO_AMBIGUOUS.full().contains('O'), "ambiguous glyphs are excluded");
+static_assert(PIN.full().size() == 10 && PIN.minLength() == 4, "PIN policy is digits only");
+
+} // namespace policies
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include "EntryId.h"
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief In-memory search index over entry labels and usernames
+ * 
+ * Two structures are kept up to date incrementally:
+ * - a prefix trie (first MAX_TRIE_DEPTH characters of each label and
+ *   username) answering short "starts with" queries
+ * - sorted trigram posting lists answering longer prefix and substring
+ *   queries by intersection, plus fuzzy matches ranked by the share of
+ *   query trigrams a candidate contains
+ * 
+ * Matching is ASCII case-insensitive. Removed entries are tombstoned and
+ * the index is compacted once tombstones outnumber live entries.
+ */
+class SearchIndex {
+public:
+    static constexpr size_t MAX_TRIE_DEPTH = 8;
+    
+    SearchIndex();
+    
+    /**
+     * @brief Index an entry (replaces any previous entry with the same ID)
+     */
+    void add(const EntryId& id, const std::string& label, const std::string& username);
+    
+    /**
+     * @brief Drop an entry from the index
+     */
+    void remove(const EntryId& id);
+    
+    /**
+     * @brief Drop every entry
+     */
+    void clear();
+    
+    /**
+     * @brief Find entries matching a query
+     * 
+     * Prefix matches come first, then substring matches, without
+     * duplicates. Fuzzy matches are only returned when nothing matches
+     * exactly.
+     * 
+     * @param query Search text
+     * @param limit Maximum number of results
+     * @return Matching entry IDs with their labels, best first
+     */
+    std::vector<std::pair<EntryId, std::string>> search(const std::string& query, size_t limit) const;
+    
+    /**
+     * @brief Number of live entries
+     */
+    size_t size() const { return docs_.size() - dead_; }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    
+    struct Doc {
+        EntryId id;
+        std::string display;        // Label as entered
+        uint32_t text_offset;       // Lowercased label then username in text_
+        uint32_t label_length;
+        uint32_t username_length;
+        bool alive;
+    };
+    
+    struct TrieNode {
+        uint32_t first_child;
+        uint32_t next_sibling;
+        uint32_t first_posting;   // Head of this node's posting list
+        char symbol;
+    };
+    
+    std::vector<Doc> docs_;
+    std::string text_;   // Lowercased labels and usernames, back to back
+    std::unordered_map<EntryId, uint32_t> doc_by_id_;
+    size_t dead_;
+    
+    // Trie postings are doc * 2 + field (0 = label, 1 = username),
+    // chained through posting_next_
+    std::vector<TrieNode> trie_;
+    std::vector<uint32_t> posting_next_;
+    
+    std::unordered_map<uint32_t, std::vector<uint32_t>> trigrams_;
+    
+    void insertDoc(Doc doc, std::string_view label, std::string_view username);
+    void insertTrie(std::string_view key, uint32_t posting);
+    void insertTrigrams(std::string_view text, uint32_t doc);
+    void compact();
+    
+    /**
+     * @brief Move a cursor over a sorted posting list up to doc
+     * @return true if doc is in the list
+     */
+    static bool advanceTo(const std::vector<uint32_t>& postings, size_t& cursor, uint32_t doc);
+    
+    void searchPrefix(const std::string& query, size_t limit,
+                      std::vector<uint32_t>& out, std::vector<bool>& seen) const;
+    void searchSubstring(const std::string& query, size_t limit,
+                         std::vector<uint32_t>& out, std::vector<bool>& seen) const;
+    void searchFuzzy(const std::string& query, size_t limit,
+                     std::vector<uint32_t>& out, std::vector<bool>& seen) const;
+    
+    std::string_view labelOf(const Doc& doc) const {
+        return std::string_view(text_).substr(doc.text_offset, doc.label_length);
+    }
+    
+    std::string_view usernameOf(const Doc& doc) const {
+        return std::string_view(text_).substr(doc.text_offset + doc.label_length, doc.username_length);
+    }
+    
+    static std::string normalize(const std::string& text);
+    static uint32_t trigramKey(const char* p);
+};
+
+} // namespace core
+} // namespace crimson
@@ -56,6 +56,19 @@ public:
      */
     static bool unlockMemory(void* addr, size_t len);
     
+    /**
+     * @brief Keep the whole process out of swap and core dumps
+     * 
+     * For long-lived processes holding an unlocked vault (the agent):
+     * locks all current and future pages and, on Linux, marks the process
+     * non-dumpable so other processes of the same user cannot ptrace it.
+     * Everything is locked only when RLIMIT_MEMLOCK is unlimited; otherwise
+     * buffers from createBuffer() are still locked individually.
+     * 
+     * @return true if all memory was locked
+     */
+    static bool lockProcessMemory();
+    
     /**
      * @brief Securely zero memory
      */
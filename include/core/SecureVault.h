@@ -3,11 +3,25 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include "EntryId.h"
+#include "Timestamp.h"
 #include "VaultEntry.h"
+#include "EntryTable.h"
 #include "CryptoManager.h"
 #include "PasswordGenerator.h"
+#include "CredentialPool.h"
+#include "Executor.h"
+#include "BreachCorpus.h"
+#include "SearchIndex.h"
 #include "SecureMemory.h"
+#include "VaultReader.h"
 
 namespace crimson {
 namespace core {
@@ -17,6 +31,19 @@ namespace core {
  * 
  * Handles vault creation, loading, saving, and entry management.
  * Provides the primary interface for all vault operations.
+ * 
+ * Safe to share between threads. Lookups, listings and password reads
+ * work on an immutable snapshot of the entry table, indexes and key and
+ * never take the writer lock, so they do not wait for a change or a save
+ * to finish. They are not lock-free: std::atomic_load of the snapshot
+ * pointer holds one of the standard library's pooled mutexes while it
+ * copies the pointer, and password reads and last-used listings share a
+ * short mutex over the times not yet in a snapshot. Changes are
+ * serialized; each one starts a new snapshot from the current one, edits
+ * it and publishes it with a single atomic store, so a reader sees either
+ * all of a change or none. The new snapshot shares every part the change
+ * leaves alone: a password change copies only the entry table, while
+ * adding or deleting an entry still copies every index.
  */
 class SecureVault {
 public:
@@ -41,6 +68,30 @@ public:
     bool openVault(const std::string& masterPassword,
                    const std::string& vaultPath = "vault.gpg");
     
+    /**
+     * @brief Start reading a vault file in the background
+     * 
+     * Decodes the entries and builds every index while the master password
+     * is still being typed, so a following openVault() of the same path
+     * only waits for key derivation. Calling it again for the same path
+     * is harmless. Ignored while a vault is open.
+     * 
+     * Never blocks: the read is posted to the shared executor, and a
+     * prefetch of another path is dropped without waiting for it.
+     * 
+     * @param vaultPath Path to vault file
+     */
+    void prefetch(const std::string& vaultPath);
+    
+    /**
+     * @brief Drop a pending prefetch and everything it decoded
+     * 
+     * For when the vault is not going to be opened after all, e.g. the
+     * password prompt was cancelled. Never blocks; a read already under
+     * way is freed as soon as it finishes.
+     */
+    void cancelPrefetch();
+    
     /**
      * @brief Close and lock the vault
      */
@@ -49,12 +100,18 @@ public:
     /**
      * @brief Check if vault is currently open
      */
-    bool isOpen() const { return is_open_; }
+    bool isOpen() const { return is_open_.load(); }
     
     /**
      * @brief Create a new vault entry
+     * 
+     * Credentials come from the pre-generated pool when one is ready, so
+     * this is cheap enough to call from a button handler.
+     * 
      * @param label Human-readable label for the entry
      * @return Created entry with generated credentials
+     * @throws std::runtime_error if the vault is not open, or if every
+     *         regenerated password is in the attached breach corpus
      */
     VaultEntry createEntry(const std::string& label);
     
@@ -65,32 +122,173 @@ public:
      */
     bool saveEntry(const VaultEntry& entry);
     
+    /**
+     * @brief Save several entries, writing the vault file once
+     * 
+     * For bulk imports, where saveEntry() would rewrite the file per entry.
+     * If any entry cannot be stored, none are.
+     * 
+     * @param entries Entries to add or update (plaintext passwords)
+     * @return true if all were saved
+     */
+    bool saveEntries(const std::vector<VaultEntry>& entries);
+    
     /**
      * @brief Get all entry labels (for listing)
      * @return Vector of entry labels with IDs
      */
-    std::vector<std::pair<std::string, std::string>> getEntryLabels() const;
+    std::vector<std::pair<EntryId, std::string>> getEntryLabels() const;
+    
+    /**
+     * @brief Number of entries (0 if the vault is closed)
+     */
+    size_t getEntryCount() const;
+    
+    /**
+     * @brief ID of the entry at a position in vault order
+     * @param index Position in [0, getEntryCount())
+     */
+    EntryId getEntryIdAt(size_t index) const;
+    
+    /**
+     * @brief Position of an entry in vault order
+     * @return Its index, or getEntryCount() if the vault holds no such entry
+     */
+    size_t findEntry(const EntryId& entryId) const;
+    
+    /**
+     * @brief Label of the entry at a position in vault order
+     * @param index Position in [0, getEntryCount())
+     */
+    std::string getEntryLabelAt(size_t index) const;
+    
+    /**
+     * @brief Sort orders for paged listing
+     */
+    enum class EntryOrder {
+        Label,       // Case-insensitive label
+        CreatedAt,   // Creation time
+        LastUsed     // Last password access (never-used entries first)
+    };
+    
+    /**
+     * @brief One page of a sorted listing
+     */
+    struct EntryPage {
+        std::vector<std::pair<EntryId, std::string>> entries;   // (id, label)
+        std::string nextCursor;   // Empty when there are no further rows
+    };
+    
+    /**
+     * @brief List entries in sorted order, one page at a time
+     * 
+     * Served from ordered indexes kept up to date on every mutation, so a
+     * page costs O(log n + pageSize). Cursors are opaque and stay valid
+     * across mutations: the next page starts after the last row returned,
+     * even if that entry has since changed or been deleted.
+     * 
+     * @param order Sort key
+     * @param cursor nextCursor of the previous page (empty for the first page)
+     * @param pageSize Maximum rows in the page
+     * @param descending Reverse the order (e.g. most recently used first)
+     * @return Page of (id, label) pairs
+     * @throws std::invalid_argument if the cursor is malformed
+     */
+    EntryPage listEntries(EntryOrder order, const std::string& cursor = std::string(),
+                          size_t pageSize = 50, bool descending = false) const;
+    
+    /**
+     * @brief Search labels and usernames (prefix, substring, then fuzzy)
+     * @param query Search text (case-insensitive)
+     * @param limit Maximum number of results
+     * @return Matching entry IDs with labels, best first
+     */
+    std::vector<std::pair<EntryId, std::string>> search(const std::string& query,
+                                                        size_t limit = 200) const;
     
     /**
      * @brief Get entry by ID (without password)
      * @param entryId Entry ID
      * @return Entry with encrypted password
      */
-    VaultEntry getEntry(const std::string& entryId) const;
+    VaultEntry getEntry(const EntryId& entryId) const;
+    
+    /**
+     * @brief Metadata view of an entry, without copying
+     * @param entryId Entry ID
+     * @return View that keeps the snapshot it points into alive
+     */
+    EntryView getEntryView(const EntryId& entryId) const;
+    
+    /**
+     * @brief Whether the open vault holds an entry
+     */
+    bool hasEntry(const EntryId& entryId) const;
+    
+    /**
+     * @brief Metadata view of the entry at a position in vault order
+     * @param index Position in [0, getEntryCount())
+     */
+    EntryView getEntryViewAt(size_t index) const;
+    
+    /**
+     * @brief Find an entry by ID, or else by exact label
+     * @throws std::runtime_error if there is no match or the label is ambiguous
+     */
+    EntryId resolveEntry(const std::string& key) const;
+    
+    using EntryVisitor = std::function<bool(const EntryView&)>;
+    
+    /**
+     * @brief Visit every entry in vault order without copying
+     * 
+     * Visits the snapshot current at the call, so changes made meanwhile,
+     * even by the visitor itself, are not seen. Return false to stop.
+     * 
+     * @return Number of entries visited
+     */
+    size_t forEachEntry(const EntryVisitor& visitor) const;
     
     /**
      * @brief Get decrypted password for entry
+     * 
+     * Also records the access as the entry's last-used time. Views and
+     * last-used listings show it at once; it is folded into the next
+     * snapshot with the next change, and written out only with the next
+     * change the user saves. A read never writes the file, so times
+     * recorded after the last save are lost when the vault is closed.
+     * 
      * @param entryId Entry ID
      * @return Decrypted password
      */
-    std::string getPassword(const std::string& entryId);
+    std::string getPassword(const EntryId& entryId);
     
     /**
      * @brief Delete an entry
      * @param entryId Entry ID to delete
      * @return true if deleted successfully
      */
-    bool deleteEntry(const std::string& entryId);
+    bool deleteEntry(const EntryId& entryId);
+    
+    /**
+     * @brief Attach an offline breached-password corpus
+     * 
+     * Newly generated credentials are re-drawn if they appear in it.
+     * Pass nullptr to detach.
+     */
+    void setBreachCorpus(std::shared_ptr<const BreachCorpus> corpus);
+    
+    /**
+     * @brief Check a plaintext password against the attached corpus
+     * @return false if no corpus is attached
+     */
+    bool isPasswordBreached(const std::string& password) const;
+    
+    /**
+     * @brief Find every entry whose password appears in the attached corpus
+     * @return IDs of breached entries
+     */
+    std::vector<EntryId> findBreachedEntries();
     
     /**
      * @brief Auto-lock after inactivity
@@ -120,37 +318,253 @@ public:
      */
     struct VaultStats {
         size_t entryCount;
-        std::string createdAt;
-        std::string lastModified;
+        Timestamp createdAt;      // Earliest entry creation (null if empty)
+        Timestamp lastModified;   // Latest entry creation (null if empty)
         std::string deviceFingerprint;
     };
     
     VaultStats getStats() const;
 
+    /**
+     * @brief Options for a whole-vault health audit
+     */
+    struct AuditOptions {
+        double weakBelowBits = 60.0;   // Estimated entropy under which a password is weak
+        int staleAfterDays = 365;      // Age (by created_at) after which an entry is stale
+        size_t batchSize = 512;        // Entries decrypted per worker batch
+        unsigned threads = 0;          // Concurrent batches (0 = the shared executor's size)
+        CancellationToken cancel;      // Checked between batches
+    };
+    
+    /**
+     * @brief Audit findings for one entry
+     */
+    struct EntryAudit {
+        EntryId id;
+        std::string label;
+        double strengthBits;   // Estimated entropy of the password
+        bool weak;
+        int64_t ageDays;       // -1 if created_at could not be parsed
+        bool stale;
+        bool breached;         // Only set when a breach corpus is attached
+    };
+    
+    /**
+     * @brief Totals over the whole audit
+     */
+    struct AuditSummary {
+        size_t entries = 0;
+        size_t weak = 0;
+        size_t reused = 0;     // Entries sharing their password with another
+        size_t stale = 0;
+        size_t breached = 0;
+        std::vector<std::vector<EntryId>> reuseGroups;   // Entries per shared password, in vault order
+    };
+    
+    using AuditCallback = std::function<void(const EntryAudit&)>;
+    
+    /**
+     * @brief Score strength, reuse, age and breach status of every entry
+     * 
+     * Passwords are decrypted in parallel batches, on the shared executor's
+     * bulk lane, into locked per-worker buffers and wiped immediately after
+     * scoring. Reuse is detected via an
+     * HMAC-SHA256 index under a one-off random key, so plaintexts are never
+     * compared with each other or kept. Results are delivered to the
+     * callback on the calling thread, in vault order, as soon as each
+     * batch is done; the calling thread works through batches itself
+     * while it waits. Reuse needs every entry, so it is reported in the
+     * summary's reuseGroups once the last batch is in.
+     * 
+     * @param options Audit thresholds and parallelism
+     * @param callback Receives one result per entry (may be empty)
+     * @return Aggregate counts
+     * @throws OperationCancelled if options.cancel is cancelled first
+     */
+    AuditSummary auditVault(const AuditOptions& options, const AuditCallback& callback);
+
 private:
+    /**
+     * @brief Part of a snapshot, shared with the snapshots copied from it
+     * 
+     * A copy reads the same part until edit() gives it one of its own, so
+     * a change pays only for the parts it modifies.
+     */
+    template <typename T>
+    class Shared {
+    public:
+        Shared() : part_(std::make_shared<T>()), owned_(true) {}
+        Shared(const Shared& other) : part_(other.part_), owned_(false) {}
+        Shared& operator=(const Shared&) = delete;
+        
+        const T& operator*() const { return *part_; }
+        const T* operator->() const { return part_.get(); }
+        
+        /**
+         * @brief The part, copied first if it is still shared
+         */
+        T& edit() {
+            if (!owned_) {
+                part_ = std::make_shared<T>(*part_);
+                owned_ = true;
+            }
+            return *part_;
+        }
+
+    private:
+        std::shared_ptr<T> part_;
+        bool owned_;   // Not shared with any published snapshot
+    };
+    
+    /**
+     * @brief Entry table, indexes and key as of one change
+     * 
+     * Never modified once published; readers keep the snapshot they loaded
+     * alive for as long as they use it. The key and any part a change
+     * left alone are shared between snapshots.
+     */
+    struct Snapshot {
+        std::shared_ptr<const SecureMemory::SecureBuffer> key;
+        Shared<EntryTable> entries;
+        Shared<std::unordered_map<EntryId, size_t>> positions;   // id -> row
+        Shared<SearchIndex> search_index;
+        
+        // Ordered listing indexes: (sort key, id)
+        Shared<std::set<std::pair<std::string, EntryId>>> label_order;
+        Shared<std::set<std::pair<Timestamp, EntryId>>> created_order;
+        Shared<std::set<std::pair<Timestamp, EntryId>>> last_used_order;
+        
+        /**
+         * @brief Row of an entry in entries (entries.size() if absent)
+         */
+        size_t find(const EntryId& entryId) const;
+    };
+    
     std::unique_ptr<CryptoManager> crypto_manager_;
     std::unique_ptr<PasswordGenerator> password_generator_;
-    std::unique_ptr<SecureMemory::SecureBuffer> vault_key_;
+    std::unique_ptr<CredentialPool> credential_pool_;
+    std::shared_ptr<const BreachCorpus> breach_corpus_;   // Accessed with std::atomic_load/store
+    
+    // Current snapshot, null while closed. Accessed only through
+    // current() and publish()
+    mutable std::shared_ptr<const Snapshot> snapshot_;
+    
+    // Serializes changes: opening, closing, entry edits, saves, and the
+    // members below that are not atomic
+    mutable std::mutex write_mutex_;
+    
+    // Last-used times recorded by getPassword() but not yet in a snapshot
+    mutable std::mutex usage_mutex_;
+    mutable std::unordered_map<EntryId, Timestamp> usage_;
+    mutable std::set<std::pair<Timestamp, EntryId>> usage_order_;   // usage_ by time
+    mutable std::atomic<bool> usage_pending_;                   // usage_ is not empty
+    mutable std::unordered_map<EntryId, Timestamp> folded_usage_;   // Copied by beginChange()
     
-    std::vector<VaultEntry> entries_;
     std::string vault_path_;
     std::string vault_salt_;
     std::string master_hash_;
-    bool is_open_;
+    std::atomic<bool> is_open_;
+    
+    /**
+     * @brief Background read started by prefetch()
+     * 
+     * Shared with the executor task, so dropping one never waits for it.
+     * Whichever of that task and openVault() gets to it first decodes the
+     * file; a dropped prefetch nobody has started is skipped.
+     */
+    struct Prefetch {
+        std::string path;
+        std::atomic<bool> claimed{false};   // Decoding has started
+        std::atomic<bool> dropped{false};   // Not wanted any more; skip if unclaimed
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;                  // Guarded by mutex
+        std::shared_ptr<Snapshot> loaded;   // Set before done; null if the read failed
+        
+        /**
+         * @brief Decode the file, unless already claimed or dropped
+         */
+        void run();
+    };
+    
+    // Held only to swap prefetch_, never while decoding
+    std::mutex prefetch_mutex_;
+    std::shared_ptr<Prefetch> prefetch_;
     
     // Auto-lock functionality
-    std::chrono::steady_clock::time_point last_activity_;
-    int auto_lock_timeout_;
+    std::atomic<std::chrono::steady_clock::rep> last_activity_;   // steady_clock ticks
+    std::atomic<int> auto_lock_timeout_;
+    
+    /**
+     * @brief The published snapshot (null while closed)
+     */
+    std::shared_ptr<const Snapshot> current() const { return std::atomic_load(&snapshot_); }
     
     /**
-     * @brief Load vault from file
+     * @brief New snapshot sharing the current one, with recorded usage folded in
+     * 
+     * Edit it, then publish() it. Needs write_mutex_ and an open vault.
      */
-    bool loadVaultFile();
+    std::shared_ptr<Snapshot> beginChange() const;
     
     /**
-     * @brief Save vault to file
+     * @brief Make a snapshot current (nullptr when closing)
+     * 
+     * Drops the usage beginChange() folded into it from usage_. Needs
+     * write_mutex_.
      */
-    bool saveVaultFile();
+    void publish(std::shared_ptr<const Snapshot> next) const;
+    
+    /**
+     * @brief Last-used time of a row, including usage not yet folded in
+     */
+    Timestamp lastUsedAt(const Snapshot& snapshot, size_t row) const;
+    
+    /**
+     * @brief View of a row that owns a reference to its snapshot
+     */
+    EntryView viewOf(const std::shared_ptr<const Snapshot>& snapshot, size_t row) const;
+    
+    /**
+     * @brief closeVault() body; needs write_mutex_
+     */
+    void closeLocked();
+    
+    /**
+     * @brief Load entries from a vault file and build the indexes
+     */
+    static bool loadVaultFile(const std::string& path, Snapshot& snapshot);
+    
+    /**
+     * @brief Take the prefetch of a path, decoding it here if no worker has started
+     * @return What it loaded (null if it failed or none was pending for the path)
+     */
+    std::shared_ptr<Snapshot> takePrefetch(const std::string& vaultPath);
+    
+    /**
+     * @brief Write a snapshot to the vault file
+     */
+    bool saveVaultFile(const Snapshot& snapshot);
+    
+    /**
+     * @brief Encrypt an entry's password and add or replace it in a snapshot
+     */
+    void storeEntry(Snapshot& snapshot, const VaultEntry& entry) const;
+    
+    /**
+     * @brief Add a table row to the search and listing indexes
+     */
+    static void indexEntry(Snapshot& snapshot, size_t row);
+    
+    /**
+     * @brief Remove a table row from the search and listing indexes
+     */
+    static void unindexEntry(Snapshot& snapshot, size_t row);
+    
+    /**
+     * @brief Rebuild every index from the entry table
+     */
+    static void rebuildIndexes(Snapshot& snapshot);
     
     /**
      * @brief Generate vault metadata
@@ -161,11 +575,6 @@ private:
      * @brief Parse vault metadata
      */
     bool parseVaultMetadata(const std::string& metadata);
-    
-    /**
-     * @brief Clear sensitive data from memory
-     */
-    void clearSensitiveData();
 };
 
 } // namespace core
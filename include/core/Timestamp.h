@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Point in time as whole seconds since the Unix epoch (UTC)
+ *
+ * The null timestamp (0) means "unknown" or "never". ISO 8601 text is
+ * only produced at the serialization and UI edges via toIso().
+ */
+class Timestamp {
+public:
+    constexpr Timestamp() : seconds_(0) {}
+    explicit constexpr Timestamp(int64_t secondsSinceEpoch) : seconds_(secondsSinceEpoch) {}
+    
+    /**
+     * @brief Current time
+     */
+    static Timestamp now();
+    
+    /**
+     * @brief Parse ISO 8601 text (any UTC offset, optional fractional seconds)
+     * @return Null timestamp if the text is empty or cannot be parsed
+     */
+    static Timestamp fromIso(std::string_view text);
+    
+    /**
+     * @brief UTC ISO 8601 text ("yyyy-MM-ddTHH:mm:ssZ")
+     * @return Empty string for the null timestamp
+     */
+    std::string toIso() const;
+    
+    int64_t seconds() const { return seconds_; }
+    bool isNull() const { return seconds_ == 0; }
+    
+    friend bool operator==(Timestamp a, Timestamp b) { return a.seconds_ == b.seconds_; }
+    friend bool operator!=(Timestamp a, Timestamp b) { return a.seconds_ != b.seconds_; }
+    friend bool operator<(Timestamp a, Timestamp b) { return a.seconds_ < b.seconds_; }
+    friend bool operator>(Timestamp a, Timestamp b) { return a.seconds_ > b.seconds_; }
+    friend bool operator<=(Timestamp a, Timestamp b) { return a.seconds_ <= b.seconds_; }
+    friend bool operator>=(Timestamp a, Timestamp b) { return a.seconds_ >= b.seconds_; }
+
+private:
+    int64_t seconds_;
+};
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Process-wide recorder of timed spans, exportable for Perfetto
+ *
+ * Off by default. While off, a span costs one relaxed atomic load. While
+ * on, each thread writes completed spans into its own ring buffer of
+ * EVENTS_PER_THREAD events without locking; once full, its oldest spans
+ * are overwritten. Export may run at any time, from any thread, and
+ * skips spans being overwritten as it reads them.
+ *
+ * Category and name must be string literals (or otherwise outlive the
+ * process): only the pointers are kept.
+ */
+class Trace {
+public:
+    static constexpr size_t EVENTS_PER_THREAD = 4096;
+    
+    static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+    
+    /**
+     * @brief Forget every span recorded so far
+     */
+    static void clear();
+    
+    /**
+     * @brief Nanoseconds on the monotonic clock spans are recorded in
+     */
+    static uint64_t nowNanos();
+    
+    /**
+     * @brief Record a finished span on the calling thread's buffer
+     */
+    static void record(const char* category, const char* name, uint64_t startNanos, uint64_t endNanos);
+    
+    /**
+     * @brief Recorded spans in Chrome trace_event JSON ("X" complete events)
+     *
+     * Opens in ui.perfetto.dev and chrome://tracing.
+     */
+    static std::string toChromeJson();
+    
+    /**
+     * @brief Write toChromeJson() to a file, replacing it atomically
+     * @return false if the file could not be written
+     */
+    static bool writeFile(const std::string& path);
+
+private:
+    static inline std::atomic<bool> enabled_{false};
+};
+
+/**
+ * @brief Records the enclosing scope as a span, if tracing was on when it began
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* category, const char* name)
+        : category_(category)
+        , name_(name)
+        , active_(Trace::enabled())
+        , start_(active_ ? Trace::nowNanos() : 0) {}
+    
+    ~TraceSpan() {
+        if (active_) {
+            Trace::record(category_, name_, start_, Trace::nowNanos());
+        }
+    }
+    
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* category_;
+    const char* name_;
+    bool active_;
+    uint64_t start_;
+};
+
+} // namespace core
+} // namespace crimson
+
+/**
+ * @brief Trace the rest of the enclosing scope as category/name
+ *
+ * Compiled out entirely when CRIMSON_NO_TRACE is defined (CMake option
+ * ENABLE_TRACING=OFF).
+ */
+#ifdef CRIMSON_NO_TRACE
+#define CRIMSON_TRACE_SPAN(category, name) ((void)0)
+#else
+#define CRIMSON_TRACE_CONCAT_(a, b) a##b
+#define CRIMSON_TRACE_VARIABLE_(line) CRIMSON_TRACE_CONCAT_(crimson_trace_span_, line)
+#define CRIMSON_TRACE_SPAN(category, name) \
+    ::crimson::core::TraceSpan CRIMSON_TRACE_VARIABLE_(__LINE__)(category, name)
+#endif
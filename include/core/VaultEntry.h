@@ -1,21 +1,45 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include "EntryId.h"
+#include "Timestamp.h"
 
 namespace crimson {
 namespace core {
 
+/**
+ * @brief Read-only view of an entry's metadata (no password)
+ * 
+ * String fields point into storage owned by the vault. Views from
+ * SecureVault hold a reference to that storage in owner, so they stay
+ * valid, unchanged, after the vault is edited or closed, on any thread.
+ * Views built without an owner (e.g. by EntryTable::view()) are only
+ * valid until their table is modified.
+ */
+struct EntryView {
+    EntryId id;
+    std::string_view label;
+    std::string_view username;
+    Timestamp created_at;              // Null if unknown
+    Timestamp last_used_at;            // Null if never used
+    std::string_view device_fingerprint;
+    std::shared_ptr<const void> owner;   // Keeps the fields' storage alive (may be empty)
+};
+
 /**
  * @brief Represents a single vault entry
  */
 struct VaultEntry {
-    std::string id;           // UUID
+    EntryId id;
     std::string label;        // Human-readable label
     std::string username;     // Generated username
     std::string password;     // Encrypted password
-    std::string created_at;   // ISO timestamp
+    Timestamp created_at;
+    Timestamp last_used_at;   // Last password access (null if never)
     std::string device_fingerprint; // SHA256 of device ID
     
     /**
@@ -25,21 +49,14 @@ struct VaultEntry {
     
     /**
      * @brief Create entry from JSON string
+     * @throws std::runtime_error if the JSON or the entry ID is invalid
      */
     static VaultEntry fromJson(const std::string& json);
     
-    /**
-     * @brief Generate a new UUID
-     */
-    static std::string generateUuid();
-    
-    /**
-     * @brief Get current timestamp in ISO format
-     */
-    static std::string getCurrentTimestamp();
-    
     /**
      * @brief Generate device fingerprint
+     * 
+     * Computed once per process; the inputs do not change while running.
      */
     static std::string getDeviceFingerprint();
 };
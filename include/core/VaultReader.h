@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include "EntryTable.h"
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Streaming reader for vault JSON documents
+ *
+ * Walks the document with a JsonStructuralIndex one window at a time and
+ * decodes each element of the "entries" array straight into an
+ * EntryTable through EntryCodec. No document tree is built: besides the
+ * table, memory use is one window of structural offsets and a scratch
+ * entry. Files are memory-mapped and each window's pages are handed back
+ * to the kernel once consumed.
+ *
+ * Header keys may come before or after "entries" and unknown keys are
+ * skipped, so files written by older versions and by other tools load
+ * the same way.
+ *
+ * With more than one thread, a first pass over the structural index only
+ * splits the entries array into CHUNK_BYTES chunks; tasks on the shared
+ * executor then decode the chunks into tables of their own, which are
+ * appended in document order. The result is the same as a single-threaded read.
+ */
+class VaultReader {
+public:
+    static constexpr size_t WINDOW_BYTES = 1 << 20;
+    static constexpr size_t CHUNK_BYTES = 1 << 20;
+    
+    /**
+     * @brief Top-level vault fields other than the entries
+     */
+    struct Header {
+        std::string version;
+        std::string salt;
+        std::string master_hash;
+        std::string created_at;
+        std::string device_fingerprint;
+    };
+    
+    /**
+     * @brief Read a vault file, replacing the table's contents
+     * @param threads Concurrent decoding tasks (1 = stream on the calling thread)
+     * @throws std::runtime_error if the file cannot be mapped or is not a vault document
+     */
+    static Header readFile(const std::string& path, EntryTable& table, unsigned threads = 1);
+    
+    /**
+     * @brief Read a vault document held in memory, replacing the table's contents
+     * @param threads Concurrent decoding tasks (1 = stream on the calling thread)
+     * @throws std::runtime_error if the text is not a vault document
+     */
+    static Header read(std::string_view document, EntryTable& table, unsigned threads = 1);
+    
+    /**
+     * @brief Read only the header fields of a vault file
+     * 
+     * Stops at "entries" if the salt and master hash came before it, as
+     * in files written by SecureVault; otherwise the entries are skipped
+     * over without being decoded.
+     * @throws std::runtime_error if the file cannot be mapped or is not a vault document
+     */
+    static Header readHeader(const std::string& path);
+};
+
+} // namespace core
+} // namespace crimson
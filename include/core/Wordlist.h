@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include "MappedFile.h"
+
+namespace crimson {
+namespace core {
+
+/**
+ * @brief Memory-mapped diceware-style wordlist
+ * 
+ * Accepts one word (or phrase) per line, optionally preceded by dice
+ * digits and a tab or space (the EFF list format). The file is mapped
+ * once and a compact offset/length index is built on first use; words
+ * are returned as views into the mapping, so no per-word allocation ever
+ * happens.
+ *
+ * Repeated words are indexed once, so size() and bitsPerWord() count
+ * distinct words only. Words longer than MAX_WORD_LENGTH are left out
+ * and counted in oversizedWords().
+ *
+ * No list ships with the application; callers pass the path of one the
+ * user supplies, such as the EFF large wordlist.
+ */
+class Wordlist {
+public:
+    static constexpr size_t MAX_WORD_LENGTH = 255;
+    
+    /**
+     * @brief Map a wordlist file (index is built lazily)
+     * @param path Wordlist file
+     */
+    explicit Wordlist(const std::string& path);
+    
+    // Non-copyable
+    Wordlist(const Wordlist&) = delete;
+    Wordlist& operator=(const Wordlist&) = delete;
+    
+    /**
+     * @brief Number of distinct words in the list
+     */
+    size_t size() const;
+    
+    /**
+     * @brief Lines dropped as repeats of an earlier word
+     */
+    size_t duplicateWords() const;
+    
+    /**
+     * @brief Lines dropped for being longer than MAX_WORD_LENGTH
+     */
+    size_t oversizedWords() const;
+    
+    /**
+     * @brief Word at index (valid while the wordlist is alive)
+     */
+    std::string_view word(size_t index) const;
+    
+    /**
+     * @brief Entropy contributed by one uniformly chosen word
+     */
+    double bitsPerWord() const;
+
+private:
+    MappedFile file_;
+    
+    mutable std::once_flag indexed_;
+    mutable std::vector<uint32_t> offsets_;
+    mutable std::vector<uint8_t> lengths_;
+    mutable size_t duplicates_;
+    mutable size_t oversized_;
+    
+    void buildIndex() const;
+    void ensureIndexed() const;
+};
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QtWidgets/QDialog>
+#include <QtWidgets/QVBoxLayout>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QTableWidget>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QLabel>
+#include <QtWidgets/QCheckBox>
+#include <QtCore/QTimer>
+
+namespace crimson {
+namespace ui {
+
+/**
+ * @brief Dialog showing per-operation latency and failure counts
+ * 
+ * Provides:
+ * - Count, failures, mean, p50/p90/p99/p99.9 and max of every vault and
+ *   crypto operation recorded so far
+ * - Export as a Prometheus textfile or as JSON
+ * - Reset of all counters
+ * - Recording of trace spans, exported as Chrome trace JSON for Perfetto
+ */
+class DiagnosticsDialog : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsDialog(QWidget* parent = nullptr);
+
+private slots:
+    void onRefresh();
+    void onReset();
+    void onExportPrometheus();
+    void onExportJson();
+    void onTraceToggled(bool enabled);
+    void onExportTrace();
+
+private:
+    // UI components
+    QVBoxLayout* main_layout_;
+    QHBoxLayout* button_layout_;
+    QTableWidget* table_;
+    QLabel* summary_label_;
+    
+    // Action buttons
+    QPushButton* refresh_btn_;
+    QPushButton* reset_btn_;
+    QPushButton* export_prometheus_btn_;
+    QPushButton* export_json_btn_;
+    QCheckBox* trace_check_;
+    QPushButton* export_trace_btn_;
+    QPushButton* close_btn_;
+    
+    // Keeps the table current while the dialog is open
+    QTimer* refresh_timer_;
+    
+    /**
+     * @brief Initialize UI components
+     */
+    void setupUI();
+    
+    /**
+     * @brief Ask for a path and write the metrics there
+     */
+    void exportTo(bool prometheus);
+};
+
+} // namespace ui
+} // namespace crimson
@@ -15,6 +15,7 @@
 namespace crimson {
 namespace core {
 class SecureVault;
+class AsyncVault;
 }
 }
 
@@ -53,7 +54,9 @@ private slots:
 private:
     // Core components
     std::unique_ptr<crimson::core::SecureVault> vault_;
+    std::unique_ptr<crimson::core::AsyncVault> async_vault_;   // Slow vault calls go through this
     QTimer* auto_lock_timer_;
+    bool pending_;   // A vault operation started here has not finished
     
     // UI components
     QWidget* central_widget_;
@@ -119,6 +122,18 @@ private:
      */
     void updateSecurityStatus();
     
+    /**
+     * @brief Disable the window's actions while a vault operation runs
+     * @param message Status bar text until the operation finishes
+     * @return false if another operation is already pending
+     */
+    bool beginPending(const QString& message);
+    
+    /**
+     * @brief Re-enable the window's actions
+     */
+    void endPending();
+    
     /**
      * @brief Show critical error message
      */
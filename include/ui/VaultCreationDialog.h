@@ -10,6 +10,7 @@
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QCheckBox>
 #include <QtCore/QTimer>
+#include "../core/AsyncVault.h"
 #include "../core/VaultEntry.h"
 
 namespace crimson {
@@ -27,7 +28,7 @@ class VaultCreationDialog : public QDialog {
     Q_OBJECT
 
 public:
-    explicit VaultCreationDialog(QWidget* parent = nullptr);
+    explicit VaultCreationDialog(crimson::core::AsyncVault* vault, QWidget* parent = nullptr);
     ~VaultCreationDialog();
     
     /**
@@ -46,8 +47,12 @@ private slots:
     void hidePasswordDisplay();
 
 private:
+    // Core components
+    crimson::core::AsyncVault* async_vault_;
+    
     // Entry data
     crimson::core::VaultEntry entry_;
+    bool generating_;   // Credentials are being drawn off the GUI thread
     bool credentials_generated_;
     bool entry_saved_;
     
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QtCore/QAbstractListModel>
+#include "../core/EntryId.h"
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace crimson {
+namespace core {
+class SecureVault;
+}
+}
+
+namespace crimson {
+namespace ui {
+
+/**
+ * @brief List model over the vault's entry index
+ * 
+ * Rows are read straight from SecureVault on demand rather than copied
+ * into per-row items, and are exposed to the view in pages through
+ * canFetchMore()/fetchMore() so that opening a large vault only touches
+ * the rows actually on screen.
+ * 
+ * With a filter set, the rows are the vault's search results instead.
+ */
+class VaultEntryListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    static constexpr int FETCH_PAGE_SIZE = 256;
+    static constexpr int SEARCH_LIMIT = 500;
+    static constexpr int EntryIdRole = Qt::UserRole;
+    
+    explicit VaultEntryListModel(crimson::core::SecureVault* vault, QObject* parent = nullptr);
+    
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    
+    /**
+     * @brief Entry ID for a row (null if out of range)
+     */
+    crimson::core::EntryId entryIdAt(int row) const;
+    
+    /**
+     * @brief Total number of entries in the vault, fetched or not
+     */
+    int totalCount() const;
+    
+    /**
+     * @brief Drop the row of an entry once the vault has deleted it
+     * 
+     * Nothing changes if the entry is still in the vault. With a filter
+     * set, the row is found among the results by ID. Otherwise it is the
+     * entry's old position, as deletion keeps vault order and the rows
+     * below simply move up.
+     * 
+     * @param position Where the entry was in vault order before deletion
+     */
+    void removeDeletedEntry(const crimson::core::EntryId& entryId, size_t position);
+    
+    /**
+     * @brief Discard fetched rows and start paging again from the top
+     * 
+     * An active filter is re-run against the current vault contents.
+     */
+    void reload();
+    
+    /**
+     * @brief Show only entries matching a search query
+     * @param query Search text (empty shows every entry again)
+     */
+    void setFilter(const QString& query);
+    
+    /**
+     * @brief Whether rows are currently search results
+     */
+    bool isFiltered() const { return !filter_.empty(); }
+
+private:
+    crimson::core::SecureVault* vault_;
+    int fetched_rows_;
+    
+    std::string filter_;
+    std::vector<std::pair<crimson::core::EntryId, std::string>> results_;   // (id, label)
+};
+
+} // namespace ui
+} // namespace crimson
@@ -4,8 +4,7 @@
 #include <QtWidgets/QVBoxLayout>
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QFormLayout>
-#include <QtWidgets/QListWidget>
-#include <QtWidgets/QListWidgetItem>
+#include <QtWidgets/QListView>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QLabel>
 #include <QtWidgets/QLineEdit>
@@ -14,7 +13,9 @@
 #include <QtWidgets/QGroupBox>
 #include <QtCore/QTimer>
 #include <memory>
+#include "../core/AsyncVault.h"
 #include "../core/SecureVault.h"
+#include "VaultEntryListModel.h"
 
 namespace crimson {
 namespace ui {
@@ -24,20 +25,23 @@ namespace ui {
  * 
  * Provides:
  * - List of all vault entries (labels only)
+ * - Search-as-you-type filter over labels and usernames
  * - Entry details view (username visible, password hidden)
  * - Secure password reveal and copy functionality
- * - Entry deletion
+ * - Entry deletion, written out in the background
  */
 class VaultViewDialog : public QDialog {
     Q_OBJECT
 
 public:
-    explicit VaultViewDialog(crimson::core::SecureVault* vault, QWidget* parent = nullptr);
+    explicit VaultViewDialog(crimson::core::AsyncVault* vault, QWidget* parent = nullptr);
     ~VaultViewDialog();
 
 private slots:
     void onEntrySelectionChanged();
     void onRefreshEntries();
+    void onSearchTextChanged();
+    void applySearchFilter();
     void onDeleteEntry();
     void onCopyUsername();
     void onCopyPassword();
@@ -48,8 +52,10 @@ private slots:
 
 private:
     // Core components
-    crimson::core::SecureVault* vault_;
-    std::string current_entry_id_;
+    crimson::core::AsyncVault* async_vault_;
+    crimson::core::SecureVault* vault_;   // Snapshot reads, which never wait on a save
+    crimson::core::EntryId current_entry_id_;
+    bool deleting_;   // A deletion is being written out
     
     // UI components
     QVBoxLayout* main_layout_;
@@ -59,7 +65,10 @@ private:
     // Entry list
     QGroupBox* list_group_;
     QVBoxLayout* list_layout_;
-    QListWidget* entry_list_;
+    QLineEdit* search_input_;
+    QTimer* search_timer_;
+    QListView* entry_list_;
+    VaultEntryListModel* entry_model_;
     QPushButton* refresh_btn_;
     QPushButton* delete_btn_;
     
@@ -108,10 +117,15 @@ private:
      */
     void loadEntries();
     
+    /**
+     * @brief Show the vault's entry count in the status line
+     */
+    void updateEntryCountStatus();
+    
     /**
      * @brief Display details for selected entry
      */
-    void displayEntryDetails(const std::string& entryId);
+    void displayEntryDetails(const crimson::core::EntryId& entryId);
     
     /**
      * @brief Clear entry details display
@@ -0,0 +1,300 @@
+#include "agent/AgentClient.h"
+#include "core/SecureMemory.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace crimson {
+namespace agent {
+
+using core::SecureMemory;
+using core::VaultEntry;
+using Status = AgentProtocol::Status;
+
+namespace {
+    Status readStatus(AgentProtocol::Reader& reader) {
+        auto status = static_cast<Status>(reader.u8());
+        if (status == Status::Error || status == Status::Locked) {
+            std::string message = reader.string();
+            throw std::runtime_error(status == Status::Locked ? "Agent vault is locked" : "Agent: " + message);
+        }
+        return status;
+    }
+
+#ifndef _WIN32
+    #ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+    #else
+    constexpr int SEND_FLAGS = 0;
+    #endif
+    
+    [[noreturn]] void throwConnectionError() {
+        throw std::runtime_error(std::string("Agent connection failed: ") + std::strerror(errno));
+    }
+#endif
+}
+
+#ifdef _WIN32
+
+AgentClient::AgentClient(const std::string&)
+    : fd_(-1)
+    , next_request_(1) {
+    throw std::runtime_error("The agent needs Unix domain sockets, which this platform build does not support");
+}
+
+AgentClient::~AgentClient() {
+}
+
+void AgentClient::flush() {
+}
+
+void AgentClient::fill(bool) {
+    throw std::runtime_error("Agent connection failed");
+}
+
+#else
+
+AgentClient::AgentClient(const std::string& socketPath)
+    : fd_(-1)
+    , next_request_(1) {
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Agent socket path is empty or too long: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    
+    fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ < 0 || ::connect(fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0) {
+        int saved = errno;
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+        throw std::runtime_error("No agent listening on " + socketPath + ": " + std::strerror(saved));
+    }
+    
+    output_.append(AgentProtocol::MAGIC, sizeof(AgentProtocol::MAGIC));
+}
+
+AgentClient::~AgentClient() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    SecureMemory::secureZero(output_);
+    SecureMemory::secureZero(input_);
+    for (auto& frame : pending_) {
+        SecureMemory::secureZero(frame.payload);
+    }
+}
+
+void AgentClient::flush() {
+    size_t sent = 0;
+    while (sent < output_.size()) {
+        struct pollfd descriptor = {fd_, POLLIN | POLLOUT, 0};
+        if (::poll(&descriptor, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwConnectionError();
+        }
+        if (descriptor.revents & POLLIN) {
+            fill(false);
+        }
+        if (descriptor.revents & (POLLOUT | POLLERR | POLLHUP)) {
+            ssize_t written = ::send(fd_, output_.data() + sent, output_.size() - sent, SEND_FLAGS | MSG_DONTWAIT);
+            if (written < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    continue;
+                }
+                throwConnectionError();
+            }
+            sent += static_cast<size_t>(written);
+        }
+    }
+    SecureMemory::secureZero(output_);
+    output_.clear();
+}
+
+void AgentClient::fill(bool wait) {
+    char buffer[65536];
+    for (;;) {
+        ssize_t received = ::recv(fd_, buffer, sizeof(buffer), wait ? 0 : MSG_DONTWAIT);
+        if (received > 0) {
+            input_.append(buffer, static_cast<size_t>(received));
+            SecureMemory::secureZero(buffer, static_cast<size_t>(received));
+            return;
+        }
+        if (received == 0) {
+            throw std::runtime_error("Agent closed the connection");
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (!wait && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+        throwConnectionError();
+    }
+}
+
+#endif
+
+std::string AgentClient::socketFromEnvironment() {
+    const char* socket = std::getenv("CRIMSON_AGENT_SOCK");
+    return socket ? socket : std::string();
+}
+
+uint32_t AgentClient::beginRequest(AgentProtocol::Opcode opcode, size_t& frameStart) {
+    uint32_t request = next_request_++;
+    frameStart = AgentProtocol::beginFrame(static_cast<uint8_t>(opcode), request, output_);
+    return request;
+}
+
+uint32_t AgentClient::queueGet(const std::vector<std::string>& keys) {
+    size_t start;
+    uint32_t request = beginRequest(AgentProtocol::Opcode::Get, start);
+    AgentProtocol::appendU32(static_cast<uint32_t>(keys.size()), output_);
+    for (const auto& key : keys) {
+        AgentProtocol::appendString(key, output_);
+    }
+    AgentProtocol::endFrame(start, output_);
+    return request;
+}
+
+uint32_t AgentClient::queuePut(const std::vector<PutItem>& items) {
+    size_t start;
+    uint32_t request = beginRequest(AgentProtocol::Opcode::Put, start);
+    AgentProtocol::appendU32(static_cast<uint32_t>(items.size()), output_);
+    for (const auto& item : items) {
+        AgentProtocol::appendString(item.key, output_);
+        AgentProtocol::appendString(item.username, output_);
+        AgentProtocol::appendString(item.password, output_);
+    }
+    AgentProtocol::endFrame(start, output_);
+    return request;
+}
+
+uint32_t AgentClient::queueList(const std::string& search, uint32_t limit, uint8_t order, bool descending) {
+    size_t start;
+    uint32_t request = beginRequest(AgentProtocol::Opcode::List, start);
+    AgentProtocol::appendString(search, output_);
+    AgentProtocol::appendU32(limit, output_);
+    AgentProtocol::appendU8(order, output_);
+    AgentProtocol::appendU8(descending ? 1 : 0, output_);
+    AgentProtocol::endFrame(start, output_);
+    return request;
+}
+
+uint32_t AgentClient::queueGenerate(uint32_t count, uint32_t length, bool symbols) {
+    size_t start;
+    uint32_t request = beginRequest(AgentProtocol::Opcode::Generate, start);
+    AgentProtocol::appendU32(count, output_);
+    AgentProtocol::appendU32(length, output_);
+    AgentProtocol::appendU8(symbols ? 1 : 0, output_);
+    AgentProtocol::endFrame(start, output_);
+    return request;
+}
+
+AgentProtocol::Frame AgentClient::receive() {
+    if (!pending_.empty()) {
+        AgentProtocol::Frame frame = std::move(pending_.front());
+        pending_.pop_front();
+        return frame;
+    }
+    return readFrame();
+}
+
+AgentProtocol::Frame AgentClient::readFrame() {
+    flush();
+    AgentProtocol::Frame frame;
+    size_t used;
+    while ((used = AgentProtocol::readFrame(input_, frame)) == 0) {
+        fill(true);
+    }
+    SecureMemory::secureZero(&input_[0], used);
+    input_.erase(0, used);
+    return frame;
+}
+
+AgentProtocol::Frame AgentClient::waitFor(uint32_t request) {
+    for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+        if (it->request == request) {
+            AgentProtocol::Frame frame = std::move(*it);
+            pending_.erase(it);
+            return frame;
+        }
+    }
+    
+    for (;;) {
+        AgentProtocol::Frame frame = readFrame();
+        if (frame.request == request) {
+            return frame;
+        }
+        pending_.push_back(std::move(frame));
+    }
+}
+
+std::vector<AgentClient::EntryResult> AgentClient::get(const std::vector<std::string>& keys) {
+    AgentProtocol::Frame frame = waitFor(queueGet(keys));
+    std::vector<EntryResult> results = readEntryResults(frame);
+    SecureMemory::secureZero(frame.payload);
+    return results;
+}
+
+std::vector<AgentClient::EntryResult> AgentClient::put(const std::vector<PutItem>& items) {
+    AgentProtocol::Frame frame = waitFor(queuePut(items));
+    std::vector<EntryResult> results = readEntryResults(frame);
+    SecureMemory::secureZero(frame.payload);
+    return results;
+}
+
+std::vector<VaultEntry> AgentClient::list(const std::string& search, uint32_t limit, uint8_t order, bool descending) {
+    uint32_t request = queueList(search, limit, order, descending);
+    std::vector<VaultEntry> entries;
+    while (readListChunk(waitFor(request), entries)) {
+    }
+    return entries;
+}
+
+std::vector<AgentClient::EntryResult> AgentClient::readEntryResults(const AgentProtocol::Frame& frame) {
+    AgentProtocol::Reader reader(frame.payload);
+    readStatus(reader);
+    
+    uint32_t count = reader.u32();
+    std::vector<EntryResult> results;
+    for (uint32_t i = 0; i < count; ++i) {
+        EntryResult result;
+        result.ok = static_cast<Status>(reader.u8()) == Status::Ok;
+        if (result.ok) {
+            reader.entry(result.entry);
+        } else {
+            result.error = reader.string();
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+
+bool AgentClient::readListChunk(const AgentProtocol::Frame& frame, std::vector<VaultEntry>& entries) {
+    AgentProtocol::Reader reader(frame.payload);
+    Status status = readStatus(reader);
+    
+    uint32_t count = reader.u32();
+    for (uint32_t i = 0; i < count; ++i) {
+        entries.emplace_back();
+        reader.entry(entries.back());
+    }
+    return status == Status::More;
+}
+
+} // namespace agent
+} // namespace crimson
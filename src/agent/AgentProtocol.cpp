@@ -0,0 +1,104 @@
+#include "agent/AgentProtocol.h"
+#include "core/EntryCodec.h"
+#include <limits>
+#include <stdexcept>
+
+namespace crimson {
+namespace agent {
+
+namespace {
+    uint32_t readU32(const char* data) {
+        uint32_t value = 0;
+        for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return value;
+    }
+}
+
+const char* AgentProtocol::Reader::take(size_t count) {
+    if (data_.size() - position_ < count) {
+        throw std::runtime_error("Truncated agent frame");
+    }
+    const char* start = data_.data() + position_;
+    position_ += count;
+    return start;
+}
+
+uint8_t AgentProtocol::Reader::u8() {
+    return static_cast<uint8_t>(*take(1));
+}
+
+uint32_t AgentProtocol::Reader::u32() {
+    return readU32(take(sizeof(uint32_t)));
+}
+
+std::string AgentProtocol::Reader::string() {
+    uint32_t length = u32();
+    return std::string(take(length), length);
+}
+
+void AgentProtocol::Reader::entry(core::VaultEntry& entry) {
+    position_ += core::EntryCodec::readBinary(data_.substr(position_), entry);
+}
+
+size_t AgentProtocol::beginFrame(uint8_t opcode, uint32_t request, std::string& out) {
+    size_t offset = out.size();
+    appendU32(0, out);   // Patched by endFrame()
+    appendU8(opcode, out);
+    appendU32(request, out);
+    return offset;
+}
+
+void AgentProtocol::endFrame(size_t offset, std::string& out) {
+    size_t length = out.size() - offset - sizeof(uint32_t);
+    if (length > MAX_FRAME_BYTES) {
+        throw std::length_error("Agent frame too large");
+    }
+    patchU32(offset, static_cast<uint32_t>(length), out);
+}
+
+size_t AgentProtocol::readFrame(std::string_view data, Frame& frame) {
+    if (data.size() < sizeof(uint32_t)) {
+        return 0;
+    }
+    uint32_t length = readU32(data.data());
+    if (length > MAX_FRAME_BYTES || length < HEADER_BYTES - sizeof(uint32_t)) {
+        throw std::runtime_error("Malformed agent frame length");
+    }
+    if (data.size() - sizeof(uint32_t) < length) {
+        return 0;
+    }
+    
+    frame.opcode = static_cast<uint8_t>(data[4]);
+    frame.request = readU32(data.data() + 5);
+    frame.payload.assign(data.data() + HEADER_BYTES, length - (HEADER_BYTES - sizeof(uint32_t)));
+    return sizeof(uint32_t) + length;
+}
+
+void AgentProtocol::appendU8(uint8_t value, std::string& out) {
+    out.push_back(static_cast<char>(value));
+}
+
+void AgentProtocol::appendU32(uint32_t value, std::string& out) {
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void AgentProtocol::patchU32(size_t offset, uint32_t value, std::string& out) {
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        out[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+void AgentProtocol::appendString(std::string_view text, std::string& out) {
+    if (text.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("String too long for an agent frame");
+    }
+    appendU32(static_cast<uint32_t>(text.size()), out);
+    out.append(text.data(), text.size());
+}
+
+} // namespace agent
+} // namespace crimson
@@ -0,0 +1,804 @@
+#include "agent/VaultAgent.h"
+#include "core/EntryCodec.h"
+#include "core/Metrics.h"
+#include "core/PasswordGenerator.h"
+#include "core/SecureMemory.h"
+#include "core/SecureVault.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+namespace crimson {
+namespace agent {
+
+using core::EntryCodec;
+using core::EntryId;
+using core::EntryView;
+using core::MetricsRegistry;
+using core::SecureMemory;
+using core::SecureVault;
+using core::VaultEntry;
+
+namespace {
+    constexpr size_t MAX_REQUEST_BYTES = 1 << 20;   // Longest accepted request line
+    constexpr size_t MAX_CLIENTS = 64;
+    constexpr size_t MAX_GENERATE_COUNT = 1000;
+    constexpr size_t MAX_GENERATE_LENGTH = 4096;
+    constexpr size_t MAX_LIST_LIMIT = size_t(1) << 30;
+    constexpr size_t MAX_PENDING_OUTPUT = 8 << 20;  // Stop reading a client that is not draining replies
+    constexpr size_t STREAM_LOW_WATER = 64 << 10;   // Refill List streams below this much queued output
+    constexpr int POLL_INTERVAL_MS = 1000;          // Auto-lock check granularity
+    
+    size_t positiveInteger(const QJsonObject& request, const char* name, size_t fallback, size_t maximum) {
+        QJsonValue value = request.value(name);
+        if (value.isUndefined()) {
+            return fallback;
+        }
+        double number = value.toDouble(-1);
+        if (number < 1 || number > static_cast<double>(maximum) || std::floor(number) != number) {
+            throw std::invalid_argument(std::string(name) + " must be an integer from 1 to " +
+                                        std::to_string(maximum));
+        }
+        return static_cast<size_t>(number);
+    }
+    
+    std::string stringField(const QJsonObject& request, const char* name) {
+        return request.value(name).toString().toStdString();
+    }
+    
+    struct LockedError : std::runtime_error {
+        LockedError() : std::runtime_error("locked") {}
+    };
+    
+    void requireOpen(const SecureVault& vault) {
+        if (!vault.isOpen()) {
+            throw LockedError();
+        }
+    }
+    
+    /**
+     * @brief Entry IDs for a list request; limit 0 means every entry
+     */
+    std::vector<EntryId> listIds(const SecureVault& vault, const std::string& search, size_t limit,
+                                 SecureVault::EntryOrder order, bool descending) {
+        limit = limit == 0 ? vault.getEntryCount() : std::min(limit, vault.getEntryCount());
+        
+        std::vector<EntryId> ids;
+        if (limit == 0) {
+            return ids;
+        }
+        if (!search.empty()) {
+            for (const auto& match : vault.search(search, limit)) {
+                ids.push_back(match.first);
+            }
+            return ids;
+        }
+        
+        ids.reserve(limit);
+        SecureVault::EntryPage page;
+        do {
+            page = vault.listEntries(order, page.nextCursor, std::min<size_t>(limit - ids.size(), 1000), descending);
+            for (const auto& row : page.entries) {
+                ids.push_back(row.first);
+            }
+        } while (!page.nextCursor.empty() && ids.size() < limit);
+        return ids;
+    }
+    
+    VaultEntry summaryOf(const EntryView& view) {
+        VaultEntry entry;
+        entry.id = view.id;
+        entry.label.assign(view.label);
+        entry.username.assign(view.username);
+        entry.created_at = view.created_at;
+        entry.last_used_at = view.last_used_at;
+        entry.device_fingerprint.assign(view.device_fingerprint);
+        return entry;
+    }
+    
+    void checkGenerateRequest(size_t count, size_t length) {
+        if (count < 1 || count > MAX_GENERATE_COUNT || length < 1 || length > MAX_GENERATE_LENGTH) {
+            throw std::invalid_argument("Generate needs a count from 1 to " + std::to_string(MAX_GENERATE_COUNT) +
+                                        " and a length from 1 to " + std::to_string(MAX_GENERATE_LENGTH));
+        }
+    }
+
+#ifndef _WIN32
+    bool setNonBlocking(int fd) {
+        int flags = ::fcntl(fd, F_GETFL);
+        return flags >= 0 &&
+               ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0 &&
+               ::fcntl(fd, F_SETFD, FD_CLOEXEC) == 0;
+    }
+    
+    [[noreturn]] void throwSystemError(const std::string& what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+    
+    #ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+    #else
+    constexpr int SEND_FLAGS = 0;   // The caller ignores SIGPIPE
+    #endif
+#endif
+}
+
+VaultAgent::VaultAgent(SecureVault& vault, const std::string& vaultPath, const std::string& socketPath)
+    : vault_(vault)
+    , vault_path_(vaultPath)
+    , socket_path_(socketPath)
+    , listen_fd_(-1)
+    , wake_fds_{-1, -1}
+    , password_generator_(std::make_unique<core::PasswordGenerator>()) {
+}
+
+VaultAgent::~VaultAgent() {
+    closeSocket();
+}
+
+void VaultAgent::handleRequest(const std::string& line, std::string& out) {
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromRawData(line.data(), static_cast<int>(line.size())),
+                                                &error);
+    QJsonObject request = doc.object();
+    
+    // Echo the caller's request ID so responses can be matched up
+    out += '{';
+    QJsonValue requestId = request.value("id");
+    if (requestId.isDouble()) {
+        out += "\"id\": " + std::to_string(static_cast<long long>(requestId.toDouble())) + ", ";
+    } else if (requestId.isString()) {
+        out += "\"id\": ";
+        EntryCodec::appendJsonString(requestId.toString().toStdString(), out);
+        out += ", ";
+    }
+    
+    std::string body;   // Response fields after "ok"
+    try {
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            throw std::invalid_argument("Request must be a JSON object");
+        }
+        
+        const std::string op = stringField(request, "op");
+        if (op == "get") {
+            requireOpen(vault_);
+            vault_.updateActivity();
+            EntryId id = vault_.resolveEntry(stringField(request, "entry"));
+            std::string password = vault_.getPassword(id);
+            body += ", \"entry\": ";
+            EntryCodec::appendSummaryJson(vault_.getEntryView(id), &password, body);
+            SecureMemory::secureZero(password);
+            
+        } else if (op == "list") {
+            requireOpen(vault_);
+            vault_.updateActivity();
+            std::string search = stringField(request, "search");
+            std::vector<EntryId> ids = listIds(vault_, search,
+                                               positiveInteger(request, "limit", 0, MAX_LIST_LIMIT),
+                                               SecureVault::EntryOrder::Label, false);
+            
+            body += ", \"entries\": [";
+            for (size_t i = 0; i < ids.size(); ++i) {
+                body += i == 0 ? "" : ", ";
+                EntryCodec::appendSummaryJson(vault_.getEntryView(ids[i]), nullptr, body);
+            }
+            body += ']';
+            
+        } else if (op == "generate") {
+            size_t length = positiveInteger(request, "length", 32, MAX_GENERATE_LENGTH);
+            size_t count = positiveInteger(request, "count", 1, MAX_GENERATE_COUNT);
+            bool symbols = request.value("symbols").toBool(true);
+            
+            body += ", \"passwords\": [";
+            for (size_t i = 0; i < count; ++i) {
+                std::string password = password_generator_->generatePassword(length, symbols);
+                body += i == 0 ? "" : ", ";
+                EntryCodec::appendJsonString(password, body);
+                SecureMemory::secureZero(password);
+            }
+            body += ']';
+            
+        } else if (op == "status") {
+            body += vault_.isOpen() ? ", \"open\": true" : ", \"open\": false";
+            body += ", \"entries\": " + std::to_string(vault_.isOpen() ? vault_.getEntryCount() : 0);
+            
+        } else if (op == "lock") {
+            vault_.closeVault();
+            
+        } else if (op == "unlock") {
+            if (!vault_.isOpen()) {
+                std::string password = stringField(request, "password");
+                bool opened = vault_.openVault(password, vault_path_);
+                SecureMemory::secureZero(password);
+                if (!opened) {
+                    throw std::runtime_error("Cannot open vault (wrong password or unreadable file)");
+                }
+            }
+            
+        } else if (op == "metrics") {
+            const std::string format = stringField(request, "format");
+            if (format == "prometheus") {
+                body += ", \"prometheus\": ";
+                EntryCodec::appendJsonString(MetricsRegistry::global().toPrometheus(), body);
+            } else if (format.empty() || format == "json") {
+                body += ", \"metrics\": " + MetricsRegistry::global().toJson();
+            } else {
+                throw std::invalid_argument("Unknown metrics format: " + format);
+            }
+            
+        } else {
+            throw std::invalid_argument("Unknown op: " + op);
+        }
+        
+        out += "\"ok\": true";
+        out += body;
+        
+    } catch (const std::exception& e) {
+        out += "\"ok\": false, \"error\": ";
+        EntryCodec::appendJsonString(e.what(), out);
+    }
+    
+    out += "}\n";
+    SecureMemory::secureZero(body);
+}
+
+bool VaultAgent::processInput(Client& client) {
+    if (client.mode == Client::Mode::Unknown) {
+        const size_t magicBytes = sizeof(AgentProtocol::MAGIC);
+        if (client.input[0] != AgentProtocol::MAGIC[0]) {
+            client.mode = Client::Mode::Json;
+        } else if (client.input.size() < magicBytes) {
+            return true;
+        } else if (client.input.compare(0, magicBytes, AgentProtocol::MAGIC, magicBytes) == 0) {
+            client.mode = Client::Mode::Binary;
+            client.input.erase(0, magicBytes);
+        } else {
+            return false;
+        }
+    }
+    
+    size_t start = 0;
+    bool valid = true;
+    if (client.mode == Client::Mode::Binary) {
+        AgentProtocol::Frame frame;
+        try {
+            size_t used;
+            while ((used = AgentProtocol::readFrame(std::string_view(client.input).substr(start), frame)) > 0) {
+                handleFrame(frame, client);
+                SecureMemory::secureZero(frame.payload);
+                start += used;
+            }
+        } catch (const std::runtime_error&) {
+            valid = false;   // Bad framing cannot be resynchronized
+        }
+        SecureMemory::secureZero(frame.payload);
+    } else {
+        size_t newline;
+        while ((newline = client.input.find('\n', start)) != std::string::npos) {
+            std::string line = client.input.substr(start, newline - start);
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            if (!line.empty()) {
+                handleRequest(line, client.output);
+            }
+            SecureMemory::secureZero(line);
+            start = newline + 1;
+        }
+        valid = client.input.size() - start <= MAX_REQUEST_BYTES;
+    }
+    
+    SecureMemory::secureZero(&client.input[0], start);
+    client.input.erase(0, start);
+    return valid;
+}
+
+void VaultAgent::handleFrame(const AgentProtocol::Frame& frame, Client& client) {
+    using Opcode = AgentProtocol::Opcode;
+    using Status = AgentProtocol::Status;
+    
+    std::string& out = client.output;
+    size_t start = AgentProtocol::beginFrame(frame.opcode | AgentProtocol::RESPONSE_FLAG, frame.request, out);
+    size_t payload = out.size();
+    
+    try {
+        AgentProtocol::Reader reader(frame.payload);
+        switch (static_cast<Opcode>(frame.opcode)) {
+        case Opcode::Get: {
+            requireOpen(vault_);
+            vault_.updateActivity();
+            uint32_t count = reader.u32();
+            AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+            AgentProtocol::appendU32(count, out);
+            for (uint32_t i = 0; i < count; ++i) {
+                std::string key = reader.string();
+                try {
+                    EntryId id = vault_.resolveEntry(key);
+                    std::string password = vault_.getPassword(id);
+                    VaultEntry entry = summaryOf(vault_.getEntryView(id));
+                    entry.password = std::move(password);
+                    AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+                    EntryCodec::appendBinary(entry, out);
+                    SecureMemory::secureZero(entry.password);
+                } catch (const std::exception& e) {
+                    AgentProtocol::appendU8(static_cast<uint8_t>(Status::Error), out);
+                    AgentProtocol::appendString(e.what(), out);
+                }
+            }
+            break;
+        }
+        
+        case Opcode::Put: {
+            requireOpen(vault_);
+            uint32_t count = reader.u32();
+            
+            // Resolve every item first so the whole batch is one saveEntries()
+            std::vector<VaultEntry> entries;
+            std::vector<std::string> errors;
+            for (uint32_t i = 0; i < count; ++i) {
+                std::string key = reader.string();
+                std::string username = reader.string();
+                std::string password = reader.string();
+                try {
+                    VaultEntry entry;
+                    EntryId id;
+                    if (EntryId::parse(key, id)) {
+                        entry = vault_.getEntry(id);
+                        entry.password = password.empty() ? vault_.getPassword(id) : password;
+                    } else {
+                        entry = vault_.createEntry(key);
+                        if (!password.empty()) {
+                            SecureMemory::secureZero(entry.password);
+                            entry.password = password;
+                        }
+                    }
+                    if (!username.empty()) {
+                        entry.username = username;
+                    }
+                    entries.push_back(std::move(entry));
+                    errors.emplace_back();
+                } catch (const std::exception& e) {
+                    errors.emplace_back(e.what());
+                }
+                SecureMemory::secureZero(password);
+            }
+            
+            bool saved = entries.empty() || vault_.saveEntries(entries);
+            if (saved) {
+                AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+                AgentProtocol::appendU32(count, out);
+                size_t next = 0;
+                for (const auto& error : errors) {
+                    if (error.empty()) {
+                        AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+                        EntryCodec::appendBinary(entries[next++], out);
+                    } else {
+                        AgentProtocol::appendU8(static_cast<uint8_t>(Status::Error), out);
+                        AgentProtocol::appendString(error, out);
+                    }
+                }
+            }
+            for (auto& entry : entries) {
+                SecureMemory::secureZero(entry.password);
+            }
+            if (!saved) {
+                throw std::runtime_error("Failed to save entries");
+            }
+            break;
+        }
+        
+        case Opcode::List: {
+            requireOpen(vault_);
+            vault_.updateActivity();
+            std::string search = reader.string();
+            uint32_t limit = reader.u32();
+            uint8_t order = reader.u8();
+            bool descending = reader.u8() != 0;
+            if (order > static_cast<uint8_t>(SecureVault::EntryOrder::LastUsed)) {
+                throw std::invalid_argument("Unknown list order");
+            }
+            
+            // Answered by pumpStreams() as the client drains its output
+            client.streams.push_back(ListStream{frame.request,
+                                                listIds(vault_, search, limit,
+                                                        static_cast<SecureVault::EntryOrder>(order), descending),
+                                                0});
+            out.resize(start);
+            return;
+        }
+        
+        case Opcode::Generate: {
+            uint32_t count = reader.u32();
+            uint32_t length = reader.u32();
+            bool symbols = reader.u8() != 0;
+            checkGenerateRequest(count, length);
+            AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+            AgentProtocol::appendU32(count, out);
+            for (uint32_t i = 0; i < count; ++i) {
+                std::string password = password_generator_->generatePassword(length, symbols);
+                AgentProtocol::appendString(password, out);
+                SecureMemory::secureZero(password);
+            }
+            break;
+        }
+        
+        case Opcode::Status:
+            AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+            AgentProtocol::appendU8(vault_.isOpen() ? 1 : 0, out);
+            AgentProtocol::appendU32(static_cast<uint32_t>(vault_.isOpen() ? vault_.getEntryCount() : 0), out);
+            break;
+        
+        case Opcode::Lock:
+            vault_.closeVault();
+            AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+            break;
+        
+        case Opcode::Unlock: {
+            std::string password = reader.string();
+            bool opened = vault_.isOpen() || vault_.openVault(password, vault_path_);
+            SecureMemory::secureZero(password);
+            if (!opened) {
+                throw std::runtime_error("Cannot open vault (wrong password or unreadable file)");
+            }
+            AgentProtocol::appendU8(static_cast<uint8_t>(Status::Ok), out);
+            break;
+        }
+        
+        default:
+            throw std::invalid_argument("Unknown opcode " + std::to_string(frame.opcode));
+        }
+        
+    } catch (const std::exception& e) {
+        // Drop any partial payload, secrets included, and report the failure
+        SecureMemory::secureZero(&out[payload], out.size() - payload);
+        out.resize(payload);
+        bool locked = dynamic_cast<const LockedError*>(&e) != nullptr;
+        AgentProtocol::appendU8(static_cast<uint8_t>(locked ? Status::Locked : Status::Error), out);
+        AgentProtocol::appendString(e.what(), out);
+    }
+    
+    if (out.size() - start - sizeof(uint32_t) > AgentProtocol::MAX_FRAME_BYTES) {
+        SecureMemory::secureZero(&out[payload], out.size() - payload);
+        out.resize(payload);
+        AgentProtocol::appendU8(static_cast<uint8_t>(Status::Error), out);
+        AgentProtocol::appendString("Response too large; split the batch", out);
+    }
+    AgentProtocol::endFrame(start, out);
+}
+
+void VaultAgent::pumpStreams(Client& client) {
+    using Status = AgentProtocol::Status;
+    
+    std::string& out = client.output;
+    while (!client.streams.empty() && out.size() < STREAM_LOW_WATER) {
+        ListStream& stream = client.streams.front();
+        size_t start = AgentProtocol::beginFrame(static_cast<uint8_t>(AgentProtocol::Opcode::List) |
+                                                 AgentProtocol::RESPONSE_FLAG, stream.request, out);
+        
+        // Locked part-way through: end the stream
+        if (!vault_.isOpen()) {
+            AgentProtocol::appendU8(static_cast<uint8_t>(Status::Locked), out);
+            AgentProtocol::appendString("locked", out);
+            AgentProtocol::endFrame(start, out);
+            client.streams.pop_front();
+            continue;
+        }
+        
+        size_t end = std::min(stream.next + AgentProtocol::LIST_CHUNK_ENTRIES, stream.ids.size());
+        AgentProtocol::appendU8(static_cast<uint8_t>(end == stream.ids.size() ? Status::Ok : Status::More), out);
+        size_t countOffset = out.size();
+        AgentProtocol::appendU32(0, out);
+        
+        uint32_t count = 0;
+        for (; stream.next < end; ++stream.next) {
+            VaultEntry entry;
+            try {
+                entry = summaryOf(vault_.getEntryView(stream.ids[stream.next]));
+            } catch (const std::runtime_error&) {
+                continue;   // Deleted since the list was taken
+            }
+            EntryCodec::appendBinary(entry, out);
+            ++count;
+        }
+        AgentProtocol::patchU32(countOffset, count, out);
+        AgentProtocol::endFrame(start, out);
+        
+        if (stream.next == stream.ids.size()) {
+            client.streams.pop_front();
+        }
+    }
+}
+
+#ifdef _WIN32
+
+void VaultAgent::run() {
+    throw std::runtime_error("The agent needs Unix domain sockets, which this platform build does not support");
+}
+
+void VaultAgent::stop() {
+}
+
+std::string VaultAgent::defaultSocketPath() {
+    return std::string();
+}
+
+void VaultAgent::openSocket() {
+}
+
+void VaultAgent::closeSocket() {
+}
+
+void VaultAgent::acceptClients() {
+}
+
+bool VaultAgent::readClient(Client&) {
+    return false;
+}
+
+bool VaultAgent::writeClient(Client&) {
+    return false;
+}
+
+bool VaultAgent::peerAllowed(int) const {
+    return false;
+}
+
+#else
+
+void VaultAgent::run() {
+    openSocket();
+    
+    std::vector<struct pollfd> fds;
+    for (;;) {
+        fds.clear();
+        fds.push_back({wake_fds_[0], POLLIN, 0});
+        fds.push_back({listen_fd_, static_cast<short>(clients_.size() < MAX_CLIENTS ? POLLIN : 0), 0});
+        for (const auto& client : clients_) {
+            short events = client.output.size() < MAX_PENDING_OUTPUT ? POLLIN : 0;
+            if (!client.output.empty() || !client.streams.empty()) {
+                events |= POLLOUT;
+            }
+            fds.push_back({client.fd, events, 0});
+        }
+        
+        int ready = ::poll(fds.data(), static_cast<nfds_t>(fds.size()), POLL_INTERVAL_MS);
+        if (ready < 0 && errno != EINTR) {
+            closeSocket();
+            throwSystemError("Agent poll failed");
+        }
+        
+        if (vault_.shouldAutoLock()) {
+            vault_.closeVault();
+        }
+        if (ready <= 0) {
+            continue;
+        }
+        if (fds[0].revents) {
+            break;
+        }
+        
+        // Clients first: accepting appends to clients_ past the polled range
+        size_t polled = fds.size() - 2;
+        for (size_t i = polled; i-- > 0;) {
+            short events = fds[i + 2].revents;
+            Client& client = clients_[i];
+            bool keep = true;
+            if (events & (POLLIN | POLLHUP | POLLERR)) {
+                keep = readClient(client);
+            }
+            if (keep) {
+                pumpStreams(client);
+                keep = client.output.empty() || writeClient(client);
+            }
+            if (!keep) {
+                ::close(client.fd);
+                SecureMemory::secureZero(client.input);
+                SecureMemory::secureZero(client.output);
+                clients_.erase(clients_.begin() + static_cast<std::ptrdiff_t>(i));
+            }
+        }
+        
+        if (fds[1].revents & POLLIN) {
+            acceptClients();
+        }
+    }
+    
+    closeSocket();
+}
+
+void VaultAgent::stop() {
+    // Only write(2): this runs in signal handlers
+    if (wake_fds_[1] >= 0) {
+        char byte = 0;
+        ssize_t written = ::write(wake_fds_[1], &byte, 1);
+        (void)written;
+    }
+}
+
+std::string VaultAgent::defaultSocketPath() {
+    const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+    if (runtimeDir && *runtimeDir) {
+        return std::string(runtimeDir) + "/crimson-agent.sock";
+    }
+    return "/tmp/crimson-agent-" + std::to_string(::geteuid()) + "/agent.sock";
+}
+
+void VaultAgent::openSocket() {
+    if (::pipe(wake_fds_) != 0 || !setNonBlocking(wake_fds_[0]) || !setNonBlocking(wake_fds_[1])) {
+        throwSystemError("Cannot create agent wake-up pipe");
+    }
+    
+    struct sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path_.empty() || socket_path_.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Agent socket path is empty or too long: " + socket_path_);
+    }
+    std::memcpy(address.sun_path, socket_path_.c_str(), socket_path_.size() + 1);
+    
+    // The directory must be ours and closed to others, or someone else
+    // could swap the socket; the default directory is created on demand
+    std::string directory = socket_path_.substr(0, socket_path_.find_last_of('/') + 1);
+    if (directory.empty()) {
+        directory = ".";
+    }
+    struct stat info;
+    if (::lstat(directory.c_str(), &info) != 0) {
+        if (errno != ENOENT || ::mkdir(directory.c_str(), 0700) != 0 || ::lstat(directory.c_str(), &info) != 0) {
+            throwSystemError("Cannot create agent socket directory " + directory);
+        }
+    }
+    if (!S_ISDIR(info.st_mode) || info.st_uid != ::geteuid() || (info.st_mode & 022) != 0) {
+        throw std::runtime_error("Agent socket directory " + directory +
+                                 " must be owned by this user and not writable by others");
+    }
+    
+    // A leftover socket is reused only if no agent answers on it
+    if (::lstat(socket_path_.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            throw std::runtime_error(socket_path_ + " exists and is not a socket");
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0 &&
+                    ::connect(probe, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0;
+        if (probe >= 0) {
+            ::close(probe);
+        }
+        if (live) {
+            throw std::runtime_error("An agent is already listening on " + socket_path_);
+        }
+        ::unlink(socket_path_.c_str());
+    }
+    
+    listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0 || !setNonBlocking(listen_fd_)) {
+        throwSystemError("Cannot create agent socket");
+    }
+    
+    // Owner-only from the moment it exists
+    mode_t savedMask = ::umask(0177);
+    int bound = ::bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&address), sizeof(address));
+    ::umask(savedMask);
+    if (bound != 0) {
+        int saved = errno;
+        ::close(listen_fd_);
+        listen_fd_ = -1;   // Not ours to unlink
+        errno = saved;
+        throwSystemError("Cannot bind agent socket " + socket_path_);
+    }
+    if (::chmod(socket_path_.c_str(), 0600) != 0 || ::listen(listen_fd_, 16) != 0) {
+        int saved = errno;
+        ::unlink(socket_path_.c_str());
+        errno = saved;
+        throwSystemError("Cannot listen on agent socket " + socket_path_);
+    }
+}
+
+void VaultAgent::closeSocket() {
+    for (auto& client : clients_) {
+        ::close(client.fd);
+        SecureMemory::secureZero(client.input);
+        SecureMemory::secureZero(client.output);
+    }
+    clients_.clear();
+    
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        ::unlink(socket_path_.c_str());
+        listen_fd_ = -1;
+    }
+    for (int& fd : wake_fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+}
+
+void VaultAgent::acceptClients() {
+    while (clients_.size() < MAX_CLIENTS) {
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) {
+            return;   // EAGAIN once the backlog is drained
+        }
+        if (!setNonBlocking(fd) || !peerAllowed(fd)) {
+            ::close(fd);
+            continue;
+        }
+        clients_.emplace_back(fd);
+    }
+}
+
+bool VaultAgent::readClient(Client& client) {
+    char buffer[16384];
+    bool alive = true;
+    while (client.output.size() < MAX_PENDING_OUTPUT) {
+        ssize_t received = ::recv(client.fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) {
+            alive = received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+            break;
+        }
+        client.input.append(buffer, static_cast<size_t>(received));
+        if (!processInput(client)) {
+            alive = false;
+            break;
+        }
+    }
+    SecureMemory::secureZero(buffer, sizeof(buffer));
+    return alive;
+}
+
+bool VaultAgent::writeClient(Client& client) {
+    size_t sent = 0;
+    bool alive = true;
+    while (sent < client.output.size()) {
+        ssize_t written = ::send(client.fd, client.output.data() + sent, client.output.size() - sent, SEND_FLAGS);
+        if (written < 0) {
+            alive = errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    SecureMemory::secureZero(&client.output[0], sent);
+    client.output.erase(0, sent);
+    return alive;
+}
+
+bool VaultAgent::peerAllowed(int fd) const {
+#ifdef __linux__
+    struct ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0) {
+        return false;
+    }
+    return credentials.uid == ::geteuid();
+#else
+    uid_t uid;
+    gid_t gid;
+    if (::getpeereid(fd, &uid, &gid) != 0) {
+        return false;
+    }
+    return uid == ::geteuid();
+#endif
+}
+
+#endif
+
+} // namespace agent
+} // namespace crimson
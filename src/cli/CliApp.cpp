@@ -0,0 +1,644 @@
+#include "cli/CliApp.h"
+#include "agent/AgentClient.h"
+#include "agent/VaultAgent.h"
+#include "core/EntryCodec.h"
+#include "core/PasswordGenerator.h"
+#include "core/SecureMemory.h"
+#include "core/SecureVault.h"
+#include "core/Trace.h"
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <termios.h>
+    #include <unistd.h>
+#endif
+
+namespace crimson {
+namespace cli {
+
+using agent::AgentClient;
+using core::EntryCodec;
+using core::EntryId;
+using core::SecureMemory;
+using core::SecureVault;
+using core::Trace;
+using core::VaultEntry;
+
+namespace {
+    // Options that take a value; everything else starting with "--" is a flag
+    const char* const VALUE_OPTIONS[] = {
+        "--vault", "--username", "--order", "--limit", "--search", "--length", "--count",
+        "--socket", "--timeout"
+    };
+    
+    bool takesValue(const std::string& arg) {
+        return std::find(std::begin(VALUE_OPTIONS), std::end(VALUE_OPTIONS), arg) != std::end(VALUE_OPTIONS);
+    }
+    
+    size_t parseCount(const std::string& text, const char* name) {
+        try {
+            size_t used = 0;
+            unsigned long long value = std::stoull(text, &used);
+            if (used == text.size() && value > 0) {
+                return static_cast<size_t>(value);
+            }
+        } catch (const std::exception&) {
+        }
+        throw std::invalid_argument(std::string(name) + " must be a positive integer");
+    }
+    
+    agent::VaultAgent* running_agent = nullptr;
+    
+    void stopAgent(int) {
+        if (running_agent) {
+            running_agent->stop();
+        }
+    }
+    
+    core::EntryView viewOf(const VaultEntry& entry) {
+        return core::EntryView{entry.id, entry.label, entry.username,
+                               entry.created_at, entry.last_used_at, entry.device_fingerprint, nullptr};
+    }
+    
+    SecureVault::EntryOrder parseOrder(const std::string& order) {
+        if (order.empty() || order == "label") {
+            return SecureVault::EntryOrder::Label;
+        } else if (order == "created") {
+            return SecureVault::EntryOrder::CreatedAt;
+        } else if (order == "last-used") {
+            return SecureVault::EntryOrder::LastUsed;
+        }
+        throw std::invalid_argument("--order must be label, created or last-used");
+    }
+    
+    void writeOutput(std::string& out) {
+        out += '\n';
+        std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+        std::cout.flush();
+        SecureMemory::secureZero(out);
+    }
+}
+
+CliApp::CliApp() {
+}
+
+CliApp::~CliApp() {
+}
+
+int CliApp::run(const std::vector<std::string>& args) {
+    const char* envVault = std::getenv("CRIMSON_VAULT");
+    vault_path_ = envVault ? envVault : "vault.gpg";
+    
+    // Global options come before the command
+    size_t pos = 0;
+    while (pos < args.size() && args[pos] == "--vault") {
+        if (pos + 1 >= args.size()) {
+            return usage("--vault needs a path");
+        }
+        vault_path_ = args[pos + 1];
+        pos += 2;
+    }
+    if (pos >= args.size()) {
+        return usage();
+    }
+    
+    const std::string command = args[pos];
+    args_.assign(args.begin() + static_cast<std::ptrdiff_t>(pos) + 1, args.end());
+    
+    // CRIMSON_TRACE=<file> records trace spans and writes them there at the end
+    const char* envTrace = std::getenv("CRIMSON_TRACE");
+    const bool tracing = envTrace && *envTrace;
+    if (tracing) {
+        Trace::setEnabled(true);
+    }
+    
+    int status = dispatch(command);
+    if (tracing && !Trace::writeFile(envTrace)) {
+        writeError(std::string("Cannot write trace to ") + envTrace);
+    }
+    return status;
+}
+
+int CliApp::dispatch(const std::string& command) {
+    try {
+        if (command == "list") {
+            return list();
+        } else if (command == "get") {
+            return get();
+        } else if (command == "put") {
+            return put();
+        } else if (command == "delete") {
+            return remove();
+        } else if (command == "import") {
+            return importEntries();
+        } else if (command == "export") {
+            return exportEntries();
+        } else if (command == "generate") {
+            return generate();
+        } else if (command == "agent") {
+            return agent();
+        } else if (command == "help" || command == "--help") {
+            return usage();
+        }
+        return usage("Unknown command: " + command);
+        
+    } catch (const std::invalid_argument& e) {
+        return usage(e.what());
+    } catch (const std::exception& e) {
+        writeError(e.what());
+        return Failure;
+    }
+}
+
+int CliApp::list() {
+    SecureVault::EntryOrder order = parseOrder(option("--order"));
+    std::string search = option("--search");
+    std::string limitText = option("--limit");
+    size_t limit = limitText.empty() ? 0 : parseCount(limitText, "--limit");
+    
+    std::string socket = AgentClient::socketFromEnvironment();
+    if (!socket.empty()) {
+        AgentClient client(socket);
+        uint32_t agentLimit = static_cast<uint32_t>(std::min<size_t>(limit, std::numeric_limits<uint32_t>::max()));
+        std::vector<VaultEntry> entries = client.list(search, agentLimit, static_cast<uint8_t>(order), flag("--desc"));
+        std::string out = "[";
+        for (size_t i = 0; i < entries.size(); ++i) {
+            out += i == 0 ? "\n  " : ",\n  ";
+            EntryCodec::appendSummaryJson(viewOf(entries[i]), nullptr, out);
+        }
+        out += entries.empty() ? "]" : "\n]";
+        writeOutput(out);
+        return Success;
+    }
+    
+    SecureVault vault;
+    openVault(vault);
+    if (limit == 0) {
+        limit = vault.getEntryCount();
+    }
+    
+    std::vector<EntryId> ids;
+    if (!search.empty()) {
+        for (const auto& match : vault.search(search, limit)) {
+            ids.push_back(match.first);
+        }
+    } else {
+        SecureVault::EntryPage page;
+        do {
+            page = vault.listEntries(order, page.nextCursor, std::min<size_t>(limit - ids.size(), 1000),
+                                     flag("--desc"));
+            for (const auto& row : page.entries) {
+                ids.push_back(row.first);
+            }
+        } while (!page.nextCursor.empty() && ids.size() < limit);
+    }
+    
+    std::string out = "[";
+    for (size_t i = 0; i < ids.size(); ++i) {
+        out += i == 0 ? "\n  " : ",\n  ";
+        EntryCodec::appendSummaryJson(vault.getEntryView(ids[i]), nullptr, out);
+    }
+    out += ids.empty() ? "]" : "\n]";
+    writeOutput(out);
+    return Success;
+}
+
+int CliApp::get() {
+    std::vector<std::string> keys = positional();
+    if (keys.empty()) {
+        return usage("get needs at least one entry ID or label");
+    }
+    
+    std::vector<AgentClient::EntryResult> results;
+    std::string socket = AgentClient::socketFromEnvironment();
+    if (!socket.empty()) {
+        // One batched request however many keys are given
+        AgentClient client(socket);
+        results = client.get(keys);
+        if (results.size() != keys.size()) {
+            throw std::runtime_error("Malformed response from the agent");
+        }
+    } else {
+        SecureVault vault;
+        openVault(vault);
+        for (const auto& key : keys) {
+            AgentClient::EntryResult result;
+            try {
+                EntryId id = vault.resolveEntry(key);
+                std::string password = vault.getPassword(id);
+                result.entry = vault.getEntry(id);
+                result.entry.password = std::move(password);
+                result.ok = true;
+            } catch (const std::exception& e) {
+                result.error = e.what();
+            }
+            results.push_back(std::move(result));
+        }
+    }
+    
+    if (keys.size() == 1 && !results[0].ok) {
+        throw std::runtime_error(results[0].error);
+    }
+    
+    // Several keys print an array, with an error object for each miss
+    bool several = keys.size() > 1;
+    bool failed = false;
+    std::string out = several ? "[" : "";
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (several) {
+            out += i == 0 ? "\n  " : ",\n  ";
+        }
+        if (results[i].ok) {
+            EntryCodec::appendSummaryJson(viewOf(results[i].entry), &results[i].entry.password, out);
+            SecureMemory::secureZero(results[i].entry.password);
+        } else {
+            out += "{\"key\": ";
+            EntryCodec::appendJsonString(keys[i], out);
+            out += ", \"error\": ";
+            EntryCodec::appendJsonString(results[i].error, out);
+            out += '}';
+            failed = true;
+        }
+    }
+    if (several) {
+        out += "\n]";
+    }
+    writeOutput(out);
+    return failed ? Failure : Success;
+}
+
+int CliApp::put() {
+    std::vector<std::string> keys = positional();
+    if (keys.size() != 1) {
+        return usage("put needs one label, or the ID of an entry to update");
+    }
+    
+    std::string socket = AgentClient::socketFromEnvironment();
+    if (!socket.empty()) {
+        AgentClient::PutItem item;
+        item.key = keys[0];
+        item.username = option("--username");
+        if (flag("--password-stdin")) {
+            item.password = readSecretLine("Entry password: ");
+            if (item.password.empty()) {
+                throw std::runtime_error("Empty entry password");
+            }
+        }
+        
+        AgentClient client(socket);
+        std::vector<AgentClient::EntryResult> results = client.put({item});
+        SecureMemory::secureZero(item.password);
+        if (results.size() != 1) {
+            throw std::runtime_error("Malformed response from the agent");
+        }
+        if (!results[0].ok) {
+            throw std::runtime_error(results[0].error);
+        }
+        
+        std::string out;
+        EntryCodec::appendSummaryJson(viewOf(results[0].entry), &results[0].entry.password, out);
+        SecureMemory::secureZero(results[0].entry.password);
+        writeOutput(out);
+        return Success;
+    }
+    
+    SecureVault vault;
+    openVault(vault);
+    
+    // An entry ID updates that entry; a label creates a new entry with
+    // generated credentials
+    VaultEntry entry;
+    std::string password;
+    EntryId id;
+    if (EntryId::parse(keys[0], id)) {
+        entry = vault.getEntry(id);
+        password = vault.getPassword(id);
+    } else {
+        entry = vault.createEntry(keys[0]);
+        password = entry.password;
+    }
+    
+    std::string username = option("--username");
+    if (!username.empty()) {
+        entry.username = username;
+    }
+    if (flag("--password-stdin")) {
+        SecureMemory::secureZero(password);
+        password = readSecretLine("Entry password: ");
+        if (password.empty()) {
+            throw std::runtime_error("Empty entry password");
+        }
+    }
+    entry.password = password;
+    
+    bool saved = vault.saveEntry(entry);
+    SecureMemory::secureZero(entry.password);
+    if (!saved) {
+        SecureMemory::secureZero(password);
+        throw std::runtime_error("Failed to save entry");
+    }
+    
+    std::string out;
+    EntryCodec::appendSummaryJson(vault.getEntryView(entry.id), &password, out);
+    SecureMemory::secureZero(password);
+    writeOutput(out);
+    return Success;
+}
+
+int CliApp::remove() {
+    std::vector<std::string> keys = positional();
+    if (keys.size() != 1) {
+        return usage("delete needs one entry ID or label");
+    }
+    
+    SecureVault vault;
+    openVault(vault);
+    
+    EntryId id = vault.resolveEntry(keys[0]);
+    if (!vault.deleteEntry(id)) {
+        throw std::runtime_error("Failed to delete entry");
+    }
+    
+    std::string out = "{\"deleted\": ";
+    EntryCodec::appendJsonString(id.toString(), out);
+    out += '}';
+    writeOutput(out);
+    return Success;
+}
+
+int CliApp::importEntries() {
+    std::vector<std::string> files = positional();
+    if (files.size() != 1) {
+        return usage("import needs one JSON file (\"-\" for stdin)");
+    }
+    
+    // Opened first: with "-", the master password line precedes the entries
+    SecureVault vault;
+    openVault(vault);
+    
+    QByteArray content;
+    if (files[0] == "-") {
+        std::string text((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+        content = QByteArray::fromStdString(text);
+        SecureMemory::secureZero(text);
+    } else {
+        QFile file(QString::fromStdString(files[0]));
+        if (!file.open(QIODevice::ReadOnly)) {
+            throw std::runtime_error("Cannot read " + files[0]);
+        }
+        content = file.readAll();
+    }
+    
+    // Same shape as export: an array of {id?, label, username, password}
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(content, &error);
+    SecureMemory::secureZero(content.data(), static_cast<size_t>(content.size()));
+    if (error.error != QJsonParseError::NoError || !doc.isArray()) {
+        throw std::runtime_error("Import file must be a JSON array of entries");
+    }
+    
+    std::vector<VaultEntry> entries;
+    const QJsonArray array = doc.array();
+    entries.reserve(static_cast<size_t>(array.size()));
+    for (const auto& value : array) {
+        QJsonObject object = value.toObject();
+        VaultEntry entry;
+        entry.label = object.value("label").toString().toStdString();
+        entry.username = object.value("username").toString().toStdString();
+        entry.password = object.value("password").toString().toStdString();
+        if (entry.label.empty() || entry.password.empty()) {
+            throw std::runtime_error("Every imported entry needs a label and a password");
+        }
+        
+        std::string id = object.value("id").toString().toStdString();
+        if (id.empty() || !EntryId::parse(id, entry.id)) {
+            entry.id = EntryId::generate();
+        }
+        entry.created_at = core::Timestamp::fromIso(object.value("created_at").toString().toStdString());
+        if (entry.created_at.isNull()) {
+            entry.created_at = core::Timestamp::now();
+        }
+        entry.device_fingerprint = VaultEntry::getDeviceFingerprint();
+        entries.push_back(std::move(entry));
+    }
+    
+    bool saved = vault.saveEntries(entries);
+    for (auto& entry : entries) {
+        SecureMemory::secureZero(entry.password);
+    }
+    if (!saved) {
+        throw std::runtime_error("Failed to save imported entries");
+    }
+    
+    std::string out = "{\"imported\": " + std::to_string(entries.size()) + "}";
+    writeOutput(out);
+    return Success;
+}
+
+int CliApp::exportEntries() {
+    SecureVault vault;
+    openVault(vault);
+    
+    std::vector<EntryId> ids;
+    ids.reserve(vault.getEntryCount());
+    vault.forEachEntry([&ids](const core::EntryView& view) {
+        ids.push_back(view.id);
+        return true;
+    });
+    
+    std::string out = "[";
+    for (size_t i = 0; i < ids.size(); ++i) {
+        std::string password = vault.getPassword(ids[i]);
+        out += i == 0 ? "\n  " : ",\n  ";
+        EntryCodec::appendSummaryJson(vault.getEntryView(ids[i]), &password, out);
+        SecureMemory::secureZero(password);
+    }
+    out += ids.empty() ? "]" : "\n]";
+    writeOutput(out);
+    return Success;
+}
+
+int CliApp::generate() {
+    std::string lengthText = option("--length");
+    std::string countText = option("--count");
+    size_t length = lengthText.empty() ? 32 : parseCount(lengthText, "--length");
+    size_t count = countText.empty() ? 1 : parseCount(countText, "--count");
+    
+    core::PasswordGenerator generator;
+    std::string out = "[";
+    for (size_t i = 0; i < count; ++i) {
+        std::string password = generator.generatePassword(length, !flag("--no-symbols"));
+        out += i == 0 ? "\n  " : ",\n  ";
+        EntryCodec::appendJsonString(password, out);
+        SecureMemory::secureZero(password);
+    }
+    out += "\n]";
+    writeOutput(out);
+    return Success;
+}
+
+int CliApp::agent() {
+    std::string socketPath = option("--socket");
+    if (socketPath.empty()) {
+        socketPath = agent::VaultAgent::defaultSocketPath();
+    }
+    
+    // Before the vault is opened, so its pages are locked as they appear
+    SecureMemory::lockProcessMemory();
+    
+    SecureVault vault;
+    openVault(vault);
+    
+    std::string timeoutText = option("--timeout");
+    if (timeoutText == "0") {
+        vault.setAutoLockTimeout(0);   // Never
+    } else if (!timeoutText.empty()) {
+        vault.setAutoLockTimeout(static_cast<int>(std::min<size_t>(parseCount(timeoutText, "--timeout"), 86400 * 365)));
+    }
+    
+    agent::VaultAgent vaultAgent(vault, vault_path_, socketPath);
+    running_agent = &vaultAgent;
+    std::signal(SIGINT, stopAgent);
+    std::signal(SIGTERM, stopAgent);
+#ifndef _WIN32
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    
+    std::string out = "{\"socket\": ";
+    EntryCodec::appendJsonString(socketPath, out);
+    out += '}';
+    writeOutput(out);
+    
+    try {
+        vaultAgent.run();
+    } catch (...) {
+        running_agent = nullptr;
+        throw;
+    }
+    running_agent = nullptr;
+    vault.closeVault();
+    return Success;
+}
+
+int CliApp::usage(const std::string& message) const {
+    if (!message.empty()) {
+        writeError(message);
+    }
+    std::cerr <<
+        "Usage: crimson-cli [--vault PATH] <command> [options]\n"
+        "\n"
+        "Commands:\n"
+        "  list [--order label|created|last-used] [--desc] [--limit N] [--search TEXT]\n"
+        "  get <id|label>...\n"
+        "  put <label|id> [--username NAME] [--password-stdin]   (a label adds, an ID updates)\n"
+        "  delete <id|label>\n"
+        "  import <file.json|->\n"
+        "  export\n"
+        "  generate [--length N] [--count N] [--no-symbols]\n"
+        "  agent [--socket PATH] [--timeout SECONDS]   (serve the unlocked vault; 0 never locks)\n"
+        "\n"
+        "The master password is read from CRIMSON_MASTER_PASSWORD or the first\n"
+        "line of stdin. The vault defaults to CRIMSON_VAULT, then vault.gpg.\n"
+        "With CRIMSON_AGENT_SOCK set, list, get and put go to that agent instead.\n"
+        "CRIMSON_TRACE=FILE writes a Chrome trace of the command to FILE.\n";
+    return message.empty() ? Success : Usage;
+}
+
+void CliApp::openVault(SecureVault& vault) const {
+    std::string masterPassword;
+    const char* envPassword = std::getenv("CRIMSON_MASTER_PASSWORD");
+    if (envPassword) {
+        masterPassword = envPassword;
+    } else {
+        masterPassword = readSecretLine("Master password: ");
+    }
+    
+    bool opened = vault.openVault(masterPassword, vault_path_);
+    SecureMemory::secureZero(masterPassword);
+    if (!opened) {
+        throw std::runtime_error("Cannot open vault " + vault_path_ + " (wrong password or unreadable file)");
+    }
+}
+
+std::string CliApp::option(const std::string& name) const {
+    for (size_t i = 0; i + 1 < args_.size(); ++i) {
+        if (args_[i] == name) {
+            return args_[i + 1];
+        }
+    }
+    return std::string();
+}
+
+bool CliApp::flag(const std::string& name) const {
+    return std::find(args_.begin(), args_.end(), name) != args_.end();
+}
+
+std::vector<std::string> CliApp::positional() const {
+    std::vector<std::string> values;
+    for (size_t i = 0; i < args_.size(); ++i) {
+        if (takesValue(args_[i])) {
+            ++i;
+        } else if (args_[i].size() < 2 || args_[i].compare(0, 2, "--") != 0) {
+            values.push_back(args_[i]);
+        }
+    }
+    return values;
+}
+
+std::string CliApp::readSecretLine(const char* prompt) {
+    std::string line;
+#ifdef _WIN32
+    HANDLE input = GetStdHandle(STD_INPUT_HANDLE);
+    DWORD mode = 0;
+    bool terminal = GetConsoleMode(input, &mode) != 0;
+    if (terminal) {
+        std::cerr << prompt << std::flush;
+        SetConsoleMode(input, mode & ~static_cast<DWORD>(ENABLE_ECHO_INPUT));
+    }
+    std::getline(std::cin, line);
+    if (terminal) {
+        SetConsoleMode(input, mode);
+        std::cerr << std::endl;
+    }
+#else
+    struct termios saved;
+    bool terminal = ::isatty(STDIN_FILENO) && ::tcgetattr(STDIN_FILENO, &saved) == 0;
+    if (terminal) {
+        std::cerr << prompt << std::flush;
+        struct termios silent = saved;
+        silent.c_lflag &= ~static_cast<tcflag_t>(ECHO);
+        ::tcsetattr(STDIN_FILENO, TCSAFLUSH, &silent);
+    }
+    std::getline(std::cin, line);
+    if (terminal) {
+        ::tcsetattr(STDIN_FILENO, TCSAFLUSH, &saved);
+        std::cerr << std::endl;
+    }
+#endif
+    if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+    }
+    return line;
+}
+
+void CliApp::writeError(const std::string& message) {
+    std::string out = "{\"error\": ";
+    EntryCodec::appendJsonString(message, out);
+    out += "}\n";
+    std::cerr << out << std::flush;
+}
+
+} // namespace cli
+} // namespace crimson
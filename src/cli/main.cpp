@@ -0,0 +1,31 @@
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
+#include "cli/CliApp.h"
+
+int main(int argc, char *argv[]) {
+    // Disable core dumps for security
+#ifdef __linux__
+    struct rlimit rl;
+    rl.rlim_cur = rl.rlim_max = 0;
+    setrlimit(RLIMIT_CORE, &rl);
+#endif
+    
+    try {
+        std::vector<std::string> args(argv + 1, argv + argc);
+        crimson::cli::CliApp app;
+        return app.run(args);
+        
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return 1;
+    } catch (...) {
+        std::cerr << "Unknown fatal error occurred" << std::endl;
+        return 1;
+    }
+}
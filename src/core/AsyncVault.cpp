@@ -0,0 +1,262 @@
+#include "core/AsyncVault.h"
+#include "core/SecureMemory.h"
+#include <QtCore/QPointer>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    /**
+     * @brief Call an operation on the task's copy of the master password, then wipe it
+     */
+    template <typename F>
+    bool withPassword(std::string& secret, F operation) {
+        try {
+            bool result = operation(secret);
+            SecureMemory::secureZero(secret);
+            return result;
+        } catch (...) {
+            SecureMemory::secureZero(secret);
+            throw;
+        }
+    }
+}
+
+AsyncVault::AsyncVault(SecureVault& vault, Executor& executor)
+    : vault_(vault)
+    , executor_(executor)
+    , in_flight_(std::make_shared<InFlight>())
+    , changes_(Executor::Priority::Interactive, executor) {
+}
+
+AsyncVault::~AsyncVault() {
+    wait();
+}
+
+size_t AsyncVault::pending() const {
+    std::lock_guard<std::mutex> lock(in_flight_->mutex);
+    return in_flight_->count;
+}
+
+void AsyncVault::wait() const {
+    std::unique_lock<std::mutex> lock(in_flight_->mutex);
+    in_flight_->drained.wait(lock, [this] { return in_flight_->count == 0; });
+}
+
+template <typename T, typename F>
+std::future<T> AsyncVault::start(bool serial, Executor::Priority priority, F operation,
+                                 QObject* context, Done<T> done) {
+    auto promise = std::make_shared<std::promise<T>>();
+    std::future<T> future = promise->get_future();
+    std::shared_ptr<std::future<T>> result;
+    if (done) {
+        result = std::make_shared<std::future<T>>(std::move(future));
+    }
+    QPointer<QObject> guard(context);   // Taken here, on the caller's thread
+    bool guarded = context != nullptr;
+    
+    {
+        std::lock_guard<std::mutex> lock(in_flight_->mutex);
+        ++in_flight_->count;
+    }
+    
+    // Holds the count itself: once it reaches zero, this object may go
+    auto task = [inFlight = in_flight_, operation = std::move(operation), promise, result, guard, guarded,
+                 done = std::move(done)]() mutable {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                operation();
+                promise->set_value();
+            } else {
+                promise->set_value(operation());
+            }
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+        
+        if (done) {
+            Executor::postToMainThread(guard, guarded, [done, result]() {
+                done(std::move(*result));
+            });
+        }
+        
+        std::lock_guard<std::mutex> lock(inFlight->mutex);
+        if (--inFlight->count == 0) {
+            inFlight->drained.notify_all();
+        }
+    };
+    
+    if (serial) {
+        changes_.post(std::move(task));
+    } else {
+        executor_.post(std::move(task), priority);
+    }
+    return future;
+}
+
+template <typename F>
+auto AsyncVault::change(F operation, QObject* context, Done<std::invoke_result_t<F&>> done) {
+    return start<std::invoke_result_t<F&>>(true, Executor::Priority::Interactive, std::move(operation),
+                                           context, std::move(done));
+}
+
+template <typename F>
+auto AsyncVault::read(F operation, QObject* context, Done<std::invoke_result_t<F&>> done,
+                      Executor::Priority priority) {
+    return start<std::invoke_result_t<F&>>(false, priority, std::move(operation),
+                                           context, std::move(done));
+}
+
+std::future<bool> AsyncVault::createVault(const std::string& masterPassword, const std::string& vaultPath) {
+    return change([this, secret = masterPassword, vaultPath]() mutable {
+        return withPassword(secret, [&](const std::string& password) {
+            return vault_.createVault(password, vaultPath);
+        });
+    });
+}
+
+void AsyncVault::createVault(const std::string& masterPassword, const std::string& vaultPath,
+                             QObject* context, Done<bool> done) {
+    change([this, secret = masterPassword, vaultPath]() mutable {
+        return withPassword(secret, [&](const std::string& password) {
+            return vault_.createVault(password, vaultPath);
+        });
+    }, context, std::move(done));
+}
+
+std::future<bool> AsyncVault::openVault(const std::string& masterPassword, const std::string& vaultPath) {
+    return change([this, secret = masterPassword, vaultPath]() mutable {
+        return withPassword(secret, [&](const std::string& password) {
+            return vault_.openVault(password, vaultPath);
+        });
+    });
+}
+
+void AsyncVault::openVault(const std::string& masterPassword, const std::string& vaultPath,
+                           QObject* context, Done<bool> done) {
+    change([this, secret = masterPassword, vaultPath]() mutable {
+        return withPassword(secret, [&](const std::string& password) {
+            return vault_.openVault(password, vaultPath);
+        });
+    }, context, std::move(done));
+}
+
+std::future<void> AsyncVault::closeVault() {
+    return change([this]() { vault_.closeVault(); });
+}
+
+void AsyncVault::closeVault(QObject* context, Done<void> done) {
+    change([this]() { vault_.closeVault(); }, context, std::move(done));
+}
+
+std::future<bool> AsyncVault::saveEntry(const VaultEntry& entry) {
+    return change([this, entry]() { return vault_.saveEntry(entry); });
+}
+
+void AsyncVault::saveEntry(const VaultEntry& entry, QObject* context, Done<bool> done) {
+    change([this, entry]() { return vault_.saveEntry(entry); }, context, std::move(done));
+}
+
+std::future<bool> AsyncVault::saveEntries(std::vector<VaultEntry> entries) {
+    return change([this, entries = std::move(entries)]() { return vault_.saveEntries(entries); });
+}
+
+void AsyncVault::saveEntries(std::vector<VaultEntry> entries, QObject* context, Done<bool> done) {
+    change([this, entries = std::move(entries)]() { return vault_.saveEntries(entries); },
+           context, std::move(done));
+}
+
+std::future<bool> AsyncVault::deleteEntry(const EntryId& entryId) {
+    return change([this, entryId]() { return vault_.deleteEntry(entryId); });
+}
+
+void AsyncVault::deleteEntry(const EntryId& entryId, QObject* context, Done<bool> done) {
+    change([this, entryId]() { return vault_.deleteEntry(entryId); }, context, std::move(done));
+}
+
+std::future<VaultEntry> AsyncVault::createEntry(const std::string& label) {
+    return read([this, label]() { return vault_.createEntry(label); });
+}
+
+void AsyncVault::createEntry(const std::string& label, QObject* context, Done<VaultEntry> done) {
+    read([this, label]() { return vault_.createEntry(label); }, context, std::move(done));
+}
+
+std::future<VaultEntry> AsyncVault::getEntry(const EntryId& entryId) {
+    return read([this, entryId]() { return vault_.getEntry(entryId); });
+}
+
+void AsyncVault::getEntry(const EntryId& entryId, QObject* context, Done<VaultEntry> done) {
+    read([this, entryId]() { return vault_.getEntry(entryId); }, context, std::move(done));
+}
+
+std::future<std::string> AsyncVault::getPassword(const EntryId& entryId) {
+    return read([this, entryId]() { return vault_.getPassword(entryId); });
+}
+
+void AsyncVault::getPassword(const EntryId& entryId, QObject* context, Done<std::string> done) {
+    read([this, entryId]() { return vault_.getPassword(entryId); }, context, std::move(done));
+}
+
+std::future<AsyncVault::Labels> AsyncVault::search(const std::string& query, size_t limit) {
+    return read([this, query, limit]() { return vault_.search(query, limit); });
+}
+
+void AsyncVault::search(const std::string& query, size_t limit, QObject* context, Done<Labels> done) {
+    read([this, query, limit]() { return vault_.search(query, limit); }, context, std::move(done));
+}
+
+std::future<SecureVault::EntryPage> AsyncVault::listEntries(SecureVault::EntryOrder order, const std::string& cursor,
+                                                            size_t pageSize, bool descending) {
+    return read([this, order, cursor, pageSize, descending]() {
+        return vault_.listEntries(order, cursor, pageSize, descending);
+    });
+}
+
+void AsyncVault::listEntries(SecureVault::EntryOrder order, const std::string& cursor, size_t pageSize, bool descending,
+                             QObject* context, Done<SecureVault::EntryPage> done) {
+    read([this, order, cursor, pageSize, descending]() {
+        return vault_.listEntries(order, cursor, pageSize, descending);
+    }, context, std::move(done));
+}
+
+std::future<SecureVault::VaultStats> AsyncVault::getStats() {
+    return read([this]() { return vault_.getStats(); });
+}
+
+void AsyncVault::getStats(QObject* context, Done<SecureVault::VaultStats> done) {
+    read([this]() { return vault_.getStats(); }, context, std::move(done));
+}
+
+std::future<bool> AsyncVault::verifyIntegrity() {
+    return read([this]() { return vault_.verifyIntegrity(); });
+}
+
+void AsyncVault::verifyIntegrity(QObject* context, Done<bool> done) {
+    read([this]() { return vault_.verifyIntegrity(); }, context, std::move(done));
+}
+
+std::future<std::vector<EntryId>> AsyncVault::findBreachedEntries() {
+    return read([this]() { return vault_.findBreachedEntries(); }, nullptr, {}, Executor::Priority::Bulk);
+}
+
+void AsyncVault::findBreachedEntries(QObject* context, Done<std::vector<EntryId>> done) {
+    read([this]() { return vault_.findBreachedEntries(); }, context, std::move(done), Executor::Priority::Bulk);
+}
+
+std::future<SecureVault::AuditSummary> AsyncVault::auditVault(SecureVault::AuditOptions options,
+                                                              SecureVault::AuditCallback callback) {
+    return read([this, options = std::move(options), callback = std::move(callback)]() {
+        return vault_.auditVault(options, callback);
+    }, nullptr, {}, Executor::Priority::Bulk);
+}
+
+void AsyncVault::auditVault(SecureVault::AuditOptions options, SecureVault::AuditCallback callback,
+                            QObject* context, Done<SecureVault::AuditSummary> done) {
+    read([this, options = std::move(options), callback = std::move(callback)]() {
+        return vault_.auditVault(options, callback);
+    }, context, std::move(done), Executor::Priority::Bulk);
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,190 @@
+#include "core/BreachCorpus.h"
+#include "core/SecureMemory.h"
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QString>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace crimson {
+namespace core {
+
+BreachCorpus::BreachCorpus(const std::string& path, HashType type, size_t recordSize)
+    : file_(path)
+    , hash_type_(type)
+    , record_size_(recordSize == 0 ? hashLength(type) : recordSize)
+    , record_count_(0)
+    , bloom_bits_(0)
+    , bloom_hashes_(0) {
+    
+    if (record_size_ > hashLength(type)) {
+        throw std::invalid_argument("Corpus record size exceeds hash length");
+    }
+    
+    if (file_.size() % record_size_ != 0) {
+        throw std::runtime_error("Corpus file is not a whole number of records");
+    }
+    
+    record_count_ = file_.size() / record_size_;
+    file_.adviseRandom();
+}
+
+bool BreachCorpus::contains(const std::string& password) const {
+    return contains(password.data(), password.size());
+}
+
+bool BreachCorpus::contains(const char* password, size_t length) const {
+    std::vector<uint8_t> hash = hashPassword(password, length, hash_type_);
+    bool found = containsHash(hash.data());
+    SecureMemory::secureZero(hash.data(), hash.size());
+    return found;
+}
+
+bool BreachCorpus::containsHash(const uint8_t* hash) const {
+    if (!hash || record_count_ == 0) {
+        return false;
+    }
+    
+    if (!bloom_.empty() && !bloomMayContain(hash)) {
+        return false;
+    }
+    
+    const uint64_t key = leadingKey(hash);
+    size_t lo = 0;
+    size_t hi = record_count_;  // search [lo, hi)
+    unsigned step = 0;
+    
+    while (hi - lo > 8) {
+        uint64_t loKey = leadingKey(record(lo));
+        uint64_t hiKey = leadingKey(record(hi - 1));
+        if (key < loKey || key > hiKey) {
+            return false;
+        }
+        
+        // Interpolate on uniformly distributed keys; every third probe
+        // bisects so skewed corpora still finish in O(log n)
+        size_t mid;
+        if (++step % 3 == 0 || hiKey == loKey) {
+            mid = lo + (hi - lo) / 2;
+        } else {
+            double fraction = static_cast<double>(key - loKey) / static_cast<double>(hiKey - loKey);
+            mid = lo + static_cast<size_t>(fraction * static_cast<double>(hi - 1 - lo));
+            mid = std::min(std::max(mid, lo), hi - 1);
+        }
+        
+        int cmp = std::memcmp(record(mid), hash, record_size_);
+        if (cmp == 0) {
+            return true;
+        }
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    
+    for (size_t i = lo; i < hi; ++i) {
+        if (std::memcmp(record(i), hash, record_size_) == 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+void BreachCorpus::buildBloomFilter(size_t bitsPerEntry) {
+    if (bitsPerEntry == 0) {
+        bloom_.clear();
+        return;
+    }
+    
+    bloom_bits_ = std::max<uint64_t>(64, static_cast<uint64_t>(record_count_) * bitsPerEntry);
+    bloom_hashes_ = std::max(1u, static_cast<unsigned>(std::lround(bitsPerEntry * 0.693)));
+    bloom_.assign((bloom_bits_ + 63) / 64, 0);
+    
+    file_.adviseSequential();
+    for (size_t i = 0; i < record_count_; ++i) {
+        bloomInsert(record(i));
+    }
+    file_.adviseRandom();
+}
+
+void BreachCorpus::bloomSeeds(const uint8_t* hash, uint64_t& h1, uint64_t& h2) const {
+    // Records are already hashes: split eight of their bytes into two
+    // 32-bit seeds and derive the probe positions by double hashing
+    uint64_t seed = 0;
+    std::memcpy(&seed, hash + (record_size_ >= 16 ? 8 : 0), std::min<size_t>(8, record_size_));
+    h1 = seed & 0xffffffffu;
+    h2 = (seed >> 32) | 1;
+}
+
+bool BreachCorpus::bloomMayContain(const uint8_t* hash) const {
+    uint64_t h1;
+    uint64_t h2;
+    bloomSeeds(hash, h1, h2);
+    
+    for (unsigned i = 0; i < bloom_hashes_; ++i) {
+        uint64_t bit = (h1 + i * h2) % bloom_bits_;
+        if (!(bloom_[bit / 64] & (uint64_t(1) << (bit % 64)))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BreachCorpus::bloomInsert(const uint8_t* hash) {
+    uint64_t h1;
+    uint64_t h2;
+    bloomSeeds(hash, h1, h2);
+    
+    for (unsigned i = 0; i < bloom_hashes_; ++i) {
+        uint64_t bit = (h1 + i * h2) % bloom_bits_;
+        bloom_[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+}
+
+uint64_t BreachCorpus::leadingKey(const uint8_t* bytes) const {
+    uint64_t key = 0;
+    size_t n = std::min<size_t>(8, record_size_);
+    for (size_t i = 0; i < 8; ++i) {
+        key = (key << 8) | (i < n ? bytes[i] : 0);
+    }
+    return key;
+}
+
+std::vector<uint8_t> BreachCorpus::hashPassword(const std::string& password, HashType type) {
+    return hashPassword(password.data(), password.size(), type);
+}
+
+std::vector<uint8_t> BreachCorpus::hashPassword(const char* password, size_t length, HashType type) {
+    QByteArray digest;
+    
+    if (type == HashType::Ntlm) {
+        // NTLM hashes the UTF-16LE encoding of the password
+        QString unicode = QString::fromUtf8(password, static_cast<int>(length));
+        QByteArray utf16le;
+        utf16le.reserve(unicode.size() * 2);
+        for (QChar c : unicode) {
+            ushort u = c.unicode();
+            utf16le.append(static_cast<char>(u & 0xff));
+            utf16le.append(static_cast<char>(u >> 8));
+        }
+        digest = QCryptographicHash::hash(utf16le, QCryptographicHash::Md4);
+        SecureMemory::secureZero(utf16le.data(), static_cast<size_t>(utf16le.size()));
+    } else {
+        digest = QCryptographicHash::hash(QByteArray::fromRawData(password, static_cast<int>(length)),
+                                          QCryptographicHash::Sha1);
+    }
+    
+    std::vector<uint8_t> hash(digest.begin(), digest.end());
+    SecureMemory::secureZero(digest.data(), static_cast<size_t>(digest.size()));
+    return hash;
+}
+
+size_t BreachCorpus::hashLength(HashType type) {
+    return type == HashType::Ntlm ? 16 : 20;
+}
+
+} // namespace core
+} // namespace crimson
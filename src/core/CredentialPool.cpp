@@ -0,0 +1,118 @@
+#include "core/CredentialPool.h"
+#include "core/PasswordGenerator.h"
+#include <cstring>
+#include <vector>
+
+namespace crimson {
+namespace core {
+
+CredentialPool::CredentialPool(size_t capacity, size_t passwordLength)
+    : capacity_(capacity)
+    , password_length_(passwordLength)
+    , slot_size_(USERNAME_SLOT_SIZE + passwordLength)
+    , slots_(nullptr)
+    , count_(0)
+    , stopping_(true)
+    , refilling_(false)
+    , refill_(Executor::Priority::Bulk) {
+    
+    PasswordPolicy::standard().validateLength(passwordLength);
+}
+
+CredentialPool::~CredentialPool() {
+    stop();
+}
+
+void CredentialPool::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopping_ || capacity_ == 0) {
+        return;
+    }
+    
+    slots_ = SecureMemory::createBuffer(capacity_ * slot_size_);
+    count_ = 0;
+    stopping_ = false;
+    scheduleRefill();
+}
+
+void CredentialPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    
+    try {
+        refill_.wait();
+    } catch (const std::exception&) {
+        // A failed refill only left the pool short
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.reset();  // SecureBuffer zeroes itself on release
+    count_ = 0;
+}
+
+bool CredentialPool::take(std::string& username, std::string& password) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!slots_ || count_ == 0) {
+        return false;
+    }
+    
+    char* entry = slot(--count_);
+    username.assign(entry, ::strnlen(entry, USERNAME_SLOT_SIZE));
+    password.assign(entry + USERNAME_SLOT_SIZE, password_length_);
+    SecureMemory::secureZero(entry, slot_size_);
+    
+    scheduleRefill();
+    return true;
+}
+
+size_t CredentialPool::available() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return count_;
+}
+
+void CredentialPool::scheduleRefill() {
+    if (stopping_ || refilling_ || count_ >= capacity_) {
+        return;
+    }
+    refilling_ = true;
+    refill_.run([this]() { refill(); });
+}
+
+void CredentialPool::refill() {
+    std::vector<char> password(password_length_);
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_ && count_ < capacity_) {
+        lock.unlock();
+        std::string username;
+        try {
+            // Seeding happens here rather than on the caller's thread
+            if (!generator_) {
+                generator_ = std::make_unique<PasswordGenerator>();
+            }
+            username = generator_->generateUsername();
+            generator_->generatePassword(PasswordPolicy::standard(), password.data(), password.size());
+        } catch (...) {
+            SecureMemory::secureZero(password.data(), password.size());
+            lock.lock();
+            refilling_ = false;
+            throw;
+        }
+        lock.lock();
+        
+        if (!stopping_ && count_ < capacity_ && username.size() <= USERNAME_SLOT_SIZE) {
+            char* entry = slot(count_++);
+            std::memcpy(entry, username.data(), username.size());
+            std::memcpy(entry + USERNAME_SLOT_SIZE, password.data(), password.size());
+        }
+        
+        SecureMemory::secureZero(username);
+        SecureMemory::secureZero(password.data(), password.size());
+    }
+    refilling_ = false;
+}
+
+} // namespace core
+} // namespace crimson
@@ -1,4 +1,7 @@
 #include "core/CryptoManager.h"
+#include "core/Executor.h"
+#include "core/Metrics.h"
+#include "core/Trace.h"
 #include <QtCore/QCryptographicHash>
 #include <QtCore/QByteArray>
 #include <QtCore/QString>
@@ -68,6 +71,10 @@ std::unique_ptr<SecureMemory::SecureBuffer> CryptoManager::deriveKey(
     const std::string& masterPassword,
     std::string& salt) {
     
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("crypto.derive_key");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("crypto", "derive_key");
+    
     if (!impl_->initialized) {
         throw std::runtime_error("CryptoManager not initialized");
     }
@@ -85,6 +92,7 @@ std::unique_ptr<SecureMemory::SecureBuffer> CryptoManager::deriveKey(
     
 #ifdef HAVE_CRYPTO_LIBS
     // Use Argon2id for key derivation
+    CRIMSON_TRACE_SPAN("crypto", "argon2id");
     int ret = argon2id_hash_raw(
         3,                              // time cost (iterations)
         65536,                          // memory cost (64 MB)
@@ -105,6 +113,7 @@ std::unique_ptr<SecureMemory::SecureBuffer> CryptoManager::deriveKey(
     QString combined = QString::fromStdString(masterPassword) + QString::fromUtf8(reinterpret_cast<const char*>(saltBytes.data()), saltBytes.size());
     
     // Multiple rounds of SHA-256 for basic stretching
+    CRIMSON_TRACE_SPAN("crypto", "sha256_stretch");
     QByteArray key = combined.toUtf8();
     for (int i = 0; i < 10000; ++i) {
         key = QCryptographicHash::hash(key, QCryptographicHash::Sha256);
@@ -120,6 +129,10 @@ std::vector<uint8_t> CryptoManager::encrypt(
     const std::string& plaintext,
     const SecureMemory::SecureBuffer& key) {
     
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("crypto.encrypt");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("crypto", "encrypt");
+    
     if (!impl_->initialized) {
         throw std::runtime_error("CryptoManager not initialized");
     }
@@ -149,22 +162,44 @@ std::string CryptoManager::decrypt(
     const std::vector<uint8_t>& ciphertext,
     const SecureMemory::SecureBuffer& key) {
     
+    std::string result(ciphertext.size(), '\0');
+    decryptInto(ciphertext, key, reinterpret_cast<uint8_t*>(&result[0]), result.size());
+    return result;
+}
+
+size_t CryptoManager::decrypt(
+    const std::vector<uint8_t>& ciphertext,
+    const SecureMemory::SecureBuffer& key,
+    SecureMemory::SecureBuffer& out) const {
+    
+    decryptInto(ciphertext, key, out.as<uint8_t>(), out.size());
+    return ciphertext.size();
+}
+
+void CryptoManager::decryptInto(
+    const std::vector<uint8_t>& ciphertext,
+    const SecureMemory::SecureBuffer& key,
+    uint8_t* out, size_t outSize) const {
+    
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("crypto.decrypt");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("crypto", "decrypt");
+    
     if (!impl_->initialized) {
         throw std::runtime_error("CryptoManager not initialized");
     }
     
+    if (ciphertext.size() > outSize) {
+        throw std::length_error("Output buffer too small for plaintext");
+    }
+    
     // Corresponding decrypt for the simple XOR cipher
     // TODO: Implement proper AES-256 decryption
-    std::string result;
-    result.reserve(ciphertext.size());
-    
     const uint8_t* keyData = key.as<uint8_t>();
     
     for (size_t i = 0; i < ciphertext.size(); ++i) {
-        result.push_back(ciphertext[i] ^ keyData[i % key.size()]);
+        out[i] = ciphertext[i] ^ keyData[i % key.size()];
     }
-    
-    return result;
 }
 
 std::string CryptoManager::generateSalt(size_t size) {
@@ -184,6 +219,10 @@ bool CryptoManager::verifyMasterPassword(
     const std::string& storedHash,
     const std::string& salt) {
     
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("crypto.verify_password");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("crypto", "verify_password");
+    
     std::string computedHash = hashMasterPassword(masterPassword, salt);
     return computedHash == storedHash;
 }
@@ -192,11 +231,16 @@ std::string CryptoManager::hashMasterPassword(
     const std::string& masterPassword,
     const std::string& salt) {
     
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("crypto.hash_password");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("crypto", "hash_password");
+    
     std::vector<uint8_t> saltBytes = fromBase64(salt);
     
 #ifdef HAVE_CRYPTO_LIBS
     std::vector<uint8_t> hash(32);
     
+    CRIMSON_TRACE_SPAN("crypto", "argon2id");
     int ret = argon2id_hash_raw(
         3,                              // time cost
         65536,                          // memory cost (64 MB)
@@ -218,6 +262,7 @@ std::string CryptoManager::hashMasterPassword(
     // Simplified password hashing using Qt's crypto (NOT SECURE - for development only)
     QString combined = QString::fromStdString(masterPassword) + QString::fromUtf8(reinterpret_cast<const char*>(saltBytes.data()), saltBytes.size());
     
+    CRIMSON_TRACE_SPAN("crypto", "sha256_stretch");
     QByteArray hash = combined.toUtf8();
     for (int i = 0; i < 10000; ++i) {
         hash = QCryptographicHash::hash(hash, QCryptographicHash::Sha256);
@@ -227,6 +272,53 @@ std::string CryptoManager::hashMasterPassword(
 #endif
 }
 
+std::unique_ptr<SecureMemory::SecureBuffer> CryptoManager::unlock(
+    const std::string& masterPassword,
+    const std::string& storedHash,
+    const std::string& salt) {
+    
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("crypto.unlock");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("crypto", "unlock");
+    
+    std::unique_ptr<SecureMemory::SecureBuffer> key;
+    std::string keySalt = salt;
+    
+    TaskGroup derivation(Executor::Priority::Interactive);
+    derivation.run([&]() {
+        key = deriveKey(masterPassword, keySalt);
+    });
+    bool verified = verifyMasterPassword(masterPassword, storedHash, salt);
+    derivation.wait();
+    
+    if (!verified) {
+        key.reset();   // Wipes it
+    }
+    return key;
+}
+
+std::unique_ptr<SecureMemory::SecureBuffer> CryptoManager::deriveKeyAndHash(
+    const std::string& masterPassword,
+    const std::string& salt,
+    std::string& hash) {
+    
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("crypto.derive_key_and_hash");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("crypto", "derive_key_and_hash");
+    
+    std::unique_ptr<SecureMemory::SecureBuffer> key;
+    std::string keySalt = salt;
+    
+    TaskGroup derivation(Executor::Priority::Interactive);
+    derivation.run([&]() {
+        key = deriveKey(masterPassword, keySalt);
+    });
+    hash = hashMasterPassword(masterPassword, salt);
+    derivation.wait();
+    
+    return key;
+}
+
 std::string CryptoManager::sha256(const std::string& data) {
     QCryptographicHash hash(QCryptographicHash::Sha256);
     hash.addData(data.c_str(), data.length());
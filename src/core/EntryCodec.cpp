@@ -0,0 +1,271 @@
+#include "core/EntryCodec.h"
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QString>
+#include <QtCore/QtGlobal>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    // Ids and timestamps are short ASCII; copy them out of the QString
+    // without going through a heap-allocated std::string
+    constexpr int ASCII_BUFFER_SIZE = 64;
+    
+    bool copyAscii(const QString& text, char* buffer, size_t& length) {
+        if (text.size() > ASCII_BUFFER_SIZE) {
+            return false;
+        }
+        const QChar* chars = text.constData();
+        for (int i = 0; i < text.size(); ++i) {
+            auto c = chars[i].unicode();
+            if (c >= 0x80) {
+                return false;
+            }
+            buffer[i] = static_cast<char>(c);
+        }
+        length = static_cast<size_t>(text.size());
+        return true;
+    }
+    
+    template <typename T>
+    void appendLittleEndian(T value, std::string& out) {
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+    
+    template <typename T>
+    T readLittleEndian(const char* data) {
+        T value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<T>(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return value;
+    }
+    
+    struct BinaryReader {
+        std::string_view data;
+        size_t position;
+        
+        const char* take(size_t count) {
+            if (data.size() - position < count) {
+                throw std::runtime_error("Truncated binary vault entry");
+            }
+            const char* start = data.data() + position;
+            position += count;
+            return start;
+        }
+    };
+    
+    // Per-type pieces the generated codecs are assembled from
+    bool isEmptyValue(const std::string& value) { return value.empty(); }
+    bool isEmptyValue(const EntryId& value) { return value.isNull(); }
+    bool isEmptyValue(Timestamp value) { return value.isNull(); }
+    
+    void writeJsonValue(const std::string& value, std::string& out) {
+        EntryCodec::appendJsonString(value, out);
+    }
+    
+    void writeJsonValue(const EntryId& value, std::string& out) {
+        out.push_back('"');
+        out += value.toString();
+        out.push_back('"');
+    }
+    
+    void writeJsonValue(Timestamp value, std::string& out) {
+        out.push_back('"');
+        out += value.toIso();
+        out.push_back('"');
+    }
+    
+    void readJsonValue(const QJsonValue& json, std::string& value) {
+        value = json.toString().toStdString();
+    }
+    
+    // One malformed id must not make the whole vault unreadable: the
+    // entry gets a fresh id instead, written back with the next save
+    void replaceInvalidId(std::string_view text, EntryId& value) {
+        value = EntryId::generate();
+        qWarning("Vault entry id \"%.*s\" is not a UUID; using %s instead",
+                 static_cast<int>(text.size()), text.data(), value.toString().c_str());
+    }
+    
+    void readJsonValue(const QJsonValue& json, EntryId& value) {
+        QString text = json.toString();
+        char buffer[ASCII_BUFFER_SIZE];
+        size_t length = 0;
+        if (!copyAscii(text, buffer, length)) {
+            replaceInvalidId(text.toStdString(), value);
+        } else if (!EntryId::parse(std::string_view(buffer, length), value)) {
+            replaceInvalidId(std::string_view(buffer, length), value);
+        }
+    }
+    
+    void readJsonValue(const QJsonValue& json, Timestamp& value) {
+        QString text = json.toString();
+        char buffer[ASCII_BUFFER_SIZE];
+        size_t length = 0;
+        value = copyAscii(text, buffer, length) ? Timestamp::fromIso(std::string_view(buffer, length))
+                                                : Timestamp::fromIso(text.toStdString());
+    }
+    
+    void assignValue(std::string_view text, std::string& value) {
+        value.assign(text.data(), text.size());
+    }
+    
+    void assignValue(std::string_view text, EntryId& value) {
+        if (!EntryId::parse(text, value)) {
+            replaceInvalidId(text, value);
+        }
+    }
+    
+    void assignValue(std::string_view text, Timestamp& value) {
+        value = Timestamp::fromIso(text);
+    }
+    
+    void clearValue(std::string& value) { value.clear(); }
+    void clearValue(EntryId& value) { value = EntryId(); }
+    void clearValue(Timestamp& value) { value = Timestamp(); }
+    
+    void writeBinaryValue(const std::string& value, std::string& out) {
+        if (value.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Entry field too long for binary encoding");
+        }
+        appendLittleEndian(static_cast<uint32_t>(value.size()), out);
+        out.append(value);
+    }
+    
+    void writeBinaryValue(const EntryId& value, std::string& out) {
+        out.append(reinterpret_cast<const char*>(value.bytes().data()), value.bytes().size());
+    }
+    
+    void writeBinaryValue(Timestamp value, std::string& out) {
+        appendLittleEndian(static_cast<uint64_t>(value.seconds()), out);
+    }
+    
+    void readBinaryValue(BinaryReader& reader, std::string& value) {
+        auto length = readLittleEndian<uint32_t>(reader.take(sizeof(uint32_t)));
+        value.assign(reader.take(length), length);
+    }
+    
+    void readBinaryValue(BinaryReader& reader, EntryId& value) {
+        EntryId::Bytes bytes;
+        std::memcpy(bytes.data(), reader.take(bytes.size()), bytes.size());
+        value = EntryId(bytes);
+    }
+    
+    void readBinaryValue(BinaryReader& reader, Timestamp& value) {
+        value = Timestamp(static_cast<int64_t>(readLittleEndian<uint64_t>(reader.take(sizeof(uint64_t)))));
+    }
+}
+
+void EntryCodec::appendJson(const VaultEntry& entry, std::string& out) {
+    bool first = true;
+    auto writeField = [&](const auto& field) {
+        const auto& value = entry.*(field.member);
+        if (field.optional && isEmptyValue(value)) {
+            return;
+        }
+        out += first ? "{\"" : ",\"";
+        out += field.name;
+        out += "\":";
+        writeJsonValue(value, out);
+        first = false;
+    };
+    
+    std::apply([&](const auto&... field) { (writeField(field), ...); }, fields());
+    out.push_back('}');
+}
+
+VaultEntry EntryCodec::fromJson(const QJsonObject& object) {
+    VaultEntry entry;
+    std::apply([&](const auto&... field) {
+        (readJsonValue(object.value(QLatin1String(field.name)), entry.*(field.member)), ...);
+    }, fields());
+    return entry;
+}
+
+void EntryCodec::appendBinary(const VaultEntry& entry, std::string& out) {
+    std::apply([&](const auto&... field) { (writeBinaryValue(entry.*(field.member), out), ...); }, fields());
+}
+
+size_t EntryCodec::readBinary(std::string_view data, VaultEntry& entry) {
+    BinaryReader reader{data, 0};
+    std::apply([&](const auto&... field) { (readBinaryValue(reader, entry.*(field.member)), ...); }, fields());
+    return reader.position;
+}
+
+bool EntryCodec::assignField(std::string_view name, std::string_view text, VaultEntry& entry) {
+    bool found = false;
+    auto assignIfNamed = [&](const auto& field) {
+        if (!found && name == field.name) {
+            assignValue(text, entry.*(field.member));
+            found = true;
+        }
+    };
+    
+    std::apply([&](const auto&... field) { (assignIfNamed(field), ...); }, fields());
+    return found;
+}
+
+void EntryCodec::clear(VaultEntry& entry) {
+    std::apply([&](const auto&... field) { (clearValue(entry.*(field.member)), ...); }, fields());
+}
+
+void EntryCodec::appendSummaryJson(const EntryView& view, const std::string* password, std::string& out) {
+    out += "{\"id\": ";
+    writeJsonValue(view.id, out);
+    out += ", \"label\": ";
+    appendJsonString(view.label, out);
+    out += ", \"username\": ";
+    appendJsonString(view.username, out);
+    if (password) {
+        out += ", \"password\": ";
+        appendJsonString(*password, out);
+    }
+    out += ", \"created_at\": ";
+    writeJsonValue(view.created_at, out);
+    if (!view.last_used_at.isNull()) {
+        out += ", \"last_used_at\": ";
+        writeJsonValue(view.last_used_at, out);
+    }
+    out += '}';
+}
+
+void EntryCodec::appendJsonString(std::string_view text, std::string& out) {
+    static const char hex[] = "0123456789abcdef";
+    
+    out.push_back('"');
+    size_t start = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+        
+        out.append(text.data() + start, i - start);
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            out += "\\u00";
+            out.push_back(hex[c >> 4]);
+            out.push_back(hex[c & 0x0F]);
+            break;
+        }
+        start = i + 1;
+    }
+    out.append(text.data() + start, text.size() - start);
+    out.push_back('"');
+}
+
+} // namespace core
+} // namespace crimson
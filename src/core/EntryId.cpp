@@ -0,0 +1,90 @@
+#include "core/EntryId.h"
+#include <QtCore/QByteArray>
+#include <QtCore/QUuid>
+#include <cstring>
+#include <stdexcept>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+}
+
+EntryId EntryId::generate() {
+    QByteArray raw = QUuid::createUuid().toRfc4122();
+    
+    Bytes bytes;
+    std::memcpy(bytes.data(), raw.constData(), bytes.size());
+    return EntryId(bytes);
+}
+
+bool EntryId::parse(std::string_view text, EntryId& id) {
+    if (text.size() == 38 && text.front() == '{' && text.back() == '}') {
+        text = text.substr(1, 36);
+    }
+    if (text.size() != 36) {
+        return false;
+    }
+    
+    Bytes bytes;
+    size_t byte = 0;
+    for (size_t i = 0; i < text.size(); ) {
+        if (i == 8 || i == 13 || i == 18 || i == 23) {
+            if (text[i] != '-') {
+                return false;
+            }
+            ++i;
+            continue;
+        }
+        
+        int high = hexValue(text[i]);
+        int low = hexValue(text[i + 1]);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+        bytes[byte++] = static_cast<uint8_t>((high << 4) | low);
+        i += 2;
+    }
+    
+    id.bytes_ = bytes;
+    return true;
+}
+
+EntryId EntryId::fromString(std::string_view text) {
+    EntryId id;
+    if (!parse(text, id)) {
+        throw std::invalid_argument("Entry ID is not a UUID: " + std::string(text));
+    }
+    return id;
+}
+
+std::string EntryId::toString() const {
+    static const char digits[] = "0123456789abcdef";
+    
+    std::string text;
+    text.reserve(36);
+    for (size_t i = 0; i < bytes_.size(); ++i) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) {
+            text.push_back('-');
+        }
+        text.push_back(digits[bytes_[i] >> 4]);
+        text.push_back(digits[bytes_[i] & 0x0F]);
+    }
+    return text;
+}
+
+size_t EntryId::hash() const {
+    uint64_t high, low;
+    std::memcpy(&high, bytes_.data(), sizeof(high));
+    std::memcpy(&low, bytes_.data() + sizeof(high), sizeof(low));
+    return static_cast<size_t>(high ^ (low * 0x9E3779B97F4A7C15ULL));
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,259 @@
+#include "core/EntryTable.h"
+#include "core/SecureMemory.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    // Compact once garbage exceeds this and outweighs live text
+    constexpr size_t COMPACT_MIN_GARBAGE = 1 << 20;
+    
+    uint16_t checkedLength(const std::string& field, const char* name) {
+        if (field.size() > std::numeric_limits<uint16_t>::max()) {
+            throw std::invalid_argument(std::string("Entry ") + name + " is too long");
+        }
+        return static_cast<uint16_t>(field.size());
+    }
+}
+
+EntryTable::EntryTable() : garbage_bytes_(0) {
+}
+
+EntryTable::EntryTable(const EntryTable& other) : garbage_bytes_(0) {
+    reserve(other.size(), other.text_.size() - other.garbage_bytes_);
+    appendRows(other);
+}
+
+EntryTable::~EntryTable() {
+    clear();
+}
+
+void EntryTable::reserve(size_t rows, size_t textBytes) {
+    ids_.reserve(rows);
+    created_at_.reserve(rows);
+    last_used_at_.reserve(rows);
+    fingerprint_index_.reserve(rows);
+    text_spans_.reserve(rows);
+    if (textBytes > text_.capacity()) {
+        std::string grown;
+        grown.reserve(textBytes);
+        grown.append(text_);
+        SecureMemory::secureZero(text_);
+        text_.swap(grown);
+    }
+}
+
+void EntryTable::clear() {
+    // The arena holds password ciphertext
+    SecureMemory::secureZero(text_);
+    text_.shrink_to_fit();
+    garbage_bytes_ = 0;
+    
+    ids_.clear();
+    created_at_.clear();
+    last_used_at_.clear();
+    fingerprint_index_.clear();
+    text_spans_.clear();
+    
+    fingerprints_.clear();
+    fingerprint_lookup_.clear();
+}
+
+size_t EntryTable::append(const VaultEntry& entry) {
+    TextSpan span = appendText(entry);
+    
+    ids_.push_back(entry.id);
+    created_at_.push_back(entry.created_at);
+    last_used_at_.push_back(entry.last_used_at);
+    fingerprint_index_.push_back(internFingerprint(entry.device_fingerprint));
+    text_spans_.push_back(span);
+    
+    return ids_.size() - 1;
+}
+
+void EntryTable::appendRows(const EntryTable& other) {
+    size_t liveText = other.text_.size() - other.garbage_bytes_;
+    if (text_.size() + liveText > std::numeric_limits<uint32_t>::max()) {
+        compact();
+        if (text_.size() + liveText > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Entry table text arena is full");
+        }
+    }
+    
+    ids_.insert(ids_.end(), other.ids_.begin(), other.ids_.end());
+    created_at_.insert(created_at_.end(), other.created_at_.begin(), other.created_at_.end());
+    last_used_at_.insert(last_used_at_.end(), other.last_used_at_.begin(), other.last_used_at_.end());
+    
+    // Fingerprints are re-interned; text is copied span by span so the
+    // other table's garbage is left behind
+    std::vector<uint32_t> fingerprintMap(other.fingerprints_.size());
+    for (size_t i = 0; i < other.fingerprints_.size(); ++i) {
+        fingerprintMap[i] = internFingerprint(other.fingerprints_[i]);
+    }
+    
+    for (size_t row = 0; row < other.size(); ++row) {
+        fingerprint_index_.push_back(fingerprintMap[other.fingerprint_index_[row]]);
+        
+        TextSpan span = other.text_spans_[row];
+        size_t length = spanLength(span);
+        appendRaw(std::string_view(other.text_).substr(span.offset, length));
+        span.offset = static_cast<uint32_t>(text_.size() - length);
+        text_spans_.push_back(span);
+    }
+}
+
+void EntryTable::assign(size_t row, const VaultEntry& entry) {
+    size_t oldLength = spanLength(text_spans_[row]);
+    TextSpan span = appendText(entry);
+    garbage_bytes_ += oldLength;
+    
+    ids_[row] = entry.id;
+    created_at_[row] = entry.created_at;
+    last_used_at_[row] = entry.last_used_at;
+    fingerprint_index_[row] = internFingerprint(entry.device_fingerprint);
+    text_spans_[row] = span;
+    
+    maybeCompact();
+}
+
+void EntryTable::erase(size_t row) {
+    garbage_bytes_ += spanLength(text_spans_[row]);
+    
+    auto offset = static_cast<std::ptrdiff_t>(row);
+    ids_.erase(ids_.begin() + offset);
+    created_at_.erase(created_at_.begin() + offset);
+    last_used_at_.erase(last_used_at_.begin() + offset);
+    fingerprint_index_.erase(fingerprint_index_.begin() + offset);
+    text_spans_.erase(text_spans_.begin() + offset);
+    
+    maybeCompact();
+}
+
+std::string_view EntryTable::label(size_t row) const {
+    const TextSpan& span = text_spans_[row];
+    return std::string_view(text_.data() + span.offset, span.label_length);
+}
+
+std::string_view EntryTable::username(size_t row) const {
+    const TextSpan& span = text_spans_[row];
+    return std::string_view(text_.data() + span.offset + span.label_length, span.username_length);
+}
+
+std::string_view EntryTable::password(size_t row) const {
+    const TextSpan& span = text_spans_[row];
+    return std::string_view(text_.data() + span.offset + span.label_length + span.username_length,
+                            span.password_length);
+}
+
+std::string_view EntryTable::deviceFingerprint(size_t row) const {
+    return fingerprints_[fingerprint_index_[row]];
+}
+
+EntryView EntryTable::view(size_t row) const {
+    return {ids_[row], label(row), username(row), created_at_[row], last_used_at_[row],
+            deviceFingerprint(row), nullptr};
+}
+
+VaultEntry EntryTable::materialize(size_t row) const {
+    VaultEntry entry;
+    materialize(row, entry);
+    return entry;
+}
+
+void EntryTable::materialize(size_t row, VaultEntry& entry) const {
+    entry.id = ids_[row];
+    entry.label.assign(label(row));
+    entry.username.assign(username(row));
+    entry.password.assign(password(row));
+    entry.created_at = created_at_[row];
+    entry.last_used_at = last_used_at_[row];
+    entry.device_fingerprint.assign(deviceFingerprint(row));
+}
+
+size_t EntryTable::memoryUsage() const {
+    size_t bytes = ids_.capacity() * sizeof(EntryId) +
+                   created_at_.capacity() * sizeof(Timestamp) +
+                   last_used_at_.capacity() * sizeof(Timestamp) +
+                   fingerprint_index_.capacity() * sizeof(uint32_t) +
+                   text_spans_.capacity() * sizeof(TextSpan) +
+                   text_.capacity();
+    for (const auto& fingerprint : fingerprints_) {
+        bytes += sizeof(fingerprint) + fingerprint.capacity();
+    }
+    return bytes;
+}
+
+void EntryTable::compact() {
+    if (garbage_bytes_ == 0) {
+        return;
+    }
+    
+    std::string compacted;
+    compacted.reserve(text_.size() - garbage_bytes_);
+    for (TextSpan& span : text_spans_) {
+        size_t length = spanLength(span);
+        auto offset = static_cast<uint32_t>(compacted.size());
+        compacted.append(text_, span.offset, length);
+        span.offset = offset;
+    }
+    
+    SecureMemory::secureZero(text_);
+    text_.swap(compacted);
+    garbage_bytes_ = 0;
+}
+
+EntryTable::TextSpan EntryTable::appendText(const VaultEntry& entry) {
+    TextSpan span;
+    span.label_length = checkedLength(entry.label, "label");
+    span.username_length = checkedLength(entry.username, "username");
+    span.password_length = checkedLength(entry.password, "password");
+    
+    if (text_.size() + spanLength(span) > std::numeric_limits<uint32_t>::max()) {
+        compact();
+        if (text_.size() + spanLength(span) > std::numeric_limits<uint32_t>::max()) {
+            throw std::length_error("Entry table text arena is full");
+        }
+    }
+    
+    span.offset = static_cast<uint32_t>(text_.size());
+    appendRaw(entry.label);
+    appendRaw(entry.username);
+    appendRaw(entry.password);
+    return span;
+}
+
+void EntryTable::appendRaw(std::string_view text) {
+    // Grow by hand so the outgrown buffer (with ciphertext) is wiped, not just freed
+    if (text_.size() + text.size() > text_.capacity()) {
+        std::string grown;
+        grown.reserve(std::max(text_.capacity() * 2, text_.size() + text.size()));
+        grown.append(text_);
+        SecureMemory::secureZero(text_);
+        text_.swap(grown);
+    }
+    text_.append(text);
+}
+
+uint32_t EntryTable::internFingerprint(const std::string& fingerprint) {
+    auto it = fingerprint_lookup_.find(fingerprint);
+    if (it != fingerprint_lookup_.end()) {
+        return it->second;
+    }
+    
+    auto index = static_cast<uint32_t>(fingerprints_.size());
+    fingerprints_.push_back(fingerprint);
+    fingerprint_lookup_.emplace(fingerprint, index);
+    return index;
+}
+
+void EntryTable::maybeCompact() {
+    if (garbage_bytes_ >= COMPACT_MIN_GARBAGE && garbage_bytes_ > text_.size() / 2) {
+        compact();
+    }
+}
+
+} // namespace core
+} // namespace crimson
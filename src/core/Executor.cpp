@@ -0,0 +1,322 @@
+#include "core/Executor.h"
+#include <QtCore/QCoreApplication>
+#include <QtCore/QMetaObject>
+#include <algorithm>
+#include <cstdlib>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    // Which pool, and which of its workers, the current thread is
+    thread_local const Executor* current_executor = nullptr;
+    thread_local size_t current_worker = 0;
+    
+    std::mutex shared_mutex;
+    unsigned shared_thread_count = 0;
+    bool shared_created = false;
+    
+    unsigned threadsFromEnvironment() {
+        const char* value = std::getenv("CRIMSON_THREADS");
+        if (!value || !*value) {
+            return 0;
+        }
+        char* end = nullptr;
+        unsigned long threads = std::strtoul(value, &end, 10);
+        return *end == '\0' && threads <= 1024 ? static_cast<unsigned>(threads) : 0;
+    }
+}
+
+CancellationToken CancellationToken::create() {
+    CancellationToken token;
+    token.cancelled_ = std::make_shared<std::atomic<bool>>(false);
+    return token;
+}
+
+void CancellationToken::cancel() const {
+    if (cancelled_) {
+        cancelled_->store(true);
+    }
+}
+
+void CancellationToken::throwIfCancelled() const {
+    if (isCancelled()) {
+        throw OperationCancelled();
+    }
+}
+
+Executor::Executor(unsigned threads)
+    : queued_(0)
+    , idle_(0)
+    , stopping_(false) {
+    
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    local_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        local_.push_back(std::make_unique<Queue>());
+    }
+    threads_.reserve(threads);
+    for (unsigned i = 0; i < threads; ++i) {
+        threads_.emplace_back(&Executor::workerLoop, this, i);
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+Executor& Executor::shared() {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    // Never destroyed: workers may still be running when static
+    // destructors start, and nothing they touch should go first
+    static Executor* executor = nullptr;
+    if (!executor) {
+        unsigned threads = shared_thread_count ? shared_thread_count : threadsFromEnvironment();
+        executor = new Executor(threads);
+        shared_created = true;
+    }
+    return *executor;
+}
+
+void Executor::setSharedThreadCount(unsigned threads) {
+    std::lock_guard<std::mutex> lock(shared_mutex);
+    if (shared_created) {
+        throw std::logic_error("The shared executor is already running");
+    }
+    shared_thread_count = threads;
+}
+
+void Executor::post(std::function<void()> task, Priority priority) {
+    Queue& queue = current_executor == this ? *local_[current_worker] : injected_;
+    
+    // Counted before it is visible, so the count never drops below zero
+    queued_.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.lanes[static_cast<size_t>(priority)].push_back(std::move(task));
+    }
+    
+    if (idle_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+        wake_.notify_one();
+    }
+}
+
+void Executor::postToMainThread(QPointer<QObject> guard, bool guarded, std::function<void()> fn) {
+    auto deliver = [guard, guarded, fn]() {
+        if (!guarded || !guard.isNull()) {
+            fn();
+        }
+    };
+    
+    QCoreApplication* application = QCoreApplication::instance();
+    if (!application) {
+        deliver();
+        return;
+    }
+    QMetaObject::invokeMethod(application, deliver, Qt::QueuedConnection);
+}
+
+void Executor::workerLoop(size_t index) {
+    current_executor = this;
+    current_worker = index;
+    
+    std::function<void()> task;
+    for (;;) {
+        if (take(index, task)) {
+            task();
+            task = nullptr;   // Release captures before sleeping
+            continue;
+        }
+        
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        if (stopping_ && queued_.load() == 0) {
+            return;
+        }
+        idle_.fetch_add(1);
+        wake_.wait(lock, [this] { return queued_.load() > 0 || stopping_; });
+        idle_.fetch_sub(1);
+    }
+}
+
+bool Executor::take(size_t index, std::function<void()>& task) {
+    if (queued_.load() == 0) {
+        return false;
+    }
+    
+    const size_t workers = local_.size();
+    for (size_t lane = 0; lane < PRIORITY_LANES; ++lane) {
+        {
+            Queue& own = *local_[index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.lanes[lane].empty()) {
+                task = std::move(own.lanes[lane].back());
+                own.lanes[lane].pop_back();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(injected_.mutex);
+            if (!injected_.lanes[lane].empty()) {
+                task = std::move(injected_.lanes[lane].front());
+                injected_.lanes[lane].pop_front();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+        for (size_t offset = 1; offset < workers; ++offset) {
+            Queue& victim = *local_[(index + offset) % workers];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.lanes[lane].empty()) {
+                task = std::move(victim.lanes[lane].front());
+                victim.lanes[lane].pop_front();
+                queued_.fetch_sub(1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+TaskGroup::TaskGroup(Executor::Priority priority, CancellationToken token, Executor& executor)
+    : executor_(executor)
+    , priority_(priority)
+    , token_(std::move(token))
+    , state_(std::make_shared<State>()) {
+}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->unstarted.push_back(std::move(task));
+        ++state_->unfinished;
+    }
+    
+    // Each runner starts at most one task; whichever of them, or wait(),
+    // gets to a task first runs it
+    executor_.post([state = state_, token = token_]() {
+        runOne(*state, token);
+    }, priority_);
+}
+
+void TaskGroup::wait() {
+    while (runOne(*state_, token_)) {
+    }
+    
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->finished.wait(lock, [this] { return state_->unfinished == 0; });
+    std::exception_ptr error = state_->error;
+    state_->error = nullptr;
+    lock.unlock();
+    
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+bool TaskGroup::runOne(State& state, const CancellationToken& token) {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        if (state.unstarted.empty()) {
+            return false;
+        }
+        task = std::move(state.unstarted.front());
+        state.unstarted.pop_front();
+    }
+    
+    std::exception_ptr error;
+    try {
+        token.throwIfCancelled();
+        task();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    task = nullptr;
+    
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (error && !state.error) {
+        state.error = error;
+    }
+    if (--state.unfinished == 0) {
+        state.finished.notify_all();
+    }
+    return true;
+}
+
+Strand::Strand(Executor::Priority priority, Executor& executor)
+    : executor_(executor)
+    , priority_(priority)
+    , state_(std::make_shared<State>()) {
+}
+
+Strand::~Strand() {
+    wait();
+}
+
+void Strand::post(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->tasks.push_back(std::move(task));
+    if (state_->running) {
+        return;
+    }
+    
+    state_->running = true;
+    executor_.post([state = state_, &executor = executor_, priority = priority_]() {
+        runNext(state, executor, priority);
+    }, priority_);
+}
+
+void Strand::wait() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->idle.wait(lock, [this] { return !state_->running; });
+}
+
+void Strand::runNext(const std::shared_ptr<State>& state, Executor& executor, Executor::Priority priority) {
+    std::function<void()> task;
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        task = std::move(state->tasks.front());
+        state->tasks.pop_front();
+    }
+    
+    try {
+        task();
+    } catch (...) {
+        // Tasks report their own errors; the strand must keep going
+    }
+    task = nullptr;
+    
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->tasks.empty()) {
+        state->running = false;
+        state->idle.notify_all();
+        return;
+    }
+    // Requeued rather than looped, so the strand yields to other work
+    executor.post([state, &executor, priority]() {
+        runNext(state, executor, priority);
+    }, priority);
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,169 @@
+#include "core/FileUtil.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace crimson {
+namespace core {
+
+namespace {
+#ifdef _WIN32
+    // Paths are UTF-8; the wide API is the only one that takes all of them
+    std::wstring toWide(const std::string& path) {
+        int length = MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), nullptr, 0);
+        std::wstring wide(static_cast<size_t>(length), L'\0');
+        if (length > 0) {
+            MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), &wide[0], length);
+        }
+        return wide;
+    }
+#else
+    bool syncDescriptor(int fd) {
+#ifdef __APPLE__
+        // fsync() leaves the data in the drive's cache here
+        if (::fcntl(fd, F_FULLFSYNC) == 0) {
+            return true;
+        }
+#endif
+        while (::fsync(fd) != 0) {
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    bool syncParentDirectory(const std::string& path) {
+        size_t slash = path.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : path.substr(0, std::max<size_t>(slash, 1));
+        
+        int fd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+        // Some file systems cannot sync a directory, and say so with EINVAL
+        bool synced = syncDescriptor(fd) || errno == EINVAL;
+        ::close(fd);
+        return synced;
+    }
+#endif
+}
+
+AtomicFile::AtomicFile(const std::string& path)
+    : path_(path)
+    , temporary_(path + ".tmp")
+    , committed_(false) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(toWide(temporary_).c_str(), GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    handle_ = file == INVALID_HANDLE_VALUE ? nullptr : file;
+#else
+    fd_ = ::open(temporary_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+#endif
+}
+
+AtomicFile::~AtomicFile() {
+    if (isOpen()) {
+        close();
+    }
+    if (!committed_) {
+#ifdef _WIN32
+        DeleteFileW(toWide(temporary_).c_str());
+#else
+        std::remove(temporary_.c_str());
+#endif
+    }
+}
+
+bool AtomicFile::isOpen() const {
+#ifdef _WIN32
+    return handle_ != nullptr;
+#else
+    return fd_ >= 0;
+#endif
+}
+
+void AtomicFile::close() {
+#ifdef _WIN32
+    CloseHandle(handle_);
+    handle_ = nullptr;
+#else
+    ::close(fd_);
+    fd_ = -1;
+#endif
+}
+
+bool AtomicFile::write(const char* data, size_t size) {
+    if (!isOpen()) {
+        return false;
+    }
+    
+    while (size > 0) {
+#ifdef _WIN32
+        DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, 1u << 30));
+        DWORD written = 0;
+        if (!WriteFile(handle_, data, chunk, &written, nullptr)) {
+            return false;
+        }
+#else
+        ssize_t written = ::write(fd_, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+#endif
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool AtomicFile::sync() {
+    if (!isOpen()) {
+        return false;
+    }
+#ifdef _WIN32
+    return FlushFileBuffers(handle_) != 0;
+#else
+    return syncDescriptor(fd_);
+#endif
+}
+
+bool AtomicFile::commit() {
+    if (!isOpen()) {
+        return false;
+    }
+    close();
+    
+#ifdef _WIN32
+    // Replaces the file in one step; the destination is never deleted
+    // first, as a crash in between would lose both copies. Write-through
+    // returns only once the rename is on the disk
+    committed_ = MoveFileExW(toWide(temporary_).c_str(), toWide(path_).c_str(),
+                             MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    return committed_;
+#else
+    committed_ = std::rename(temporary_.c_str(), path_.c_str()) == 0;
+    
+    // The rename is a change to the directory, which needs a sync of its
+    // own to survive a power loss
+    return committed_ && syncParentDirectory(path_);
+#endif
+}
+
+bool writeFileAtomically(const std::string& path, const std::string& content) {
+    AtomicFile file(path);
+    return file.write(content.data(), content.size()) && file.sync() && file.commit();
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,145 @@
+#include "core/JsonStructuralIndex.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define CRIMSON_JSON_SSE2 1
+#endif
+
+namespace crimson {
+namespace core {
+
+namespace {
+    struct BlockMasks {
+        uint64_t quote;
+        uint64_t backslash;
+        uint64_t op;
+    };
+
+#ifdef CRIMSON_JSON_SSE2
+    BlockMasks classify(const char* block) {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i lowercase = _mm_set1_epi8(0x20);
+        const __m128i openBrace = _mm_set1_epi8('{');
+        const __m128i closeBrace = _mm_set1_epi8('}');
+        const __m128i colon = _mm_set1_epi8(':');
+        const __m128i comma = _mm_set1_epi8(',');
+        
+        BlockMasks masks{0, 0, 0};
+        for (int i = 0; i < 4; ++i) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+            // '[' | 0x20 == '{' and ']' | 0x20 == '}'
+            __m128i folded = _mm_or_si128(chunk, lowercase);
+            __m128i op = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+                _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma)));
+            
+            int shift = 16 * i;
+            masks.quote |= static_cast<uint64_t>(static_cast<uint16_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, quote)))) << shift;
+            masks.backslash |= static_cast<uint64_t>(static_cast<uint16_t>(
+                _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, backslash)))) << shift;
+            masks.op |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(op))) << shift;
+        }
+        return masks;
+    }
+#else
+    BlockMasks classify(const char* block) {
+        BlockMasks masks{0, 0, 0};
+        for (int i = 0; i < 64; ++i) {
+            uint64_t bit = uint64_t(1) << i;
+            switch (block[i]) {
+            case '"':  masks.quote |= bit; break;
+            case '\\': masks.backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                masks.op |= bit;
+                break;
+            default:
+                break;
+            }
+        }
+        return masks;
+    }
+#endif
+    
+    int lowestBit(uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(mask);
+#else
+        int index = 0;
+        while (!(mask & 1)) {
+            mask >>= 1;
+            ++index;
+        }
+        return index;
+#endif
+    }
+    
+    // Bit i set iff an odd number of bits at or below i are set
+    uint64_t prefixXor(uint64_t mask) {
+        mask ^= mask << 1;
+        mask ^= mask << 2;
+        mask ^= mask << 4;
+        mask ^= mask << 8;
+        mask ^= mask << 16;
+        mask ^= mask << 32;
+        return mask;
+    }
+}
+
+JsonStructuralIndex::JsonStructuralIndex() {
+    reset();
+}
+
+void JsonStructuralIndex::reset() {
+    prev_in_string_ = 0;
+    prev_escaped_ = 0;
+}
+
+void JsonStructuralIndex::scan(const char* data, size_t length, uint64_t base, std::vector<uint64_t>& offsets) {
+    size_t whole = length - length % BLOCK_BYTES;
+    for (size_t pos = 0; pos < whole; pos += BLOCK_BYTES) {
+        scanBlock(data + pos, base + pos, offsets);
+    }
+    
+    if (whole < length) {
+        // Pad the tail with spaces, which are never structural
+        char block[BLOCK_BYTES];
+        std::memset(block, ' ', sizeof(block));
+        std::memcpy(block, data + whole, length - whole);
+        scanBlock(block, base + whole, offsets);
+    }
+}
+
+void JsonStructuralIndex::scanBlock(const char* block, uint64_t base, std::vector<uint64_t>& offsets) {
+    BlockMasks masks = classify(block);
+    
+    // Characters escaped by a backslash. Backslashes are rare in vault
+    // files, so runs are resolved bit by bit only when there are any
+    uint64_t escaped = prev_escaped_;
+    prev_escaped_ = 0;
+    uint64_t escapes = masks.backslash & ~escaped;
+    while (escapes) {
+        int bit = lowestBit(escapes);
+        if (bit == 63) {
+            prev_escaped_ = 1;
+            break;
+        }
+        escaped |= uint64_t(1) << (bit + 1);
+        escapes &= bit + 2 < 64 ? ~((uint64_t(1) << (bit + 2)) - 1) : 0;
+    }
+    
+    uint64_t quotes = masks.quote & ~escaped;
+    uint64_t inString = prefixXor(quotes) ^ prev_in_string_;
+    prev_in_string_ = static_cast<uint64_t>(static_cast<int64_t>(inString) >> 63);
+    
+    uint64_t structural = (masks.op & ~inString) | quotes;
+    while (structural) {
+        offsets.push_back(base + static_cast<uint64_t>(lowestBit(structural)));
+        structural &= structural - 1;
+    }
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,183 @@
+#include "core/MappedFile.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace crimson {
+namespace core {
+
+MappedFile::MappedFile()
+    : data_(nullptr), size_(0), open_(false)
+#ifdef _WIN32
+    , file_handle_(nullptr), mapping_handle_(nullptr)
+#endif
+{
+}
+
+MappedFile::MappedFile(const std::string& path) : MappedFile() {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Failed to open file for mapping");
+    }
+    
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::runtime_error("Failed to query file size");
+    }
+    
+    file_handle_ = file;
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    open_ = true;
+    
+    if (size_ > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            release();
+            throw std::runtime_error("Failed to map file");
+        }
+        mapping_handle_ = mapping;
+        
+        data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!data_) {
+            release();
+            throw std::runtime_error("Failed to map file");
+        }
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file for mapping");
+    }
+    
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Failed to query file size");
+    }
+    
+    size_ = static_cast<size_t>(st.st_size);
+    open_ = true;
+    
+    if (size_ > 0) {
+        void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            open_ = false;
+            throw std::runtime_error("Failed to map file");
+        }
+        data_ = static_cast<const uint8_t*>(addr);
+    }
+    
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    release();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(other.data_), size_(other.size_), open_(other.open_)
+#ifdef _WIN32
+    , file_handle_(other.file_handle_), mapping_handle_(other.mapping_handle_)
+#endif
+{
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.open_ = false;
+#ifdef _WIN32
+    other.file_handle_ = nullptr;
+    other.mapping_handle_ = nullptr;
+#endif
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(open_, other.open_);
+#ifdef _WIN32
+        std::swap(file_handle_, other.file_handle_);
+        std::swap(mapping_handle_, other.mapping_handle_);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::adviseSequential() const {
+#ifndef _WIN32
+    if (data_) {
+        ::madvise(const_cast<uint8_t*>(data_), size_, MADV_SEQUENTIAL);
+    }
+#endif
+}
+
+void MappedFile::adviseRandom() const {
+#ifndef _WIN32
+    if (data_) {
+        ::madvise(const_cast<uint8_t*>(data_), size_, MADV_RANDOM);
+    }
+#endif
+}
+
+void MappedFile::discard(size_t offset, size_t length) const {
+#ifndef _WIN32
+    if (!data_ || offset >= size_) {
+        return;
+    }
+    length = std::min(length, size_ - offset);
+    
+    static const uintptr_t pageSize = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+    uintptr_t begin = reinterpret_cast<uintptr_t>(data_ + offset);
+    uintptr_t end = begin + length;
+    begin = (begin + pageSize - 1) & ~(pageSize - 1);
+    end &= ~(pageSize - 1);
+    if (begin < end) {
+        ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)length;
+#endif
+}
+
+void MappedFile::release() {
+#ifdef _WIN32
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_handle_) {
+        CloseHandle(mapping_handle_);
+        mapping_handle_ = nullptr;
+    }
+    if (file_handle_) {
+        CloseHandle(file_handle_);
+        file_handle_ = nullptr;
+    }
+#else
+    if (data_) {
+        ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    open_ = false;
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,264 @@
+#include "core/Metrics.h"
+#include "core/EntryCodec.h"
+#include "core/FileUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    constexpr double NANOS_PER_SECOND = 1e9;
+    
+    double seconds(uint64_t nanos) {
+        return double(nanos) / NANOS_PER_SECOND;
+    }
+    
+    // Index of the highest set bit; value must not be 0
+    int highestBit(uint64_t value) {
+        int bit = 0;
+        for (int step = 32; step > 0; step /= 2) {
+            if (value >> step) {
+                value >>= step;
+                bit += step;
+            }
+        }
+        return bit;
+    }
+    
+    void appendNumber(double value, std::string& out) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        out += buffer;
+    }
+    
+    // Operation names are ours, but escaped anyway: \ " and newline
+    void appendLabelValue(const std::string& value, std::string& out) {
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                out += '\\';
+                out += c;
+            } else if (c == '\n') {
+                out += "\\n";
+            } else {
+                out += c;
+            }
+        }
+    }
+}
+
+LatencyHistogram::LatencyHistogram()
+    : sum_(0)
+    , max_(0) {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketOf(uint64_t nanos) {
+    if (nanos < SUB_BUCKETS) {
+        return static_cast<size_t>(nanos);
+    }
+    // The top SUB_BUCKET_BITS + 1 bits pick the bucket within the doubling
+    int msb = highestBit(nanos);
+    unsigned shift = static_cast<unsigned>(msb) - SUB_BUCKET_BITS;
+    size_t sub = static_cast<size_t>(nanos >> shift) - SUB_BUCKETS;
+    return SUB_BUCKETS + shift * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketFloor(size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+    size_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    size_t sub = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return static_cast<uint64_t>(SUB_BUCKETS + sub) << shift;
+}
+
+void LatencyHistogram::record(uint64_t nanos) {
+    buckets_[bucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(nanos, std::memory_order_relaxed);
+    
+    uint64_t seen = max_.load(std::memory_order_relaxed);
+    while (nanos > seen && !max_.compare_exchange_weak(seen, nanos, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot copy;
+    copy.buckets.resize(BUCKETS);
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+        copy.buckets[i] = n;
+        copy.count += n;   // From the buckets, so percentiles are consistent with it
+    }
+    if (copy.count == 0) {
+        copy.buckets.clear();
+    }
+    copy.sumNanos = sum_.load(std::memory_order_relaxed);
+    copy.maxNanos = max_.load(std::memory_order_relaxed);
+    return copy;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::Snapshot::percentile(double quantile) const {
+    if (count == 0) {
+        return 0;
+    }
+    quantile = std::min(1.0, std::max(0.0, quantile));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(quantile * double(count) + 0.5));
+    
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            // Midpoint of the bucket, never above the largest value seen
+            uint64_t floor = bucketFloor(i);
+            uint64_t width = (i + 1 < BUCKETS ? bucketFloor(i + 1) : floor) - floor;
+            return std::min(maxNanos, floor + width / 2);
+        }
+    }
+    return maxNanos;
+}
+
+MetricsRegistry& MetricsRegistry::global() {
+    // Never destroyed: operations may still finish while statics are torn down
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+OperationMetrics& MetricsRegistry::operation(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& slot = operations_[name];
+    if (!slot) {
+        slot = std::make_unique<OperationMetrics>();
+    }
+    return *slot;
+}
+
+std::vector<MetricsRegistry::OperationSummary> MetricsRegistry::summaries() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<OperationSummary> result;
+    result.reserve(operations_.size());
+    
+    for (const auto& [name, metrics] : operations_) {
+        LatencyHistogram::Snapshot latency = metrics->latency.snapshot();
+        uint64_t failures = metrics->failures.value();
+        if (latency.count == 0 && failures == 0) {
+            continue;
+        }
+        
+        OperationSummary summary;
+        summary.name = name;
+        summary.count = latency.count;
+        summary.failures = failures;
+        summary.sumSeconds = seconds(latency.sumNanos);
+        summary.meanSeconds = latency.meanNanos() / NANOS_PER_SECOND;
+        summary.p50Seconds = seconds(latency.percentile(0.50));
+        summary.p90Seconds = seconds(latency.percentile(0.90));
+        summary.p99Seconds = seconds(latency.percentile(0.99));
+        summary.p999Seconds = seconds(latency.percentile(0.999));
+        summary.maxSeconds = seconds(latency.maxNanos);
+        result.push_back(std::move(summary));
+    }
+    return result;
+}
+
+void MetricsRegistry::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : operations_) {
+        entry.second->latency.reset();
+        entry.second->failures.reset();
+    }
+}
+
+std::string MetricsRegistry::toPrometheus() const {
+    const std::vector<OperationSummary> operations = summaries();
+    std::string out;
+    
+    out += "# HELP crimson_operation_duration_seconds Latency of vault and crypto operations\n";
+    out += "# TYPE crimson_operation_duration_seconds summary\n";
+    for (const auto& op : operations) {
+        const std::pair<const char*, double> quantiles[] = {
+            {"0.5", op.p50Seconds}, {"0.9", op.p90Seconds}, {"0.99", op.p99Seconds}, {"0.999", op.p999Seconds}
+        };
+        for (const auto& [quantile, value] : quantiles) {
+            out += "crimson_operation_duration_seconds{operation=\"";
+            appendLabelValue(op.name, out);
+            out += "\",quantile=\"";
+            out += quantile;
+            out += "\"} ";
+            appendNumber(value, out);
+            out += '\n';
+        }
+        out += "crimson_operation_duration_seconds_sum{operation=\"";
+        appendLabelValue(op.name, out);
+        out += "\"} ";
+        appendNumber(op.sumSeconds, out);
+        out += "\ncrimson_operation_duration_seconds_count{operation=\"";
+        appendLabelValue(op.name, out);
+        out += "\"} " + std::to_string(op.count) + '\n';
+    }
+    
+    out += "# HELP crimson_operation_duration_max_seconds Slowest call of each operation\n";
+    out += "# TYPE crimson_operation_duration_max_seconds gauge\n";
+    for (const auto& op : operations) {
+        out += "crimson_operation_duration_max_seconds{operation=\"";
+        appendLabelValue(op.name, out);
+        out += "\"} ";
+        appendNumber(op.maxSeconds, out);
+        out += '\n';
+    }
+    
+    out += "# HELP crimson_operation_failures_total Calls that failed or threw\n";
+    out += "# TYPE crimson_operation_failures_total counter\n";
+    for (const auto& op : operations) {
+        out += "crimson_operation_failures_total{operation=\"";
+        appendLabelValue(op.name, out);
+        out += "\"} " + std::to_string(op.failures) + '\n';
+    }
+    return out;
+}
+
+std::string MetricsRegistry::toJson() const {
+    const std::vector<OperationSummary> operations = summaries();
+    std::string out = "{\"operations\": [";
+    
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const OperationSummary& op = operations[i];
+        out += i == 0 ? "{\"name\": " : ", {\"name\": ";
+        EntryCodec::appendJsonString(op.name, out);
+        out += ", \"count\": " + std::to_string(op.count);
+        out += ", \"failures\": " + std::to_string(op.failures);
+        
+        const std::pair<const char*, double> fields[] = {
+            {"sum_seconds", op.sumSeconds}, {"mean_seconds", op.meanSeconds},
+            {"p50_seconds", op.p50Seconds}, {"p90_seconds", op.p90Seconds},
+            {"p99_seconds", op.p99Seconds}, {"p999_seconds", op.p999Seconds},
+            {"max_seconds", op.maxSeconds}
+        };
+        for (const auto& [field, value] : fields) {
+            out += ", \"";
+            out += field;
+            out += "\": ";
+            appendNumber(value, out);
+        }
+        out += '}';
+    }
+    out += "]}";
+    return out;
+}
+
+bool MetricsRegistry::writeFile(const std::string& path, bool prometheus) const {
+    return writeFileAtomically(path, prometheus ? toPrometheus() : toJson() + '\n');
+}
+
+} // namespace core
+} // namespace crimson
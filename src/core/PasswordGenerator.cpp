@@ -6,70 +6,103 @@
 #include <stdexcept>
 #include <fstream>
 #include <array>
+#include <cstring>
 
 namespace crimson {
 namespace core {
 
-// Character sets for password generation
-const std::string PasswordGenerator::LOWERCASE_CHARS = "abcdefghijklmnopqrstuvwxyz";
-const std::string PasswordGenerator::UPPERCASE_CHARS = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-const std::string PasswordGenerator::DIGIT_CHARS = "0123456789";
-const std::string PasswordGenerator::SYMBOL_CHARS = "!@#$%^&*()_+-=[]{}|;:,.<>?";
+PasswordBatch::PasswordBatch(size_t count, size_t length)
+    : count_(count), length_(length), buffer_(SecureMemory::createBuffer(count * length)) {
+}
 
-PasswordGenerator::PasswordGenerator() : hardware_rng_(), secure_prng_(hardware_rng_()) {
+PasswordGenerator::PasswordGenerator()
+    : hardware_rng_()
+    , secure_prng_(hardware_rng_())
+    , bytes_since_seed_(0)
+    , random_pool_()
+    , random_pool_pos_(random_pool_.size()) {
     seedPrng();
 }
 
 PasswordGenerator::~PasswordGenerator() {
-    // No sensitive data to clean up here
+    // Unconsumed pool bytes would reveal upcoming characters
+    SecureMemory::secureZero(random_pool_.data(), random_pool_.size());
 }
 
 std::string PasswordGenerator::generatePassword(size_t length, bool includeSymbols) {
-    if (length < 8) {
-        throw std::invalid_argument("Password length must be at least 8 characters");
-    }
+    return generatePassword(length, includeSymbols ? PasswordPolicy::standard()
+                                                   : PasswordPolicy::alphanumeric());
+}
+
+std::string PasswordGenerator::generatePassword(size_t length, const PasswordPolicy& policy) {
+    policy.validateLength(length);
+    
+    std::string password(length, '\0');
+    generateInto(policy, &password[0], length);
     
-    if (length > 512) {
-        throw std::invalid_argument("Password length cannot exceed 512 characters");
+    return password;
+}
+
+void PasswordGenerator::generatePassword(const PasswordPolicy& policy, char* out, size_t length) {
+    if (!out) {
+        throw std::invalid_argument("Invalid buffer parameters");
     }
     
-    // Build character set
-    std::string charset = LOWERCASE_CHARS + UPPERCASE_CHARS + DIGIT_CHARS;
-    if (includeSymbols) {
-        charset += SYMBOL_CHARS;
+    policy.validateLength(length);
+    generateInto(policy, out, length);
+}
+
+PasswordBatch PasswordGenerator::generatePasswords(size_t count, size_t length,
+                                                   const PasswordPolicy& policy) {
+    if (count == 0) {
+        throw std::invalid_argument("Password count must be at least 1");
     }
     
-    // Generate password ensuring at least one character from each required set
-    std::string password;
-    password.reserve(length);
+    policy.validateLength(length);
     
-    // Ensure at least one character from each required set
-    password += generateFromCharset(LOWERCASE_CHARS, 1);
-    password += generateFromCharset(UPPERCASE_CHARS, 1);
-    password += generateFromCharset(DIGIT_CHARS, 1);
+    PasswordBatch batch(count, length);
+    char* out = batch.data();
     
-    if (includeSymbols) {
-        password += generateFromCharset(SYMBOL_CHARS, 1);
+    for (size_t i = 0; i < count; ++i) {
+        generateInto(policy, out + i * length, length);
     }
     
-    // Fill remaining length with random characters from full charset
-    size_t remaining = length - password.length();
-    password += generateFromCharset(charset, remaining);
+    return batch;
+}
+
+Passphrase PasswordGenerator::generatePassphrase(const Wordlist& wordlist, size_t wordCount,
+                                                 char separator) {
+    if (wordCount < 3) {
+        throw std::invalid_argument("Passphrase must contain at least 3 words");
+    }
     
-    // Shuffle the password to avoid predictable patterns
-    std::shuffle(password.begin(), password.end(), secure_prng_);
+    if (wordCount > 64) {
+        throw std::invalid_argument("Passphrase cannot exceed 64 words");
+    }
     
-    return password;
+    const size_t words = wordlist.size();
+    
+    Passphrase passphrase;
+    passphrase.entropyBits = wordlist.bitsPerWord() * static_cast<double>(wordCount);
+    passphrase.text.reserve(wordCount * 10);
+    
+    for (size_t i = 0; i < wordCount; ++i) {
+        if (i > 0) {
+            passphrase.text += separator;
+        }
+        passphrase.text += wordlist.word(static_cast<size_t>(uniformIndex(words)));
+    }
+    
+    return passphrase;
 }
 
 std::string PasswordGenerator::generateUsername(const std::string& basePrefix) {
     std::string username = basePrefix;
     
     // Add random alphanumeric suffix
-    std::string charset = LOWERCASE_CHARS + UPPERCASE_CHARS + DIGIT_CHARS;
-    std::string suffix = generateFromCharset(charset, 8);
-    
-    username += suffix;
+    size_t prefixLength = username.size();
+    username.resize(prefixLength + 8);
+    generateFromTable(PasswordPolicy::alphanumeric().full(), &username[prefixLength], 8);
     
     return username;
 }
@@ -79,18 +112,7 @@ void PasswordGenerator::generateRandomBytes(uint8_t* buffer, size_t size) {
         throw std::invalid_argument("Invalid buffer parameters");
     }
     
-    // Re-seed periodically for extra security
-    static size_t bytes_generated = 0;
-    bytes_generated += size;
-    if (bytes_generated > 1024 * 1024) {  // Re-seed every 1MB
-        seedPrng();
-        bytes_generated = 0;
-    }
-    
-    // Generate random bytes using PRNG seeded with hardware entropy
-    for (size_t i = 0; i < size; ++i) {
-        buffer[i] = static_cast<uint8_t>(secure_prng_() & 0xFF);
-    }
+    fillRandom(buffer, size);
 }
 
 bool PasswordGenerator::isHardwareRngAvailable() {
@@ -150,21 +172,76 @@ void PasswordGenerator::seedPrng() {
     }
 }
 
-std::string PasswordGenerator::generateFromCharset(const std::string& charset, size_t length) {
-    if (charset.empty() || length == 0) {
-        return "";
+uint64_t PasswordGenerator::uniformIndex(uint64_t bound) {
+    // Reject the 2^64 mod bound lowest values so every index is equally likely
+    const uint64_t threshold = (0 - bound) % bound;
+    uint64_t value;
+    do {
+        value = secure_prng_();
+    } while (value < threshold);
+    
+    return value % bound;
+}
+
+void PasswordGenerator::fillRandom(uint8_t* buffer, size_t size) {
+    // Re-seed periodically for extra security
+    bytes_since_seed_ += size;
+    if (bytes_since_seed_ > 1024 * 1024) {  // Re-seed every 1MB
+        seedPrng();
+        bytes_since_seed_ = 0;
     }
     
-    std::string result;
-    result.reserve(length);
-    
-    std::uniform_int_distribution<size_t> dist(0, charset.length() - 1);
+    // Use all eight bytes of every PRNG output
+    size_t offset = 0;
+    while (offset + sizeof(uint64_t) <= size) {
+        uint64_t value = secure_prng_();
+        std::memcpy(buffer + offset, &value, sizeof(value));
+        offset += sizeof(value);
+    }
     
-    for (size_t i = 0; i < length; ++i) {
-        result += charset[dist(secure_prng_)];
+    if (offset < size) {
+        uint64_t value = secure_prng_();
+        std::memcpy(buffer + offset, &value, size - offset);
+        SecureMemory::secureZero(&value, sizeof(value));
+    }
+}
+
+void PasswordGenerator::generateFromTable(const CharsetTable& table, char* out, size_t length) {
+    const uint16_t limit = table.limit();
+    size_t produced = 0;
+    
+    while (produced < length) {
+        if (random_pool_pos_ == random_pool_.size()) {
+            fillRandom(random_pool_.data(), random_pool_.size());
+            random_pool_pos_ = 0;
+        }
+        
+        // Always store the candidate and only advance when the byte is unbiased
+        while (random_pool_pos_ < random_pool_.size() && produced < length) {
+            uint8_t byte = random_pool_[random_pool_pos_++];
+            out[produced] = table.lookup(byte);
+            produced += static_cast<size_t>(byte < limit);
+        }
+    }
+}
+
+void PasswordGenerator::generateInto(const PasswordPolicy& policy, char* out, size_t length) {
+    // Ensure the policy's minimum count from each required set
+    size_t position = 0;
+    for (size_t cls = 0; cls < CHAR_CLASS_COUNT; ++cls) {
+        auto charClass = static_cast<CharClass>(cls);
+        size_t minimum = policy.minimum(charClass);
+        if (minimum > 0) {
+            generateFromTable(policy.classTable(charClass), out + position, minimum);
+            position += minimum;
+        }
     }
     
-    return result;
+    // Fill remaining length with random characters from full charset
+    generateFromTable(policy.full(), out + position, length - position);
+    
+    // Shuffle the password to avoid predictable patterns
+    std::shuffle(out, out + length, secure_prng_);
 }
 
 } // namespace core
@@ -0,0 +1,28 @@
+#include "core/PasswordPolicy.h"
+#include <string>
+
+namespace crimson {
+namespace core {
+
+void PasswordPolicy::validateLength(size_t length) const {
+    if (length < min_length_) {
+        throw std::invalid_argument("Password length must be at least " +
+                                    std::to_string(min_length_) + " characters");
+    }
+    
+    if (length > max_length_) {
+        throw std::invalid_argument("Password length cannot exceed " +
+                                    std::to_string(max_length_) + " characters");
+    }
+}
+
+const PasswordPolicy& PasswordPolicy::standard() {
+    return policies::STANDARD;
+}
+
+const PasswordPolicy& PasswordPolicy::alphanumeric() {
+    return policies::ALPHANUMERIC;
+}
+
+} // namespace core
+} // namespace crimson
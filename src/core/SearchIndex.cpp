@@ -0,0 +1,349 @@
+#include "core/SearchIndex.h"
+#include <algorithm>
+#include <cctype>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    // Fuzzy matches must share at least half of the query's trigrams
+    constexpr double FUZZY_MIN_SCORE = 0.5;
+    
+    // Upper bound on candidates scored per fuzzy query
+    constexpr size_t FUZZY_MAX_CANDIDATES = 4096;
+    
+    // Compact once there are this many tombstones and they outnumber live docs
+    constexpr size_t COMPACT_MIN_DEAD = 1024;
+}
+
+SearchIndex::SearchIndex() : dead_(0) {
+    clear();
+}
+
+void SearchIndex::add(const EntryId& id, const std::string& label, const std::string& username) {
+    remove(id);
+    
+    insertDoc({id, label, 0, 0, 0, true}, normalize(label), normalize(username));
+}
+
+void SearchIndex::remove(const EntryId& id) {
+    auto it = doc_by_id_.find(id);
+    if (it == doc_by_id_.end()) {
+        return;
+    }
+    
+    // Postings stay in place and are skipped until the next compaction
+    Doc& doc = docs_[it->second];
+    doc.alive = false;
+    doc.id = EntryId();
+    doc.display.clear();
+    doc_by_id_.erase(it);
+    ++dead_;
+    
+    if (dead_ >= COMPACT_MIN_DEAD && dead_ > docs_.size() / 2) {
+        compact();
+    }
+}
+
+void SearchIndex::clear() {
+    docs_.clear();
+    text_.clear();
+    doc_by_id_.clear();
+    dead_ = 0;
+    
+    trie_.clear();
+    trie_.push_back({NONE, NONE, NONE, '\0'});
+    posting_next_.clear();
+    
+    trigrams_.clear();
+}
+
+std::vector<std::pair<EntryId, std::string>> SearchIndex::search(const std::string& query, size_t limit) const {
+    std::vector<std::pair<EntryId, std::string>> results;
+    std::string normalized = normalize(query);
+    if (normalized.empty() || limit == 0) {
+        return results;
+    }
+    
+    std::vector<uint32_t> matches;
+    std::vector<bool> seen(docs_.size(), false);
+    
+    if (normalized.size() <= MAX_TRIE_DEPTH) {
+        searchPrefix(normalized, limit, matches, seen);
+    }
+    if (matches.size() < limit) {
+        searchSubstring(normalized, limit, matches, seen);
+    }
+    if (matches.empty()) {
+        searchFuzzy(normalized, limit, matches, seen);
+    }
+    
+    results.reserve(matches.size());
+    for (uint32_t doc : matches) {
+        results.emplace_back(docs_[doc].id, docs_[doc].display);
+    }
+    return results;
+}
+
+void SearchIndex::insertDoc(Doc doc, std::string_view label, std::string_view username) {
+    auto index = static_cast<uint32_t>(docs_.size());
+    
+    doc.text_offset = static_cast<uint32_t>(text_.size());
+    doc.label_length = static_cast<uint32_t>(label.size());
+    doc.username_length = static_cast<uint32_t>(username.size());
+    text_.append(label);
+    text_.append(username);
+    
+    doc_by_id_[doc.id] = index;
+    docs_.push_back(std::move(doc));
+    
+    posting_next_.resize(posting_next_.size() + 2, NONE);
+    insertTrie(label, index * 2);
+    insertTrie(username, index * 2 + 1);
+    
+    insertTrigrams(label, index);
+    insertTrigrams(username, index);
+}
+
+void SearchIndex::insertTrie(std::string_view key, uint32_t posting) {
+    uint32_t node = 0;
+    size_t depth = std::min(key.size(), MAX_TRIE_DEPTH);
+    
+    for (size_t i = 0; i < depth; ++i) {
+        uint32_t child = trie_[node].first_child;
+        while (child != NONE && trie_[child].symbol != key[i]) {
+            child = trie_[child].next_sibling;
+        }
+        
+        if (child == NONE) {
+            child = static_cast<uint32_t>(trie_.size());
+            trie_.push_back({NONE, trie_[node].first_child, NONE, key[i]});
+            trie_[node].first_child = child;
+        }
+        node = child;
+    }
+    
+    posting_next_[posting] = trie_[node].first_posting;
+    trie_[node].first_posting = posting;
+}
+
+void SearchIndex::insertTrigrams(std::string_view text, uint32_t doc) {
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        auto& postings = trigrams_[trigramKey(text.data() + i)];
+        if (postings.empty() || postings.back() != doc) {
+            postings.push_back(doc);
+        }
+    }
+}
+
+void SearchIndex::compact() {
+    std::vector<Doc> docs;
+    std::string text;
+    docs.swap(docs_);
+    text.swap(text_);
+    
+    clear();
+    for (Doc& doc : docs) {
+        if (!doc.alive) {
+            continue;
+        }
+        
+        std::string_view label(text.data() + doc.text_offset, doc.label_length);
+        std::string_view username(text.data() + doc.text_offset + doc.label_length, doc.username_length);
+        insertDoc(std::move(doc), label, username);
+    }
+}
+
+void SearchIndex::searchPrefix(const std::string& query, size_t limit,
+                               std::vector<uint32_t>& out, std::vector<bool>& seen) const {
+    uint32_t node = 0;
+    for (size_t i = 0; i < query.size() && node != NONE; ++i) {
+        uint32_t child = trie_[node].first_child;
+        while (child != NONE && trie_[child].symbol != query[i]) {
+            child = trie_[child].next_sibling;
+        }
+        node = child;
+    }
+    if (node == NONE) {
+        return;
+    }
+    
+    std::vector<uint32_t> stack{node};
+    while (!stack.empty() && out.size() < limit) {
+        uint32_t current = stack.back();
+        stack.pop_back();
+        
+        for (uint32_t posting = trie_[current].first_posting;
+             posting != NONE && out.size() < limit;
+             posting = posting_next_[posting]) {
+            uint32_t doc = posting / 2;
+            if (!docs_[doc].alive || seen[doc]) {
+                continue;
+            }
+            seen[doc] = true;
+            out.push_back(doc);
+        }
+        
+        for (uint32_t child = trie_[current].first_child; child != NONE; child = trie_[child].next_sibling) {
+            stack.push_back(child);
+        }
+    }
+}
+
+void SearchIndex::searchSubstring(const std::string& query, size_t limit,
+                                  std::vector<uint32_t>& out, std::vector<bool>& seen) const {
+    if (query.size() < 3) {
+        return;
+    }
+    
+    // Every occurrence contains every query trigram: walk the rarest posting
+    // list and only touch entry text for docs present in all of them
+    std::vector<const std::vector<uint32_t>*> postings;
+    for (size_t i = 0; i + 3 <= query.size(); ++i) {
+        auto it = trigrams_.find(trigramKey(query.data() + i));
+        if (it == trigrams_.end()) {
+            return;
+        }
+        postings.push_back(&it->second);
+    }
+    std::sort(postings.begin(), postings.end(),
+              [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    
+    // Prefix matches rank first (the trie only covers short queries)
+    std::vector<uint32_t> prefixed;
+    std::vector<uint32_t> contained;
+    std::vector<size_t> cursors(postings.size(), 0);
+    
+    for (uint32_t doc : *postings.front()) {
+        if (out.size() + prefixed.size() + contained.size() >= limit) {
+            break;
+        }
+        
+        const Doc& candidate = docs_[doc];
+        if (!candidate.alive || seen[doc]) {
+            continue;
+        }
+        
+        bool inAll = true;
+        for (size_t k = 1; k < postings.size() && inAll; ++k) {
+            inAll = advanceTo(*postings[k], cursors[k], doc);
+        }
+        if (!inAll) {
+            continue;
+        }
+        
+        std::string_view label = labelOf(candidate);
+        std::string_view username = usernameOf(candidate);
+        if (label.substr(0, query.size()) == query || username.substr(0, query.size()) == query) {
+            prefixed.push_back(doc);
+        } else if (label.find(query) != std::string_view::npos ||
+                   username.find(query) != std::string_view::npos) {
+            contained.push_back(doc);
+        } else {
+            continue;
+        }
+        seen[doc] = true;
+    }
+    
+    out.insert(out.end(), prefixed.begin(), prefixed.end());
+    out.insert(out.end(), contained.begin(), contained.end());
+}
+
+void SearchIndex::searchFuzzy(const std::string& query, size_t limit,
+                              std::vector<uint32_t>& out, std::vector<bool>& seen) const {
+    if (query.size() < 3) {
+        return;
+    }
+    
+    std::vector<const std::vector<uint32_t>*> postings;
+    size_t grams = query.size() - 2;
+    for (size_t i = 0; i < grams; ++i) {
+        auto it = trigrams_.find(trigramKey(query.data() + i));
+        if (it != trigrams_.end()) {
+            postings.push_back(&it->second);
+        }
+    }
+    
+    // A candidate sharing `needed` trigrams must appear in at least one of
+    // the (total - needed + 1) rarest posting lists
+    auto needed = static_cast<size_t>(grams * FUZZY_MIN_SCORE + 0.999);
+    needed = std::max<size_t>(needed, 1);
+    if (postings.size() < needed) {
+        return;
+    }
+    std::sort(postings.begin(), postings.end(),
+              [](const auto* a, const auto* b) { return a->size() < b->size(); });
+    size_t sources = std::min(postings.size(), grams - needed + 1);
+    
+    std::vector<std::pair<double, uint32_t>> scored;
+    std::vector<bool> scanned(docs_.size(), false);
+    size_t examined = 0;
+    
+    for (size_t source = 0; source < sources; ++source) {
+        std::vector<size_t> cursors(postings.size(), 0);
+        
+        for (uint32_t doc : *postings[source]) {
+            if (examined >= FUZZY_MAX_CANDIDATES) {
+                break;
+            }
+            if (!docs_[doc].alive || seen[doc] || scanned[doc]) {
+                continue;
+            }
+            scanned[doc] = true;
+            ++examined;
+            
+            // Score from the posting lists alone, without touching entry text
+            size_t hits = 0;
+            for (size_t k = 0; k < postings.size(); ++k) {
+                hits += advanceTo(*postings[k], cursors[k], doc);
+            }
+            
+            double score = static_cast<double>(hits) / grams;
+            if (score >= FUZZY_MIN_SCORE) {
+                scored.emplace_back(score, doc);
+            }
+        }
+    }
+    
+    std::stable_sort(scored.begin(), scored.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+    
+    for (const auto& match : scored) {
+        if (out.size() >= limit) {
+            break;
+        }
+        seen[match.second] = true;
+        out.push_back(match.second);
+    }
+}
+
+bool SearchIndex::advanceTo(const std::vector<uint32_t>& postings, size_t& cursor, uint32_t doc) {
+    // Gallop forward from the cursor, then binary search the last step
+    size_t low = cursor;
+    size_t step = 1;
+    while (low + step < postings.size() && postings[low + step] < doc) {
+        low += step;
+        step *= 2;
+    }
+    
+    auto end = postings.begin() + std::min(low + step + 1, postings.size());
+    cursor = static_cast<size_t>(std::lower_bound(postings.begin() + low, end, doc) - postings.begin());
+    return cursor < postings.size() && postings[cursor] == doc;
+}
+
+std::string SearchIndex::normalize(const std::string& text) {
+    std::string normalized = text;
+    for (char& c : normalized) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return normalized;
+}
+
+uint32_t SearchIndex::trigramKey(const char* p) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(p[0])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(p[1])) << 8) |
+           static_cast<uint32_t>(static_cast<uint8_t>(p[2]));
+}
+
+} // namespace core
+} // namespace crimson
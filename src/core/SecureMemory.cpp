@@ -6,9 +6,14 @@
     #include <windows.h>
 #else
     #include <sys/mman.h>
+    #include <sys/resource.h>
     #include <unistd.h>
 #endif
 
+#ifdef __linux__
+    #include <sys/prctl.h>
+#endif
+
 // Secure memory wiping function
 static void secure_zero_memory(void* ptr, size_t len) {
     volatile unsigned char* p = static_cast<volatile unsigned char*>(ptr);
@@ -110,6 +115,23 @@ bool SecureMemory::unlockMemory(void* addr, size_t len) {
 #endif
 }
 
+bool SecureMemory::lockProcessMemory() {
+#ifdef _WIN32
+    return false;
+#else
+#ifdef __linux__
+    prctl(PR_SET_DUMPABLE, 0, 0, 0, 0);
+#endif
+    // With a finite limit, MCL_FUTURE would make allocations fail once the
+    // process outgrows it, so only lock everything when unlimited
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) != 0 || limit.rlim_cur != RLIM_INFINITY) {
+        return false;
+    }
+    return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+#endif
+}
+
 void SecureMemory::secureZero(void* ptr, size_t len) {
     if (!ptr || len == 0) {
         return;
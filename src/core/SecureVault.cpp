@@ -1,20 +1,296 @@
 #include "core/SecureVault.h"
+#include "core/EntryCodec.h"
+#include "core/FileUtil.h"
+#include "core/Metrics.h"
+#include "core/Trace.h"
+#include "core/VaultReader.h"
 #include <fstream>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
-#include <QtCore/QJsonArray>
+#include <QtCore/QMessageAuthenticationCode>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <numeric>
 #include <stdexcept>
+#include <tuple>
+#include <unordered_map>
 
 namespace crimson {
 namespace core {
 
-SecureVault::SecureVault() 
+namespace {
+
+/**
+ * @brief Entropy estimate from length and the character classes present
+ */
+double estimateStrengthBits(const char* password, size_t length) {
+    bool lower = false, upper = false, digit = false, symbol = false;
+    for (size_t i = 0; i < length; ++i) {
+        unsigned char c = static_cast<unsigned char>(password[i]);
+        if (c >= 'a' && c <= 'z') {
+            lower = true;
+        } else if (c >= 'A' && c <= 'Z') {
+            upper = true;
+        } else if (c >= '0' && c <= '9') {
+            digit = true;
+        } else {
+            symbol = true;
+        }
+    }
+    
+    double pool = (lower ? 26 : 0) + (upper ? 26 : 0) + (digit ? 10 : 0) + (symbol ? 33 : 0);
+    return pool > 0 ? static_cast<double>(length) * std::log2(pool) : 0.0;
+}
+
+/**
+ * @brief Whole days between a creation time and now (-1 if unknown)
+ */
+int64_t ageInDays(Timestamp createdAt, Timestamp now) {
+    return !createdAt.isNull() ? (now.seconds() - createdAt.seconds()) / 86400 : -1;
+}
+
+// Below this, handing out tasks costs more than rebuilding indexes serially
+constexpr size_t PARALLEL_INDEX_MIN_ENTRIES = 4096;
+
+// Activity only has to be exact enough for whole-second auto-lock timeouts
+constexpr std::chrono::steady_clock::rep ACTIVITY_RESOLUTION_TICKS =
+    std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::milliseconds(100)).count();
+
+/**
+ * @brief Run tasks on the shared executor and wait for all of them
+ * @throws The first task's exception, in task order, after all have finished
+ */
+void runConcurrently(const std::vector<std::function<void()>>& tasks) {
+    std::vector<std::exception_ptr> errors(tasks.size());
+    {
+        TaskGroup group;
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            group.run([&, i]() {
+                try {
+                    tasks[i]();
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        group.wait();
+    }
+    
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+std::string lowercase(std::string_view text) {
+    std::string lowered(text);
+    for (char& c : lowered) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return lowered;
+}
+
+/**
+ * @brief Move an entry to a new key in an ordered index
+ *
+ * An unchanged key leaves the index alone, so it stays shared with the
+ * snapshot the change started from.
+ */
+template <typename Order, typename Key>
+void rekey(Order& order, const Key& from, const Key& to, const EntryId& id) {
+    if (from == to) {
+        return;
+    }
+    auto& edited = order.edit();
+    edited.erase({from, id});
+    edited.emplace(to, id);
+}
+
+/**
+ * @brief Listing cursor: "<key length>:<key><id>"
+ */
+std::string encodeCursor(const std::string& key, const std::string& id) {
+    return std::to_string(key.size()) + ":" + key + id;
+}
+
+std::pair<std::string, std::string> decodeCursor(const std::string& cursor) {
+    size_t colon = cursor.find(':');
+    if (colon == std::string::npos || colon == 0 || colon > 10) {
+        throw std::invalid_argument("Invalid listing cursor");
+    }
+    
+    size_t length = 0;
+    for (size_t i = 0; i < colon; ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(cursor[i]))) {
+            throw std::invalid_argument("Invalid listing cursor");
+        }
+        length = length * 10 + static_cast<size_t>(cursor[i] - '0');
+    }
+    if (length > cursor.size() - colon - 1) {
+        throw std::invalid_argument("Invalid listing cursor");
+    }
+    
+    return {cursor.substr(colon + 1, length), cursor.substr(colon + 1 + length)};
+}
+
+std::string cursorKey(const std::string& key) { return key; }
+std::string cursorKey(Timestamp key) { return std::to_string(key.seconds()); }
+
+void parseCursorKey(const std::string& text, std::string& key) { key = text; }
+void parseCursorKey(const std::string& text, Timestamp& key) {
+    try {
+        size_t used = 0;
+        key = Timestamp(std::stoll(text, &used));
+        if (used != text.size()) {
+            throw std::invalid_argument("Invalid listing cursor");
+        }
+    } catch (const std::logic_error&) {
+        throw std::invalid_argument("Invalid listing cursor");
+    }
+}
+
+template <typename Key>
+std::pair<Key, EntryId> parseCursor(const std::string& cursor) {
+    auto decoded = decodeCursor(cursor);
+    std::pair<Key, EntryId> position;
+    parseCursorKey(decoded.first, position.first);
+    if (!EntryId::parse(decoded.second, position.second)) {
+        throw std::invalid_argument("Invalid listing cursor");
+    }
+    return position;
+}
+
+/**
+ * @brief Collect up to pageSize ids from an ordered index, strictly after a cursor
+ * @return Cursor for the following page (empty if the index is exhausted)
+ */
+template <typename Key>
+std::string collectPage(const std::set<std::pair<Key, EntryId>>& index, const std::string& cursor,
+                        size_t pageSize, bool descending, std::vector<const EntryId*>& ids) {
+    auto begin = index.begin();
+    auto end = index.end();
+    
+    if (!cursor.empty()) {
+        auto position = parseCursor<Key>(cursor);
+        if (descending) {
+            end = index.lower_bound(position);
+        } else {
+            begin = index.upper_bound(position);
+        }
+    }
+    
+    if (descending) {
+        auto it = std::make_reverse_iterator(end);
+        auto stop = std::make_reverse_iterator(begin);
+        for (; it != stop && ids.size() < pageSize; ++it) {
+            ids.push_back(&it->second);
+        }
+        if (it == stop || ids.empty()) {
+            return std::string();
+        }
+        auto last = std::prev(it);
+        return encodeCursor(cursorKey(last->first), last->second.toString());
+    }
+    
+    auto it = begin;
+    for (; it != end && ids.size() < pageSize; ++it) {
+        ids.push_back(&it->second);
+    }
+    if (it == end || ids.empty()) {
+        return std::string();
+    }
+    auto last = std::prev(it);
+    return encodeCursor(cursorKey(last->first), last->second.toString());
+}
+
+/**
+ * @brief collectPage() over the last-used index, with newer accesses overlaid
+ * 
+ * Entries in moved are skipped in the snapshot's index and listed from
+ * overlay instead, which holds them under the times in moved. Overlay
+ * entries missing from live have been deleted and are skipped too.
+ */
+std::string collectUsagePage(const std::set<std::pair<Timestamp, EntryId>>& index,
+                             const std::set<std::pair<Timestamp, EntryId>>& overlay,
+                             const std::unordered_map<EntryId, Timestamp>& moved,
+                             const std::unordered_map<EntryId, size_t>& live,
+                             const std::string& cursor, size_t pageSize, bool descending,
+                             std::vector<const EntryId*>& ids) {
+    using Index = std::set<std::pair<Timestamp, EntryId>>;
+    
+    std::pair<Timestamp, EntryId> position;
+    if (!cursor.empty()) {
+        position = parseCursor<Timestamp>(cursor);
+    }
+    auto bounds = [&](const Index& set) {
+        auto begin = set.begin();
+        auto end = set.end();
+        if (!cursor.empty()) {
+            if (descending) {
+                end = set.lower_bound(position);
+            } else {
+                begin = set.upper_bound(position);
+            }
+        }
+        return std::make_pair(begin, end);
+    };
+    
+    // Merge the two ranges, walking both in the listing direction
+    auto merge = [&](auto a, auto aEnd, auto b, auto bEnd, auto before) {
+        auto skip = [&]() {
+            while (a != aEnd && moved.count(a->second)) {
+                ++a;
+            }
+            while (b != bEnd && live.count(b->second) == 0) {
+                ++b;
+            }
+        };
+        const std::pair<Timestamp, EntryId>* last = nullptr;
+        skip();
+        while (ids.size() < pageSize && (a != aEnd || b != bEnd)) {
+            if (b == bEnd || (a != aEnd && before(*a, *b))) {
+                last = &*a;
+                ++a;
+            } else {
+                last = &*b;
+                ++b;
+            }
+            ids.push_back(&last->second);
+            skip();
+        }
+        if (!last || (a == aEnd && b == bEnd)) {
+            return std::string();
+        }
+        return encodeCursor(cursorKey(last->first), last->second.toString());
+    };
+    
+    auto base = bounds(index);
+    auto newer = bounds(overlay);
+    if (descending) {
+        return merge(std::make_reverse_iterator(base.second), std::make_reverse_iterator(base.first),
+                     std::make_reverse_iterator(newer.second), std::make_reverse_iterator(newer.first),
+                     std::greater<std::pair<Timestamp, EntryId>>());
+    }
+    return merge(base.first, base.second, newer.first, newer.second, std::less<std::pair<Timestamp, EntryId>>());
+}
+
+} // namespace
+
+SecureVault::SecureVault()
     : crypto_manager_(std::make_unique<CryptoManager>())
     , password_generator_(std::make_unique<PasswordGenerator>())
-    , vault_key_(nullptr)
+    , credential_pool_(std::make_unique<CredentialPool>())
+    , usage_pending_(false)
     , is_open_(false)
-    , last_activity_(std::chrono::steady_clock::now())
+    , last_activity_(std::chrono::steady_clock::now().time_since_epoch().count())
     , auto_lock_timeout_(60) {
     
     if (!crypto_manager_->initialize()) {
@@ -27,197 +303,668 @@ SecureVault::~SecureVault() {
 }
 
 bool SecureVault::createVault(const std::string& masterPassword, const std::string& vaultPath) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.create");
+    ScopedOperation timed(metrics);
+    
     if (masterPassword.empty()) {
-        return false;
+        return timed.fail();
     }
     
+    std::lock_guard<std::mutex> lock(write_mutex_);
     try {
+        if (is_open_) {
+            closeLocked();
+        }
+        cancelPrefetch();
         vault_path_ = vaultPath;
         
         // Generate salt for key derivation
         vault_salt_ = crypto_manager_->generateSalt();
         
-        // Derive key from master password
-        vault_key_ = crypto_manager_->deriveKey(masterPassword, vault_salt_);
+        // Derive key from master password and hash it for verification
+        auto created = std::make_shared<Snapshot>();
+        created->key = crypto_manager_->deriveKeyAndHash(masterPassword, vault_salt_, master_hash_);
         
-        // Hash master password for verification
-        master_hash_ = crypto_manager_->hashMasterPassword(masterPassword, vault_salt_);
+        // Save initial empty vault
+        if (!saveVaultFile(*created)) {
+            closeLocked();
+            return timed.fail();
+        }
         
-        // Clear entries and initialize
-        entries_.clear();
+        publish(std::move(created));
         is_open_ = true;
         updateActivity();
         
-        // Save initial empty vault
-        return saveVaultFile();
+        credential_pool_->start();
+        return true;
         
     } catch (const std::exception&) {
-        closeVault();
-        return false;
+        closeLocked();
+        return timed.fail();
     }
 }
 
 bool SecureVault::openVault(const std::string& masterPassword, const std::string& vaultPath) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.open");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("vault", "open");
+    
     if (masterPassword.empty()) {
-        return false;
+        return timed.fail();
     }
     
+    std::lock_guard<std::mutex> lock(write_mutex_);
     try {
-        vault_path_ = vaultPath;
-        
-        // Load vault file first to get salt and hash
-        if (!loadVaultFile()) {
-            return false;
+        if (is_open_) {
+            closeLocked();
         }
         
-        // Verify master password
-        if (!crypto_manager_->verifyMasterPassword(masterPassword, master_hash_, vault_salt_)) {
-            closeVault();
-            return false;
+        // Reads the file and builds the indexes in the background, unless
+        // prefetch() has already started doing so for this path
+        prefetch(vaultPath);
+        VaultReader::Header header;
+        {
+            CRIMSON_TRACE_SPAN("vault", "read_header");
+            header = VaultReader::readHeader(vaultPath);
         }
         
-        // Derive key from master password
-        vault_key_ = crypto_manager_->deriveKey(masterPassword, vault_salt_);
+        vault_path_ = vaultPath;
+        vault_salt_ = header.salt;
+        master_hash_ = header.master_hash;
+        
+        // Verify master password and derive key from it while entries are
+        // still being decoded
+        std::shared_ptr<const SecureMemory::SecureBuffer> key =
+            crypto_manager_->unlock(masterPassword, master_hash_, vault_salt_);
+        
+        std::shared_ptr<Snapshot> loaded;
+        {
+            CRIMSON_TRACE_SPAN("vault", "wait_for_entries");
+            loaded = takePrefetch(vaultPath);
+        }
+        if (!loaded || !key) {
+            closeLocked();
+            return timed.fail();
+        }
         
+        loaded->key = std::move(key);
+        publish(std::move(loaded));
         is_open_ = true;
         updateActivity();
         
+        credential_pool_->start();
         return true;
         
     } catch (const std::exception&) {
-        closeVault();
-        return false;
+        closeLocked();
+        return timed.fail();
+    }
+}
+
+void SecureVault::prefetch(const std::string& vaultPath) {
+    if (is_open_) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(prefetch_mutex_);
+    if (prefetch_ && prefetch_->path == vaultPath) {
+        return;
+    }
+    if (prefetch_) {
+        prefetch_->dropped = true;
+    }
+    
+    auto state = std::make_shared<Prefetch>();
+    state->path = vaultPath;
+    prefetch_ = state;
+    Executor::shared().post([state]() { state->run(); }, Executor::Priority::Interactive);
+}
+
+void SecureVault::cancelPrefetch() {
+    std::shared_ptr<Prefetch> dropped;
+    {
+        std::lock_guard<std::mutex> lock(prefetch_mutex_);
+        dropped = std::move(prefetch_);
+        if (dropped) {
+            dropped->dropped = true;
+        }
     }
+    // Anything it decoded goes with the last reference, here or in the
+    // task once it finishes
+}
+
+void SecureVault::Prefetch::run() {
+    if (dropped || claimed.exchange(true)) {
+        return;
+    }
+    
+    auto snapshot = std::make_shared<Snapshot>();
+    bool ok = loadVaultFile(path, *snapshot);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (ok) {
+            loaded = std::move(snapshot);
+        }
+        done = true;
+    }
+    finished.notify_all();
 }
 
 void SecureVault::closeVault() {
-    clearSensitiveData();
-    entries_.clear();
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.close");
+    ScopedOperation timed(metrics);
+    
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    closeLocked();
+}
+
+void SecureVault::closeLocked() {
+    cancelPrefetch();
+    credential_pool_->stop();
+    
+    // Last-used times not yet saved with a change are dropped: reading a
+    // password must never rewrite the file, which could also overwrite
+    // entries another process has saved since this one opened it
+    
+    // Readers still using the last snapshot keep it; its table and the key
+    // are wiped when the last of them lets go
+    is_open_ = false;
+    publish(nullptr);
+    {
+        std::lock_guard<std::mutex> usageLock(usage_mutex_);
+        usage_.clear();
+        usage_order_.clear();
+        usage_pending_ = false;
+    }
     vault_path_.clear();
     vault_salt_.clear();
     master_hash_.clear();
-    vault_key_.reset();
-    is_open_ = false;
+}
+
+std::shared_ptr<SecureVault::Snapshot> SecureVault::beginChange() const {
+    auto next = std::make_shared<Snapshot>(*current());
+    
+    {
+        std::lock_guard<std::mutex> lock(usage_mutex_);
+        folded_usage_ = usage_;
+    }
+    for (const auto& touch : folded_usage_) {
+        size_t row = next->find(touch.first);
+        if (row == next->entries->size()) {
+            continue;   // Deleted since
+        }
+        rekey(next->last_used_order, next->entries->lastUsedAt(row), touch.second, touch.first);
+        next->entries.edit().setLastUsedAt(row, touch.second);
+    }
+    
+    return next;
+}
+
+void SecureVault::publish(std::shared_ptr<const Snapshot> next) const {
+    std::atomic_store(&snapshot_, std::move(next));
+    if (folded_usage_.empty()) {
+        return;
+    }
+    
+    // Touches made since beginChange() copied them stay pending
+    std::lock_guard<std::mutex> lock(usage_mutex_);
+    for (const auto& touch : folded_usage_) {
+        auto it = usage_.find(touch.first);
+        if (it != usage_.end() && it->second == touch.second) {
+            usage_order_.erase({touch.second, touch.first});
+            usage_.erase(it);
+        }
+    }
+    usage_pending_ = !usage_.empty();
+    folded_usage_.clear();
+}
+
+Timestamp SecureVault::lastUsedAt(const Snapshot& snapshot, size_t row) const {
+    if (usage_pending_) {
+        std::lock_guard<std::mutex> lock(usage_mutex_);
+        auto it = usage_.find(snapshot.entries->id(row));
+        if (it != usage_.end()) {
+            return it->second;
+        }
+    }
+    return snapshot.entries->lastUsedAt(row);
+}
+
+EntryView SecureVault::viewOf(const std::shared_ptr<const Snapshot>& snapshot, size_t row) const {
+    EntryView view = snapshot->entries->view(row);
+    view.last_used_at = lastUsedAt(*snapshot, row);
+    view.owner = snapshot;
+    return view;
+}
+
+size_t SecureVault::Snapshot::find(const EntryId& entryId) const {
+    auto it = positions->find(entryId);
+    return it != positions->end() ? it->second : entries->size();
 }
 
 VaultEntry SecureVault::createEntry(const std::string& label) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.create_entry");
+    ScopedOperation timed(metrics);
+    
     if (!is_open_ || label.empty()) {
         throw std::runtime_error("Vault not open or invalid label");
     }
     
     updateActivity();
     
+    // The password generator is not itself thread-safe
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    
     VaultEntry entry;
-    entry.id = VaultEntry::generateUuid();
+    entry.id = EntryId::generate();
     entry.label = label;
-    entry.username = password_generator_->generateUsername();
-    entry.password = password_generator_->generatePassword();
-    entry.created_at = VaultEntry::getCurrentTimestamp();
+    if (!credential_pool_->take(entry.username, entry.password)) {
+        entry.username = password_generator_->generateUsername();
+        entry.password = password_generator_->generatePassword(credential_pool_->passwordLength());
+    }
+    
+    // Never hand out a password that is known to be breached
+    for (int attempt = 0; isPasswordBreached(entry.password); ++attempt) {
+        SecureMemory::secureZero(entry.password);
+        if (attempt == 3) {
+            throw std::runtime_error("Generated passwords keep matching the breach corpus");
+        }
+        entry.password = password_generator_->generatePassword(credential_pool_->passwordLength());
+    }
+    entry.created_at = Timestamp::now();
     entry.device_fingerprint = VaultEntry::getDeviceFingerprint();
     
     return entry;
 }
 
 bool SecureVault::saveEntry(const VaultEntry& entry) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.save_entry");
+    ScopedOperation timed(metrics);
+    
+    std::lock_guard<std::mutex> lock(write_mutex_);
     if (!is_open_) {
-        return false;
+        return timed.fail();
     }
     
     try {
         updateActivity();
+        auto next = beginChange();
+        storeEntry(*next, entry);
+        publish(next);
+        return saveVaultFile(*next) || timed.fail();
         
-        // Encrypt the password before storing
-        VaultEntry encryptedEntry = entry;
-        std::vector<uint8_t> encryptedPassword = crypto_manager_->encrypt(entry.password, *vault_key_);
-        encryptedEntry.password = crypto_manager_->toBase64(encryptedPassword);
-        
-        // Add or update entry
-        auto it = std::find_if(entries_.begin(), entries_.end(),
-            [&entry](const VaultEntry& e) { return e.id == entry.id; });
-        
-        if (it != entries_.end()) {
-            *it = encryptedEntry;
-        } else {
-            entries_.push_back(encryptedEntry);
+    } catch (const std::exception&) {
+        return timed.fail();
+    }
+}
+
+bool SecureVault::saveEntries(const std::vector<VaultEntry>& entries) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.save_entries");
+    ScopedOperation timed(metrics);
+    
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (!is_open_) {
+        return timed.fail();
+    }
+    
+    try {
+        updateActivity();
+        auto next = beginChange();
+        for (const auto& entry : entries) {
+            storeEntry(*next, entry);
         }
-        
-        return saveVaultFile();
+        publish(next);
+        return saveVaultFile(*next) || timed.fail();
         
     } catch (const std::exception&) {
-        return false;
+        return timed.fail();
     }
 }
 
-std::vector<std::pair<std::string, std::string>> SecureVault::getEntryLabels() const {
-    if (!is_open_) {
+std::vector<std::pair<EntryId, std::string>> SecureVault::getEntryLabels() const {
+    auto snapshot = current();
+    if (!snapshot) {
         return {};
     }
     
-    std::vector<std::pair<std::string, std::string>> labels;
-    labels.reserve(entries_.size());
+    const EntryTable& entries = *snapshot->entries;
+    std::vector<std::pair<EntryId, std::string>> labels;
+    labels.reserve(entries.size());
     
-    for (const auto& entry : entries_) {
-        labels.emplace_back(entry.id, entry.label);
+    for (size_t row = 0; row < entries.size(); ++row) {
+        labels.emplace_back(entries.id(row), std::string(entries.label(row)));
     }
     
     return labels;
 }
 
-VaultEntry SecureVault::getEntry(const std::string& entryId) const {
-    if (!is_open_) {
+size_t SecureVault::getEntryCount() const {
+    auto snapshot = current();
+    return snapshot ? snapshot->entries->size() : 0;
+}
+
+EntryId SecureVault::getEntryIdAt(size_t index) const {
+    auto snapshot = current();
+    if (!snapshot || index >= snapshot->entries->size()) {
+        throw std::out_of_range("Entry index out of range");
+    }
+    
+    return snapshot->entries->id(index);
+}
+
+size_t SecureVault::findEntry(const EntryId& entryId) const {
+    auto snapshot = current();
+    return snapshot ? snapshot->find(entryId) : 0;
+}
+
+std::string SecureVault::getEntryLabelAt(size_t index) const {
+    auto snapshot = current();
+    if (!snapshot || index >= snapshot->entries->size()) {
+        throw std::out_of_range("Entry index out of range");
+    }
+    
+    return std::string(snapshot->entries->label(index));
+}
+
+SecureVault::EntryPage SecureVault::listEntries(EntryOrder order, const std::string& cursor,
+                                                size_t pageSize, bool descending) const {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.list");
+    ScopedOperation timed(metrics);
+    
+    EntryPage page;
+    if (pageSize == 0) {
+        return page;
+    }
+    
+    auto snapshot = current();
+    if (!snapshot) {
+        return page;
+    }
+    
+    std::vector<const EntryId*> ids;
+    ids.reserve(pageSize);
+    
+    // Accesses not yet folded into a snapshot are merged in from
+    // usage_order_ rather than folded, which would need the writer lock.
+    // The usage lock is held until the page is built, as ids point into
+    // it, and the snapshot is reloaded under it: publish() stores a new
+    // one before it drops the usage folded into it
+    std::unique_lock<std::mutex> usageLock(usage_mutex_, std::defer_lock);
+    if (order == EntryOrder::LastUsed && usage_pending_) {
+        usageLock.lock();
+        snapshot = current();
+        if (!snapshot) {
+            return page;
+        }
+    }
+    
+    switch (order) {
+    case EntryOrder::Label:
+        page.nextCursor = collectPage(*snapshot->label_order, cursor, pageSize, descending, ids);
+        break;
+    case EntryOrder::CreatedAt:
+        page.nextCursor = collectPage(*snapshot->created_order, cursor, pageSize, descending, ids);
+        break;
+    case EntryOrder::LastUsed:
+        page.nextCursor = usageLock.owns_lock()
+            ? collectUsagePage(*snapshot->last_used_order, usage_order_, usage_, *snapshot->positions,
+                               cursor, pageSize, descending, ids)
+            : collectPage(*snapshot->last_used_order, cursor, pageSize, descending, ids);
+        break;
+    }
+    
+    page.entries.reserve(ids.size());
+    for (const EntryId* id : ids) {
+        page.entries.emplace_back(*id, std::string(snapshot->entries->label(snapshot->positions->at(*id))));
+    }
+    
+    return page;
+}
+
+std::vector<std::pair<EntryId, std::string>> SecureVault::search(const std::string& query,
+                                                                 size_t limit) const {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.search");
+    ScopedOperation timed(metrics);
+    
+    auto snapshot = current();
+    if (!snapshot) {
+        return {};
+    }
+    
+    return snapshot->search_index->search(query, limit);
+}
+
+VaultEntry SecureVault::getEntry(const EntryId& entryId) const {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.get_entry");
+    ScopedOperation timed(metrics);
+    
+    auto snapshot = current();
+    if (!snapshot) {
         throw std::runtime_error("Vault not open");
     }
     
-    auto it = std::find_if(entries_.begin(), entries_.end(),
-        [&entryId](const VaultEntry& e) { return e.id == entryId; });
+    size_t position = snapshot->find(entryId);
+    if (position == snapshot->entries->size()) {
+        throw std::runtime_error("Entry not found");
+    }
+    
+    VaultEntry entry = snapshot->entries->materialize(position);
+    entry.last_used_at = lastUsedAt(*snapshot, position);
+    return entry;
+}
+
+EntryView SecureVault::getEntryView(const EntryId& entryId) const {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.get_entry_view");
+    ScopedOperation timed(metrics);
     
-    if (it == entries_.end()) {
+    auto snapshot = current();
+    if (!snapshot) {
+        throw std::runtime_error("Vault not open");
+    }
+    
+    size_t position = snapshot->find(entryId);
+    if (position == snapshot->entries->size()) {
         throw std::runtime_error("Entry not found");
     }
     
-    return *it;
+    return viewOf(snapshot, position);
 }
 
-std::string SecureVault::getPassword(const std::string& entryId) {
-    if (!is_open_) {
+bool SecureVault::hasEntry(const EntryId& entryId) const {
+    auto snapshot = current();
+    return snapshot && snapshot->find(entryId) != snapshot->entries->size();
+}
+
+EntryView SecureVault::getEntryViewAt(size_t index) const {
+    auto snapshot = current();
+    if (!snapshot || index >= snapshot->entries->size()) {
+        throw std::out_of_range("Entry index out of range");
+    }
+    
+    return viewOf(snapshot, index);
+}
+
+EntryId SecureVault::resolveEntry(const std::string& key) const {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.resolve");
+    ScopedOperation timed(metrics);
+    
+    auto snapshot = current();
+    if (!snapshot) {
         throw std::runtime_error("Vault not open");
     }
     
-    updateActivity();
+    const EntryTable& entries = *snapshot->entries;
+    EntryId id;
+    if (EntryId::parse(key, id)) {
+        if (snapshot->find(id) == entries.size()) {
+            throw std::runtime_error("Entry not found");
+        }
+        return id;
+    }
+    
+    size_t matches = 0;
+    for (size_t row = 0; row < entries.size() && matches < 2; ++row) {
+        if (entries.label(row) == key) {
+            id = entries.id(row);
+            ++matches;
+        }
+    }
+    
+    if (matches == 0) {
+        throw std::runtime_error("No entry with ID or label " + key);
+    }
+    if (matches > 1) {
+        throw std::runtime_error("More than one entry is labelled " + key + "; use its ID");
+    }
+    return id;
+}
+
+size_t SecureVault::forEachEntry(const EntryVisitor& visitor) const {
+    auto snapshot = current();
+    if (!snapshot) {
+        return 0;
+    }
+    
+    std::unordered_map<EntryId, Timestamp> usage;
+    if (usage_pending_) {
+        std::lock_guard<std::mutex> lock(usage_mutex_);
+        usage = usage_;
+    }
+    
+    // One reference is lent to each view in turn rather than counted per
+    // row; a visitor that copies a view still takes its own
+    std::shared_ptr<const void> owner = snapshot;
+    size_t visited = 0;
+    for (size_t row = 0; row < snapshot->entries->size(); ++row) {
+        ++visited;
+        EntryView view = snapshot->entries->view(row);
+        if (!usage.empty()) {
+            auto it = usage.find(view.id);
+            if (it != usage.end()) {
+                view.last_used_at = it->second;
+            }
+        }
+        
+        view.owner.swap(owner);
+        bool more = visitor(view);
+        view.owner.swap(owner);
+        if (!more) {
+            break;
+        }
+    }
     
-    auto it = std::find_if(entries_.begin(), entries_.end(),
-        [&entryId](const VaultEntry& e) { return e.id == entryId; });
+    return visited;
+}
+
+std::string SecureVault::getPassword(const EntryId& entryId) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.get_password");
+    ScopedOperation timed(metrics);
     
-    if (it == entries_.end()) {
+    auto snapshot = current();
+    if (!snapshot) {
+        throw std::runtime_error("Vault not open");
+    }
+    
+    updateActivity();
+    
+    size_t position = snapshot->find(entryId);
+    if (position == snapshot->entries->size()) {
         throw std::runtime_error("Entry not found");
     }
     
+    std::string password;
     try {
         // Decrypt the password
-        std::vector<uint8_t> encryptedPassword = crypto_manager_->fromBase64(it->password);
-        return crypto_manager_->decrypt(encryptedPassword, *vault_key_);
+        std::vector<uint8_t> encryptedPassword = crypto_manager_->fromBase64(std::string(snapshot->entries->password(position)));
+        password = crypto_manager_->decrypt(encryptedPassword, *snapshot->key);
         
     } catch (const std::exception&) {
         throw std::runtime_error("Failed to decrypt password");
     }
+    
+    // Record the access for last-used ordering; folded into a snapshot
+    // later, so reads never copy the table
+    {
+        std::lock_guard<std::mutex> lock(usage_mutex_);
+        Timestamp& usedAt = usage_[entryId];
+        usage_order_.erase({usedAt, entryId});
+        usedAt = Timestamp::now();
+        usage_order_.emplace(usedAt, entryId);
+        usage_pending_ = true;
+    }
+    
+    return password;
 }
 
-bool SecureVault::deleteEntry(const std::string& entryId) {
+bool SecureVault::deleteEntry(const EntryId& entryId) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.delete_entry");
+    ScopedOperation timed(metrics);
+    
+    std::lock_guard<std::mutex> lock(write_mutex_);
     if (!is_open_) {
-        return false;
+        return timed.fail();
     }
     
     updateActivity();
     
-    auto it = std::find_if(entries_.begin(), entries_.end(),
-        [&entryId](const VaultEntry& e) { return e.id == entryId; });
+    if (current()->find(entryId) == current()->entries->size()) {
+        return timed.fail();
+    }
     
-    if (it == entries_.end()) {
-        return false;
+    auto next = beginChange();
+    size_t position = next->find(entryId);
+    unindexEntry(*next, position);
+    EntryTable& entries = next->entries.edit();
+    std::unordered_map<EntryId, size_t>& positions = next->positions.edit();
+    entries.erase(position);
+    positions.erase(entryId);
+    for (size_t row = position; row < entries.size(); ++row) {
+        positions[entries.id(row)] = row;
     }
     
-    entries_.erase(it);
-    return saveVaultFile();
+    publish(next);
+    return saveVaultFile(*next) || timed.fail();
+}
+
+void SecureVault::setBreachCorpus(std::shared_ptr<const BreachCorpus> corpus) {
+    std::atomic_store(&breach_corpus_, std::move(corpus));
+}
+
+bool SecureVault::isPasswordBreached(const std::string& password) const {
+    auto corpus = std::atomic_load(&breach_corpus_);
+    return corpus && corpus->contains(password);
+}
+
+std::vector<EntryId> SecureVault::findBreachedEntries() {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.find_breached");
+    ScopedOperation timed(metrics);
+    
+    auto snapshot = current();
+    if (!snapshot) {
+        throw std::runtime_error("Vault not open");
+    }
+    
+    std::vector<EntryId> breached;
+    auto corpus = std::atomic_load(&breach_corpus_);
+    if (!corpus) {
+        return breached;
+    }
+    
+    updateActivity();
+    
+    const EntryTable& entries = *snapshot->entries;
+    for (size_t row = 0; row < entries.size(); ++row) {
+        std::vector<uint8_t> encryptedPassword = crypto_manager_->fromBase64(std::string(entries.password(row)));
+        std::string password = crypto_manager_->decrypt(encryptedPassword, *snapshot->key);
+        
+        if (corpus->contains(password)) {
+            breached.push_back(entries.id(row));
+        }
+        
+        SecureMemory::secureZero(password);
+    }
+    
+    return breached;
 }
 
 void SecureVault::setAutoLockTimeout(int timeoutSeconds) {
@@ -225,143 +972,476 @@ void SecureVault::setAutoLockTimeout(int timeoutSeconds) {
 }
 
 bool SecureVault::shouldAutoLock() const {
-    if (!is_open_ || auto_lock_timeout_ <= 0) {
+    int timeout = auto_lock_timeout_;
+    if (!is_open_ || timeout <= 0) {
         return false;
     }
     
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - last_activity_);
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+        now - std::chrono::steady_clock::duration(last_activity_.load()));
     
-    return elapsed.count() >= auto_lock_timeout_;
+    return elapsed.count() >= timeout;
 }
 
 void SecureVault::updateActivity() {
-    last_activity_ = std::chrono::steady_clock::now();
+    // Readers on every thread call this; skipping stores that would not
+    // change the outcome keeps them from contending for one cache line
+    auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+    auto last = last_activity_.load(std::memory_order_relaxed);
+    if (now - last >= ACTIVITY_RESOLUTION_TICKS) {
+        last_activity_.store(now, std::memory_order_relaxed);
+    }
 }
 
 bool SecureVault::verifyIntegrity() const {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.verify_integrity");
+    ScopedOperation timed(metrics);
+    
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        path = vault_path_;
+    }
+    
     // For now, just check if vault file exists and can be read
     // In a full implementation, you would verify checksums and signatures
-    if (vault_path_.empty()) {
+    if (path.empty()) {
         return false;
     }
     
-    std::ifstream file(vault_path_);
+    std::ifstream file(path);
     return file.good();
 }
 
 SecureVault::VaultStats SecureVault::getStats() const {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.stats");
+    ScopedOperation timed(metrics);
+    
+    auto snapshot = current();
     VaultStats stats;
-    stats.entryCount = entries_.size();
+    stats.entryCount = snapshot ? snapshot->entries->size() : 0;
     stats.deviceFingerprint = VaultEntry::getDeviceFingerprint();
     
-    if (!entries_.empty()) {
-        // Find earliest created_at
-        auto earliest = std::min_element(entries_.begin(), entries_.end(),
-            [](const VaultEntry& a, const VaultEntry& b) {
-                return a.created_at < b.created_at;
-            });
-        stats.createdAt = earliest->created_at;
-        
-        // Find latest created_at
-        auto latest = std::max_element(entries_.begin(), entries_.end(),
-            [](const VaultEntry& a, const VaultEntry& b) {
-                return a.created_at < b.created_at;
-            });
-        stats.lastModified = latest->created_at;
+    if (snapshot && !snapshot->created_order->empty()) {
+        // Earliest and latest created_at straight from the ordered index
+        stats.createdAt = snapshot->created_order->begin()->first;
+        stats.lastModified = snapshot->created_order->rbegin()->first;
     }
     
     return stats;
 }
 
-bool SecureVault::loadVaultFile() {
-    std::ifstream file(vault_path_);
-    if (!file.good()) {
-        return false;
+SecureVault::AuditSummary SecureVault::auditVault(const AuditOptions& options,
+                                                  const AuditCallback& callback) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.audit");
+    ScopedOperation timed(metrics);
+    
+    auto snapshot = current();
+    if (!snapshot) {
+        throw std::runtime_error("Vault not open");
     }
     
-    try {
-        std::string content((std::istreambuf_iterator<char>(file)),
-                           std::istreambuf_iterator<char>());
-        file.close();
+    updateActivity();
         
-        QJsonParseError error;
-        QJsonDocument doc = QJsonDocument::fromJson(QByteArray::fromStdString(content), &error);
+    const EntryTable& entries = *snapshot->entries;
+    const SecureMemory::SecureBuffer& key = *snapshot->key;
+    auto corpus = std::atomic_load(&breach_corpus_);
         
-        if (error.error != QJsonParseError::NoError) {
-            return false;
+    const size_t count = entries.size();
+    std::vector<EntryAudit> results(count);
+    std::vector<std::array<uint8_t, 32>> digests(count);
+    
+    // One-off MAC key: digests are meaningless outside this audit
+    auto macKey = SecureMemory::createBuffer(32);
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        password_generator_->generateRandomBytes(macKey->as<uint8_t>(), macKey->size());
+    }
+    const QByteArray macKeyBytes = QByteArray::fromRawData(macKey->as<const char>(),
+                                                           static_cast<int>(macKey->size()));
+    
+    const Timestamp now = Timestamp::now();
+    const size_t batchSize = std::max<size_t>(1, options.batchSize);
+    const size_t batches = (count + batchSize - 1) / batchSize;
+    std::atomic<size_t> nextBatch{0};
+    std::atomic<bool> failed{false};
+    
+    // Batches finish out of order; each is reported once every batch
+    // before it has been
+    std::mutex readyMutex;
+    std::condition_variable readyChanged;
+    std::vector<char> ready(batches, 0);
+    
+    auto fail = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            failed = true;
+        }
+        readyChanged.notify_all();
+    };
+    
+    auto auditBatch = [&](size_t batch, std::unique_ptr<SecureMemory::SecureBuffer>& scratch,
+                          QMessageAuthenticationCode& mac) {
+        size_t end = std::min(count, (batch + 1) * batchSize);
+        for (size_t i = batch * batchSize; i < end; ++i) {
+            EntryAudit& result = results[i];
+            
+            std::vector<uint8_t> ciphertext = CryptoManager::fromBase64(std::string(entries.password(i)));
+            if (ciphertext.size() > scratch->size()) {
+                scratch = SecureMemory::createBuffer(ciphertext.size());
+            }
+            size_t length = crypto_manager_->decrypt(ciphertext, key, *scratch);
+            const char* plaintext = scratch->as<const char>();
+            
+            result.id = entries.id(i);
+            result.label = std::string(entries.label(i));
+            result.strengthBits = estimateStrengthBits(plaintext, length);
+            result.weak = result.strengthBits < options.weakBelowBits;
+            result.breached = corpus && corpus->contains(plaintext, length);
+            
+            mac.reset();
+            mac.addData(plaintext, static_cast<int>(length));
+            QByteArray digest = mac.result();
+            std::memcpy(digests[i].data(), digest.constData(), digests[i].size());
+            
+            SecureMemory::secureZero(scratch->data(), length);
+            
+            result.ageDays = ageInDays(entries.createdAt(i), now);
+            result.stale = result.ageDays >= options.staleAfterDays;
         }
         
-        QJsonObject root = doc.object();
+        {
+            std::lock_guard<std::mutex> lock(readyMutex);
+            ready[batch] = 1;
+        }
+        readyChanged.notify_all();
+    };
         
-        // Load vault metadata
-        vault_salt_ = root["salt"].toString().toStdString();
-        master_hash_ = root["master_hash"].toString().toStdString();
+    // A claimed batch is always finished (or the audit failed), so the
+    // calling thread never waits on one that nobody is working on
+    auto worker = [&]() {
+        try {
+            auto scratch = SecureMemory::createBuffer(1024);
+            QMessageAuthenticationCode mac(QCryptographicHash::Sha256, macKeyBytes);
         
-        // Load entries
-        QJsonArray entriesArray = root["entries"].toArray();
-        entries_.clear();
-        entries_.reserve(entriesArray.size());
+            while (!failed && !options.cancel.isCancelled()) {
+                size_t batch = nextBatch++;
+                if (batch >= batches) {
+                    break;
+                }
+                auditBatch(batch, scratch, mac);
+            }
+        } catch (...) {
+            fail();
+        }
+    };
+    unsigned threads = options.threads ? options.threads : Executor::shared().threadCount();
+    threads = static_cast<unsigned>(std::min<size_t>(std::max(1u, threads), std::max<size_t>(1, batches)));
+        
+    // Runs behind anything interactive; the calling thread is one of the
+    // threads, auditing batches itself whenever the next one to report
+    // is not ready yet
+    TaskGroup group(Executor::Priority::Bulk);
+    for (unsigned t = 1; t < threads; ++t) {
+        group.run(worker);
+    }
+    
+    AuditSummary summary;
+    summary.entries = count;
+    try {
+        auto scratch = SecureMemory::createBuffer(1024);
+        QMessageAuthenticationCode mac(QCryptographicHash::Sha256, macKeyBytes);
         
-        for (const auto& value : entriesArray) {
-            if (value.isObject()) {
-                QJsonDocument entryDoc(value.toObject());
-                entries_.push_back(VaultEntry::fromJson(entryDoc.toJson().toStdString()));
+        for (size_t cursor = 0; cursor < batches && !failed && !options.cancel.isCancelled();) {
+            bool isReady;
+            {
+                std::unique_lock<std::mutex> lock(readyMutex);
+                if (!ready[cursor] && nextBatch >= batches) {
+                    readyChanged.wait(lock, [&]() { return ready[cursor] || failed; });
+                }
+                isReady = ready[cursor];
+            }
+            
+            if (!isReady) {
+                size_t batch = nextBatch++;
+                if (batch < batches) {
+                    try {
+                        auditBatch(batch, scratch, mac);
+                    } catch (...) {
+                        fail();
+                    }
+                }
+                continue;
+            }
+            
+            size_t end = std::min(count, (cursor + 1) * batchSize);
+            for (size_t i = cursor * batchSize; i < end; ++i) {
+                EntryAudit& result = results[i];
+                summary.weak += result.weak;
+                summary.stale += result.stale;
+                summary.breached += result.breached;
+                
+                if (callback) {
+                    callback(result);
+                }
+                result = EntryAudit();   // Reported; free the label copy
+            }
+            ++cursor;
+        }
+    } catch (...) {
+        // The callback threw: stop the workers before the group waits for them
+        fail();
+        throw;
+    }
+    group.wait();
+    
+    options.cancel.throwIfCancelled();
+    if (failed) {
+        throw std::runtime_error("Vault audit failed");
+    }
+    
+    // Equal digests are a shared password; sorting by digest, then by
+    // position, gathers each group in vault order
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&digests](size_t a, size_t b) {
+        return std::tie(digests[a], a) < std::tie(digests[b], b);
+    });
+    
+    for (size_t first = 0; first < count;) {
+        size_t last = first + 1;
+        while (last < count && digests[order[last]] == digests[order[first]]) {
+            ++last;
+        }
+        if (last - first > 1) {
+            std::vector<EntryId> shared;
+            shared.reserve(last - first);
+            for (size_t k = first; k < last; ++k) {
+                shared.push_back(entries.id(order[k]));
             }
+            summary.reused += shared.size();
+            summary.reuseGroups.push_back(std::move(shared));
         }
+        first = last;
+    }
+    
+    return summary;
+}
+
+
+bool SecureVault::loadVaultFile(const std::string& path, Snapshot& snapshot) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.load_file");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("vault", "load_file");
+    
+    try {
+        // Streamed straight into the entry table; no QJsonDocument tree.
+        // The header is read separately, ahead of the entries
+        VaultReader::readFile(path, snapshot.entries.edit(), Executor::shared().threadCount());
+        
+        CRIMSON_TRACE_SPAN("vault", "rebuild_indexes");
+        rebuildIndexes(snapshot);
         
         return true;
         
     } catch (const std::exception&) {
-        return false;
+        snapshot.entries.edit().clear();
+        return timed.fail();
     }
 }
 
-bool SecureVault::saveVaultFile() {
-    if (!is_open_ || vault_path_.empty()) {
-        return false;
+std::shared_ptr<SecureVault::Snapshot> SecureVault::takePrefetch(const std::string& vaultPath) {
+    std::shared_ptr<Prefetch> state;
+    {
+        std::lock_guard<std::mutex> lock(prefetch_mutex_);
+        if (!prefetch_ || prefetch_->path != vaultPath) {
+            return nullptr;
+        }
+        state = std::move(prefetch_);
+    }
+    
+    // Taken before anyone could drop it, so it is either decoded here or
+    // already being decoded by a worker
+    state->run();
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state]() { return state->done; });
+    return std::move(state->loaded);
+}
+
+bool SecureVault::saveVaultFile(const Snapshot& snapshot) {
+    static OperationMetrics& metrics = MetricsRegistry::global().operation("vault.save_file");
+    ScopedOperation timed(metrics);
+    CRIMSON_TRACE_SPAN("vault", "save_file");
+    
+    if (vault_path_.empty()) {
+        return timed.fail();
     }
     
     try {
-        QJsonObject root;
+        // Written directly rather than through QJsonDocument. Salt and
+        // master hash go first so a reader can find them without scanning
+        // past the entries
+        const EntryTable& entries = *snapshot.entries;
+        std::string content;
+        content.reserve(512 + entries.size() * 384);
         
-        // Save vault metadata
-        root["version"] = "1.0";
-        root["salt"] = QString::fromStdString(vault_salt_);
-        root["master_hash"] = QString::fromStdString(master_hash_);
-        root["created_at"] = QString::fromStdString(VaultEntry::getCurrentTimestamp());
-        root["device_fingerprint"] = QString::fromStdString(VaultEntry::getDeviceFingerprint());
+        {
+            CRIMSON_TRACE_SPAN("vault", "encode");
+            content += "{\n    \"version\": \"1.0\",\n    \"salt\": ";
+            EntryCodec::appendJsonString(vault_salt_, content);
+            content += ",\n    \"master_hash\": ";
+            EntryCodec::appendJsonString(master_hash_, content);
+            content += ",\n    \"created_at\": ";
+            EntryCodec::appendJsonString(Timestamp::now().toIso(), content);
+            content += ",\n    \"device_fingerprint\": ";
+            EntryCodec::appendJsonString(VaultEntry::getDeviceFingerprint(), content);
+            content += ",\n    \"entries\": [";
         
-        // Save entries
-        QJsonArray entriesArray;
-        for (const auto& entry : entries_) {
-            QJsonDocument entryDoc = QJsonDocument::fromJson(QByteArray::fromStdString(entry.toJson()));
-            entriesArray.append(entryDoc.object());
+            VaultEntry entry;
+            for (size_t row = 0; row < entries.size(); ++row) {
+                entries.materialize(row, entry);
+                content += row == 0 ? "\n        " : ",\n        ";
+                EntryCodec::appendJson(entry, content);
+            }
+            content += entries.empty() ? "]\n}\n" : "\n    ]\n}\n";
         }
-        root["entries"] = entriesArray;
         
-        QJsonDocument doc(root);
-        std::string content = doc.toJson().toStdString();
-        
-        std::ofstream file(vault_path_);
-        if (!file.good()) {
-            return false;
+        // A crash or power loss at any point leaves the previous file intact
+        AtomicFile file(vault_path_);
+        {
+            CRIMSON_TRACE_SPAN("vault", "write");
+            if (!file.write(content.data(), content.size())) {
+                return timed.fail();
+            }
         }
         
-        file << content;
-        file.close();
-        
+        // Covers the rename as well, which is mostly the directory's sync
+        CRIMSON_TRACE_SPAN("vault", "fsync");
+        if (!file.sync() || !file.commit()) {
+            return timed.fail();
+        }
         return true;
         
     } catch (const std::exception&) {
-        return false;
+        return timed.fail();
     }
 }
 
+void SecureVault::storeEntry(Snapshot& snapshot, const VaultEntry& entry) const {
+    // Encrypt the password before storing
+    VaultEntry encryptedEntry = entry;
+    std::vector<uint8_t> encryptedPassword = crypto_manager_->encrypt(entry.password, *snapshot.key);
+    encryptedEntry.password = crypto_manager_->toBase64(encryptedPassword);
+    
+    // Add or update entry. The snapshot is unpublished, so a failure here
+    // needs no undoing
+    size_t position = snapshot.find(entry.id);
+    EntryTable& entries = snapshot.entries.edit();
+    
+    if (position == entries.size()) {
+        position = entries.append(encryptedEntry);
+        snapshot.positions.edit()[entries.id(position)] = position;
+        indexEntry(snapshot, position);
+        return;
+    }
+    
+    // Only the indexes whose keys change are edited, so the rest stay
+    // shared with the previous snapshot
+    std::string label(entries.label(position));
+    std::string username(entries.username(position));
+    Timestamp createdAt = entries.createdAt(position);
+    Timestamp lastUsedAt = entries.lastUsedAt(position);
+    entries.assign(position, encryptedEntry);
+    
+    if (entries.label(position) != label || entries.username(position) != username) {
+        snapshot.search_index.edit().add(entry.id, std::string(entries.label(position)),
+                                         std::string(entries.username(position)));
+    }
+    rekey(snapshot.label_order, lowercase(label), lowercase(entries.label(position)), entry.id);
+    rekey(snapshot.created_order, createdAt, entries.createdAt(position), entry.id);
+    rekey(snapshot.last_used_order, lastUsedAt, entries.lastUsedAt(position), entry.id);
+}
+
+void SecureVault::indexEntry(Snapshot& snapshot, size_t row) {
+    const EntryTable& entries = *snapshot.entries;
+    const EntryId& id = entries.id(row);
+    snapshot.search_index.edit().add(id, std::string(entries.label(row)), std::string(entries.username(row)));
+    snapshot.label_order.edit().emplace(lowercase(entries.label(row)), id);
+    snapshot.created_order.edit().emplace(entries.createdAt(row), id);
+    snapshot.last_used_order.edit().emplace(entries.lastUsedAt(row), id);
+}
+
+void SecureVault::unindexEntry(Snapshot& snapshot, size_t row) {
+    const EntryTable& entries = *snapshot.entries;
+    const EntryId& id = entries.id(row);
+    snapshot.search_index.edit().remove(id);
+    snapshot.label_order.edit().erase({lowercase(entries.label(row)), id});
+    snapshot.created_order.edit().erase({entries.createdAt(row), id});
+    snapshot.last_used_order.edit().erase({entries.lastUsedAt(row), id});
+}
+
+void SecureVault::rebuildIndexes(Snapshot& snapshot) {
+    const EntryTable& entries = *snapshot.entries;
+    auto& positions = snapshot.positions.edit();
+    auto& searchIndex = snapshot.search_index.edit();
+    auto& labelOrder = snapshot.label_order.edit();
+    auto& createdOrder = snapshot.created_order.edit();
+    auto& lastUsedOrder = snapshot.last_used_order.edit();
+    positions.clear();
+    searchIndex.clear();
+    labelOrder.clear();
+    createdOrder.clear();
+    lastUsedOrder.clear();
+    
+    const size_t count = entries.size();
+    if (count < PARALLEL_INDEX_MIN_ENTRIES) {
+        positions.reserve(count);
+        for (size_t row = 0; row < count; ++row) {
+            positions[entries.id(row)] = row;
+            indexEntry(snapshot, row);
+        }
+        return;
+    }
+    
+    // The indexes share nothing, so each is built in its own task. Every
+    // builder inserts rows in table order, so the result does not depend on
+    // scheduling
+    runConcurrently({
+        [&]() {
+            positions.reserve(count);
+            for (size_t row = 0; row < count; ++row) {
+                positions[entries.id(row)] = row;
+            }
+        },
+        [&]() {
+            for (size_t row = 0; row < count; ++row) {
+                searchIndex.add(entries.id(row), std::string(entries.label(row)),
+                                std::string(entries.username(row)));
+            }
+        },
+        [&]() {
+            for (size_t row = 0; row < count; ++row) {
+                labelOrder.emplace(lowercase(entries.label(row)), entries.id(row));
+            }
+        },
+        [&]() {
+            for (size_t row = 0; row < count; ++row) {
+                createdOrder.emplace(entries.createdAt(row), entries.id(row));
+            }
+        },
+        [&]() {
+            for (size_t row = 0; row < count; ++row) {
+                lastUsedOrder.emplace(entries.lastUsedAt(row), entries.id(row));
+            }
+        },
+    });
+}
+
 std::string SecureVault::generateVaultMetadata() const {
     QJsonObject metadata;
     metadata["version"] = "1.0";
-    metadata["created_at"] = QString::fromStdString(VaultEntry::getCurrentTimestamp());
+    metadata["created_at"] = QString::fromStdString(Timestamp::now().toIso());
     metadata["device_fingerprint"] = QString::fromStdString(VaultEntry::getDeviceFingerprint());
     
     QJsonDocument doc(metadata);
@@ -386,12 +1466,5 @@ bool SecureVault::parseVaultMetadata(const std::string& metadata) {
     }
 }
 
-void SecureVault::clearSensitiveData() {
-    // Clear any sensitive data from memory
-    for (auto& entry : entries_) {
-        SecureMemory::secureZero(entry.password);
-    }
-}
-
 } // namespace core
 } // namespace crimson
@@ -0,0 +1,95 @@
+#include "core/Timestamp.h"
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+#include <cctype>
+#include <cstdio>
+
+namespace crimson {
+namespace core {
+
+Timestamp Timestamp::now() {
+    return Timestamp(QDateTime::currentSecsSinceEpoch());
+}
+
+Timestamp Timestamp::fromIso(std::string_view text) {
+    // Fast path for the "yyyy-MM-ddTHH:mm:ss[.fff][Z|+hh:mm]" form the vault
+    // writes; QDateTime is only used for anything else
+    if (text.empty()) {
+        return Timestamp();
+    }
+    
+    auto digits = [&text](size_t pos, size_t count, int& value) {
+        value = 0;
+        for (size_t i = pos; i < pos + count; ++i) {
+            if (i >= text.size() || !std::isdigit(static_cast<unsigned char>(text[i]))) {
+                return false;
+            }
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    };
+    
+    int year, month, day, hour, minute, second;
+    if (!digits(0, 4, year) || !digits(5, 2, month) || !digits(8, 2, day) ||
+        !digits(11, 2, hour) || !digits(14, 2, minute) || !digits(17, 2, second) ||
+        text[4] != '-' || text[7] != '-' || text[13] != ':' || text[16] != ':') {
+        QDateTime parsed = QDateTime::fromString(QString::fromUtf8(text.data(), static_cast<int>(text.size())), Qt::ISODate);
+        return parsed.isValid() ? Timestamp(parsed.toSecsSinceEpoch()) : Timestamp();
+    }
+    
+    // Days from civil (proleptic Gregorian)
+    int y = month <= 2 ? year - 1 : year;
+    int era = (y >= 0 ? y : y - 399) / 400;
+    int yoe = y - era * 400;
+    int doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    int64_t days = static_cast<int64_t>(era) * 146097 + doe - 719468;
+    int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    
+    // Optional UTC offset after optional fractional seconds
+    size_t pos = 19;
+    if (pos < text.size() && text[pos] == '.') {
+        ++pos;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+            ++pos;
+        }
+    }
+    int offsetHours, offsetMinutes;
+    if (pos < text.size() && (text[pos] == '+' || text[pos] == '-') &&
+        digits(pos + 1, 2, offsetHours) && digits(pos + 4, 2, offsetMinutes)) {
+        int64_t offset = offsetHours * 3600 + offsetMinutes * 60;
+        seconds += text[pos] == '+' ? -offset : offset;
+    }
+    
+    return Timestamp(seconds);
+}
+
+std::string Timestamp::toIso() const {
+    if (isNull()) {
+        return std::string();
+    }
+    
+    // Civil from days (proleptic Gregorian)
+    int64_t days = seconds_ >= 0 ? seconds_ / 86400 : (seconds_ - 86399) / 86400;
+    int64_t secondOfDay = seconds_ - days * 86400;
+    
+    int64_t z = days + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t doe = z - era * 146097;
+    int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    int64_t mp = (5 * doy + 2) / 153;
+    int64_t day = doy - (153 * mp + 2) / 5 + 1;
+    int64_t month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+    
+    char buffer[128];   // Room for any int64 field values
+    std::snprintf(buffer, sizeof(buffer), "%04lld-%02lld-%02lldT%02lld:%02lld:%02lldZ",
+                  static_cast<long long>(year), static_cast<long long>(month), static_cast<long long>(day),
+                  static_cast<long long>(secondOfDay / 3600), static_cast<long long>(secondOfDay / 60 % 60),
+                  static_cast<long long>(secondOfDay % 60));
+    return buffer;
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,166 @@
+#include "core/Trace.h"
+#include "core/EntryCodec.h"
+#include "core/FileUtil.h"
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    /**
+     * @brief One span; a seqlock so export can read while the owner writes
+     *
+     * sequence is 2n + 1 while the owner writes the n-th span of its
+     * thread into this slot and 2n + 2 once that span is complete.
+     */
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::atomic<const char*> category{nullptr};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> end{0};
+    };
+    
+    struct ThreadBuffer {
+        explicit ThreadBuffer(uint32_t id) : tid(id) {}
+        
+        const uint32_t tid;
+        std::atomic<uint64_t> head{0};   // Spans ever written; only the owner writes it
+        std::array<Slot, Trace::EVENTS_PER_THREAD> slots;
+    };
+    
+    // Buffers outlive their threads so their spans can still be exported,
+    // and are never freed: the registry is leaked like the shared executor
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+        std::atomic<uint64_t> cleared_at{0};
+    };
+    
+    Registry& registry() {
+        static Registry* instance = new Registry();
+        return *instance;
+    }
+    
+    thread_local ThreadBuffer* current_buffer = nullptr;
+    
+    ThreadBuffer& threadBuffer() {
+        if (!current_buffer) {
+            Registry& all = registry();
+            std::lock_guard<std::mutex> lock(all.mutex);
+            all.buffers.push_back(std::make_unique<ThreadBuffer>(static_cast<uint32_t>(all.buffers.size() + 1)));
+            current_buffer = all.buffers.back().get();
+        }
+        return *current_buffer;
+    }
+    
+    const auto process_start = std::chrono::steady_clock::now();
+    
+    // Chrome wants microseconds; keep nanosecond precision as decimals
+    void appendMicros(uint64_t nanos, std::string& out) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%llu.%03u",
+                      static_cast<unsigned long long>(nanos / 1000), static_cast<unsigned>(nanos % 1000));
+        out += buffer;
+    }
+}
+
+void Trace::setEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void Trace::clear() {
+    // Spans are filtered out on export rather than erased, as only their
+    // own thread may write its buffer
+    registry().cleared_at.store(nowNanos(), std::memory_order_relaxed);
+}
+
+uint64_t Trace::nowNanos() {
+    auto elapsed = std::chrono::steady_clock::now() - process_start;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+void Trace::record(const char* category, const char* name, uint64_t startNanos, uint64_t endNanos) {
+    ThreadBuffer& buffer = threadBuffer();
+    uint64_t n = buffer.head.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[n % EVENTS_PER_THREAD];
+    
+    slot.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(startNanos, std::memory_order_relaxed);
+    slot.end.store(endNanos, std::memory_order_relaxed);
+    slot.sequence.store(2 * n + 2, std::memory_order_release);
+    
+    buffer.head.store(n + 1, std::memory_order_release);
+}
+
+std::string Trace::toChromeJson() {
+    Registry& all = registry();
+    const uint64_t clearedAt = all.cleared_at.load(std::memory_order_relaxed);
+    std::vector<ThreadBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(all.mutex);
+        for (const auto& buffer : all.buffers) {
+            buffers.push_back(buffer.get());
+        }
+    }
+    
+    std::string out = "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    bool first = true;
+    auto beginEvent = [&]() {
+        out += first ? "\n" : ",\n";
+        first = false;
+    };
+    
+    for (ThreadBuffer* buffer : buffers) {
+        const std::string tid = std::to_string(buffer->tid);
+        beginEvent();
+        out += "{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": " + tid +
+               ", \"args\": {\"name\": \"thread " + tid + "\"}}";
+        
+        const uint64_t head = buffer->head.load(std::memory_order_acquire);
+        const uint64_t oldest = head > EVENTS_PER_THREAD ? head - EVENTS_PER_THREAD : 0;
+        for (uint64_t n = oldest; n < head; ++n) {
+            const Slot& slot = buffer->slots[n % EVENTS_PER_THREAD];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * n + 2) {
+                continue;   // Already overwritten
+            }
+            const char* category = slot.category.load(std::memory_order_relaxed);
+            const char* name = slot.name.load(std::memory_order_relaxed);
+            const uint64_t start = slot.start.load(std::memory_order_relaxed);
+            const uint64_t end = slot.end.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence || start < clearedAt) {
+                continue;
+            }
+            
+            beginEvent();
+            out += "{\"ph\": \"X\", \"cat\": ";
+            EntryCodec::appendJsonString(category, out);
+            out += ", \"name\": ";
+            EntryCodec::appendJsonString(name, out);
+            out += ", \"pid\": 1, \"tid\": " + tid + ", \"ts\": ";
+            appendMicros(start, out);
+            out += ", \"dur\": ";
+            appendMicros(end >= start ? end - start : 0, out);
+            out += '}';
+        }
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+bool Trace::writeFile(const std::string& path) {
+    return writeFileAtomically(path, toChromeJson());
+}
+
+} // namespace core
+} // namespace crimson
@@ -1,8 +1,7 @@
 #include "core/VaultEntry.h"
+#include "core/EntryCodec.h"
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
-#include <QtCore/QUuid>
-#include <QtCore/QDateTime>
 #include <QtCore/QCryptographicHash>
 #include <QtCore/QSysInfo>
 #include <stdexcept>
@@ -11,16 +10,9 @@ namespace crimson {
 namespace core {
 
 std::string VaultEntry::toJson() const {
-    QJsonObject obj;
-    obj["id"] = QString::fromStdString(id);
-    obj["label"] = QString::fromStdString(label);
-    obj["username"] = QString::fromStdString(username);
-    obj["password"] = QString::fromStdString(password);
-    obj["created_at"] = QString::fromStdString(created_at);
-    obj["device_fingerprint"] = QString::fromStdString(device_fingerprint);
-    
-    QJsonDocument doc(obj);
-    return doc.toJson(QJsonDocument::Compact).toStdString();
+    std::string json;
+    EntryCodec::appendJson(*this, json);
+    return json;
 }
 
 VaultEntry VaultEntry::fromJson(const std::string& json) {
@@ -35,30 +27,10 @@ VaultEntry VaultEntry::fromJson(const std::string& json) {
         throw std::runtime_error("Invalid vault entry JSON: not an object");
     }
     
-    QJsonObject obj = doc.object();
-    VaultEntry entry;
-    
-    entry.id = obj["id"].toString().toStdString();
-    entry.label = obj["label"].toString().toStdString();
-    entry.username = obj["username"].toString().toStdString();
-    entry.password = obj["password"].toString().toStdString();
-    entry.created_at = obj["created_at"].toString().toStdString();
-    entry.device_fingerprint = obj["device_fingerprint"].toString().toStdString();
-    
-    return entry;
+    return EntryCodec::fromJson(doc.object());
 }
 
-std::string VaultEntry::generateUuid() {
-    QUuid uuid = QUuid::createUuid();
-    return uuid.toString(QUuid::WithoutBraces).toStdString();
-}
-
-std::string VaultEntry::getCurrentTimestamp() {
-    QDateTime now = QDateTime::currentDateTimeUtc();
-    return now.toString(Qt::ISODate).toStdString();
-}
-
-std::string VaultEntry::getDeviceFingerprint() {
+static std::string computeDeviceFingerprint() {
     // Create device fingerprint from various system properties
     QString deviceInfo;
     
@@ -88,5 +60,10 @@ std::string VaultEntry::getDeviceFingerprint() {
     return hash.result().toHex().toStdString();
 }
 
+std::string VaultEntry::getDeviceFingerprint() {
+    static const std::string fingerprint = computeDeviceFingerprint();
+    return fingerprint;
+}
+
 } // namespace core
 } // namespace crimson
@@ -0,0 +1,553 @@
+#include "core/VaultReader.h"
+#include "core/EntryCodec.h"
+#include "core/Executor.h"
+#include "core/JsonStructuralIndex.h"
+#include "core/MappedFile.h"
+#include "core/Trace.h"
+#include "core/SecureMemory.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+namespace crimson {
+namespace core {
+
+namespace {
+    [[noreturn]] void malformed(const char* reason) {
+        throw std::runtime_error(std::string("Malformed vault JSON: ") + reason);
+    }
+    
+    bool isWhitespace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+    }
+    
+    int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+    
+    uint32_t readHex4(std::string_view text, size_t pos) {
+        if (pos + 4 > text.size()) {
+            malformed("truncated \\u escape");
+        }
+        uint32_t value = 0;
+        for (size_t i = pos; i < pos + 4; ++i) {
+            int digit = hexValue(text[i]);
+            if (digit < 0) {
+                malformed("invalid \\u escape");
+            }
+            value = value << 4 | static_cast<uint32_t>(digit);
+        }
+        return value;
+    }
+    
+    void appendUtf8(uint32_t codePoint, std::string& out) {
+        if (codePoint < 0x80) {
+            out.push_back(static_cast<char>(codePoint));
+        } else if (codePoint < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | codePoint >> 6));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else if (codePoint < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | codePoint >> 12));
+            out.push_back(static_cast<char>(0x80 | (codePoint >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | codePoint >> 18));
+            out.push_back(static_cast<char>(0x80 | (codePoint >> 12 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint >> 6 & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+        }
+    }
+    
+    void unescape(std::string_view raw, std::string& out) {
+        out.clear();
+        size_t pos = 0;
+        while (pos < raw.size()) {
+            size_t backslash = raw.find('\\', pos);
+            if (backslash == std::string_view::npos) {
+                out.append(raw.data() + pos, raw.size() - pos);
+                break;
+            }
+            out.append(raw.data() + pos, backslash - pos);
+            if (backslash + 1 >= raw.size()) {
+                malformed("dangling escape");
+            }
+            
+            pos = backslash + 2;
+            switch (raw[backslash + 1]) {
+            case '"':  out.push_back('"'); break;
+            case '\\': out.push_back('\\'); break;
+            case '/':  out.push_back('/'); break;
+            case 'b':  out.push_back('\b'); break;
+            case 'f':  out.push_back('\f'); break;
+            case 'n':  out.push_back('\n'); break;
+            case 'r':  out.push_back('\r'); break;
+            case 't':  out.push_back('\t'); break;
+            case 'u': {
+                uint32_t codePoint = readHex4(raw, pos);
+                pos += 4;
+                if (codePoint >= 0xD800 && codePoint < 0xDC00 && pos + 6 <= raw.size() &&
+                    raw[pos] == '\\' && raw[pos + 1] == 'u') {
+                    uint32_t low = readHex4(raw, pos + 2);
+                    if (low >= 0xDC00 && low < 0xE000) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                        pos += 6;
+                    }
+                }
+                if (codePoint >= 0xD800 && codePoint < 0xE000) {
+                    codePoint = 0xFFFD;   // Unpaired surrogate
+                }
+                appendUtf8(codePoint, out);
+                break;
+            }
+            default:
+                malformed("invalid escape");
+            }
+        }
+    }
+    
+    /**
+     * @brief Byte range of consecutive "entries" elements, without the
+     * separators around it
+     */
+    struct Chunk {
+        size_t begin;
+        size_t end;
+    };
+    
+    /**
+     * @brief Second stage: walks structural offsets and decodes values
+     */
+    class Parser {
+    public:
+        enum class Mode {
+            Decode,       // Decode entries into the table
+            Split,        // Only record chunk boundaries in the entries array
+            HeaderOnly    // Stop at "entries" once salt and master hash are known
+        };
+        
+        Parser(std::string_view document, const MappedFile* file, Mode mode = Mode::Decode)
+            : doc_(document), file_(file), mode_(mode),
+              next_(0), scanned_(0), consumed_(0), released_(0) {}
+        
+        /**
+         * @brief Parse a whole vault document
+         */
+        VaultReader::Header parse(EntryTable& table);
+        
+        /**
+         * @brief Decode a Chunk: entries elements separated by commas
+         */
+        void parseElements(EntryTable& table);
+        
+        const std::vector<Chunk>& chunks() const { return chunks_; }
+    
+    private:
+        std::string_view doc_;
+        const MappedFile* file_;   // Source mapping, if any, for releasing read pages
+        Mode mode_;
+        JsonStructuralIndex index_;
+        std::vector<uint64_t> offsets_;   // Current window
+        size_t next_;       // Next unread offset in offsets_
+        size_t scanned_;    // Document bytes indexed so far
+        size_t consumed_;   // Position just past the last token or value taken
+        size_t released_;   // Document bytes handed back to the kernel
+        std::string key_scratch_;
+        std::string value_scratch_;
+        std::vector<Chunk> chunks_;
+        
+        bool fill();
+        size_t peekToken();
+        size_t takeToken();
+        char takeStructural();
+        void expect(char c);
+        size_t nextPosition();
+        char nextChar() { return doc_[nextPosition()]; }
+        std::string_view readString(std::string& scratch);
+        void skipValue();
+        void readElement(EntryTable& table, VaultEntry& entry);
+        void readEntries(EntryTable& table);
+        void splitEntries();
+        void expectEnd();
+    };
+    
+    bool Parser::fill() {
+        while (next_ == offsets_.size()) {
+            if (scanned_ >= doc_.size()) {
+                return false;
+            }
+            
+            if (file_ && consumed_ > released_ + VaultReader::WINDOW_BYTES) {
+                file_->discard(released_, consumed_ - released_);
+                released_ = consumed_;
+            }
+            
+            offsets_.clear();
+            next_ = 0;
+            size_t length = std::min(VaultReader::WINDOW_BYTES, doc_.size() - scanned_);
+            index_.scan(doc_.data() + scanned_, length, scanned_, offsets_);
+            scanned_ += length;
+        }
+        return true;
+    }
+    
+    size_t Parser::peekToken() {
+        if (!fill()) {
+            malformed("unexpected end of document");
+        }
+        return static_cast<size_t>(offsets_[next_]);
+    }
+    
+    size_t Parser::takeToken() {
+        size_t pos = peekToken();
+        ++next_;
+        consumed_ = pos + 1;
+        return pos;
+    }
+    
+    char Parser::takeStructural() {
+        size_t from = consumed_;
+        size_t pos = takeToken();
+        for (size_t i = from; i < pos; ++i) {
+            if (!isWhitespace(doc_[i])) {
+                malformed("unexpected text between tokens");
+            }
+        }
+        return doc_[pos];
+    }
+    
+    void Parser::expect(char c) {
+        if (takeStructural() != c) {
+            malformed("unexpected token");
+        }
+    }
+    
+    size_t Parser::nextPosition() {
+        size_t pos = consumed_;
+        while (pos < doc_.size() && isWhitespace(doc_[pos])) {
+            ++pos;
+        }
+        if (pos == doc_.size()) {
+            malformed("unexpected end of document");
+        }
+        return pos;
+    }
+    
+    std::string_view Parser::readString(std::string& scratch) {
+        expect('"');
+        size_t open = consumed_ - 1;
+        size_t close = takeToken();
+        
+        std::string_view raw = doc_.substr(open + 1, close - open - 1);
+        if (std::memchr(raw.data(), '\\', raw.size()) == nullptr) {
+            return raw;
+        }
+        unescape(raw, scratch);
+        return scratch;
+    }
+    
+    void Parser::skipValue() {
+        size_t start = nextPosition();
+        char c = doc_[start];
+        if (c == '"') {
+            expect('"');
+            takeToken();
+            return;
+        }
+        
+        if (c == '{' || c == '[') {
+            int depth = 0;
+            do {
+                switch (doc_[takeToken()]) {
+                case '{': case '[': ++depth; break;
+                case '}': case ']': --depth; break;
+                default: break;
+                }
+            } while (depth > 0);
+            return;
+        }
+        
+        // Number, true, false or null: everything up to the next token (or
+        // the end, for the last element of a chunk)
+        size_t end = fill() ? static_cast<size_t>(offsets_[next_]) : doc_.size();
+        while (end > start && isWhitespace(doc_[end - 1])) {
+            --end;
+        }
+        
+        std::string_view text = doc_.substr(start, end - start);
+        if (text != "true" && text != "false" && text != "null" &&
+            (text.empty() || text.find_first_not_of("-+.eE0123456789") != std::string_view::npos)) {
+            malformed("invalid value");
+        }
+        consumed_ = end;
+    }
+    
+    void Parser::readElement(EntryTable& table, VaultEntry& entry) {
+        if (nextChar() != '{') {
+            skipValue();   // Not an entry object; ignored like before
+            return;
+        }
+        
+        expect('{');
+        EntryCodec::clear(entry);
+        bool hasId = false;
+        
+        if (nextChar() == '}') {
+            expect('}');
+        } else {
+            for (;;) {
+                std::string_view name = readString(key_scratch_);
+                expect(':');
+                if (nextChar() == '"') {
+                    std::string_view text = readString(value_scratch_);
+                    if (EntryCodec::assignField(name, text, entry) && name == "id") {
+                        hasId = true;
+                    }
+                } else {
+                    skipValue();
+                }
+                
+                char separator = takeStructural();
+                if (separator == '}') {
+                    break;
+                }
+                if (separator != ',') {
+                    malformed("expected ',' or '}' in entry");
+                }
+            }
+        }
+        
+        if (!hasId) {
+            malformed("entry without an id");
+        }
+        table.append(entry);
+    }
+    
+    void Parser::readEntries(EntryTable& table) {
+        expect('[');
+        if (nextChar() == ']') {
+            expect(']');
+            return;
+        }
+        
+        VaultEntry entry;
+        for (;;) {
+            readElement(table, entry);
+            
+            char separator = takeStructural();
+            if (separator == ']') {
+                break;
+            }
+            if (separator != ',') {
+                malformed("expected ',' or ']' in entries");
+            }
+        }
+        
+        SecureMemory::secureZero(entry.password);
+    }
+    
+    void Parser::splitEntries() {
+        expect('[');
+        if (nextChar() == ']') {
+            expect(']');
+            return;
+        }
+        
+        // Elements are only delimited here; each chunk is decoded (and fully
+        // checked) later by its own Parser
+        Chunk chunk{nextPosition(), 0};
+        for (;;) {
+            skipValue();
+            chunk.end = consumed_;
+            
+            char separator = takeStructural();
+            if (separator != ']' && separator != ',') {
+                malformed("expected ',' or ']' in entries");
+            }
+            if (separator == ']' || chunk.end - chunk.begin >= VaultReader::CHUNK_BYTES) {
+                chunks_.push_back(chunk);
+                if (separator == ']') {
+                    break;
+                }
+                chunk.begin = nextPosition();
+            }
+        }
+    }
+    
+    void Parser::parseElements(EntryTable& table) {
+        VaultEntry entry;
+        for (;;) {
+            readElement(table, entry);
+            if (!fill()) {
+                break;
+            }
+            expect(',');
+        }
+        SecureMemory::secureZero(entry.password);
+        expectEnd();
+    }
+    
+    void Parser::expectEnd() {
+        if (fill() || index_.inString()) {
+            malformed("trailing content");
+        }
+        for (size_t i = consumed_; i < doc_.size(); ++i) {
+            if (!isWhitespace(doc_[i])) {
+                malformed("trailing content");
+            }
+        }
+    }
+    
+    VaultReader::Header Parser::parse(EntryTable& table) {
+        VaultReader::Header header;
+        table.clear();
+        
+        expect('{');
+        if (nextChar() == '}') {
+            expect('}');
+        } else {
+            for (;;) {
+                std::string name(readString(key_scratch_));
+                expect(':');
+                
+                std::string* field = nullptr;
+                if (name == "version") {
+                    field = &header.version;
+                } else if (name == "salt") {
+                    field = &header.salt;
+                } else if (name == "master_hash") {
+                    field = &header.master_hash;
+                } else if (name == "created_at") {
+                    field = &header.created_at;
+                } else if (name == "device_fingerprint") {
+                    field = &header.device_fingerprint;
+                }
+                
+                if (name == "entries") {
+                    if (mode_ == Mode::HeaderOnly && !header.salt.empty() && !header.master_hash.empty()) {
+                        return header;
+                    }
+                    if (mode_ == Mode::Decode) {
+                        readEntries(table);
+                    } else if (mode_ == Mode::Split) {
+                        splitEntries();
+                    } else {
+                        skipValue();
+                    }
+                } else if (field && nextChar() == '"') {
+                    *field = std::string(readString(value_scratch_));
+                } else {
+                    skipValue();
+                }
+                
+                char separator = takeStructural();
+                if (separator == '}') {
+                    break;
+                }
+                if (separator != ',') {
+                    malformed("expected ',' or '}' in vault object");
+                }
+            }
+        }
+        
+        expectEnd();
+        return header;
+    }
+    
+    VaultReader::Header readParallel(std::string_view document, EntryTable& table, unsigned threads) {
+        Parser splitter(document, nullptr, Parser::Mode::Split);
+        VaultReader::Header header;
+        {
+            CRIMSON_TRACE_SPAN("vault", "split_entries");
+            header = splitter.parse(table);
+        }
+        const std::vector<Chunk>& chunks = splitter.chunks();
+        
+        std::vector<EntryTable> parts(chunks.size());
+        std::vector<std::exception_ptr> errors(chunks.size());
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<bool> failed{false};
+        
+        // Chunks are claimed in order, so every chunk before a failing one
+        // is still decoded and the error reported is always the first
+        auto worker = [&]() {
+            for (size_t i = nextChunk++; i < chunks.size() && !failed; i = nextChunk++) {
+                try {
+                    CRIMSON_TRACE_SPAN("vault", "decode_chunk");
+                    Parser parser(document.substr(chunks[i].begin, chunks[i].end - chunks[i].begin), nullptr);
+                    parser.parseElements(parts[i]);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                    failed = true;
+                }
+            }
+        };
+        
+        threads = static_cast<unsigned>(std::min<size_t>(threads, chunks.size()));
+        {
+            TaskGroup group;
+            for (unsigned t = 0; t < threads; ++t) {
+                group.run(worker);
+            }
+            group.wait();
+        }
+        
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+        
+        // Merge in document order
+        CRIMSON_TRACE_SPAN("vault", "merge_chunks");
+        size_t rows = 0;
+        for (const auto& part : parts) {
+            rows += part.size();
+        }
+        table.reserve(rows);
+        for (auto& part : parts) {
+            table.appendRows(part);
+            part.clear();
+        }
+        return header;
+    }
+}
+
+VaultReader::Header VaultReader::readFile(const std::string& path, EntryTable& table, unsigned threads) {
+    CRIMSON_TRACE_SPAN("vault", "read_entries");
+    MappedFile file(path);
+    file.adviseSequential();
+    
+    std::string_view document(reinterpret_cast<const char*>(file.data()), file.size());
+    if (threads > 1) {
+        return readParallel(document, table, threads);
+    }
+    Parser parser(document, &file);
+    return parser.parse(table);
+}
+
+VaultReader::Header VaultReader::read(std::string_view document, EntryTable& table, unsigned threads) {
+    if (threads > 1) {
+        return readParallel(document, table, threads);
+    }
+    Parser parser(document, nullptr);
+    return parser.parse(table);
+}
+
+VaultReader::Header VaultReader::readHeader(const std::string& path) {
+    MappedFile file(path);
+    file.adviseSequential();
+    
+    std::string_view document(reinterpret_cast<const char*>(file.data()), file.size());
+    EntryTable unused;
+    Parser parser(document, &file, Parser::Mode::HeaderOnly);
+    return parser.parse(unused);
+}
+
+} // namespace core
+} // namespace crimson
@@ -0,0 +1,151 @@
+#include "core/Wordlist.h"
+#include <QtCore/QtGlobal>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace crimson {
+namespace core {
+
+Wordlist::Wordlist(const std::string& path)
+    : file_(path)
+    , duplicates_(0)
+    , oversized_(0) {
+    if (file_.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Wordlist file is too large");
+    }
+}
+
+size_t Wordlist::size() const {
+    ensureIndexed();
+    return offsets_.size();
+}
+
+size_t Wordlist::duplicateWords() const {
+    ensureIndexed();
+    return duplicates_;
+}
+
+size_t Wordlist::oversizedWords() const {
+    ensureIndexed();
+    return oversized_;
+}
+
+std::string_view Wordlist::word(size_t index) const {
+    ensureIndexed();
+    if (index >= offsets_.size()) {
+        throw std::out_of_range("Wordlist index out of range");
+    }
+    
+    return std::string_view(reinterpret_cast<const char*>(file_.data()) + offsets_[index],
+                            lengths_[index]);
+}
+
+double Wordlist::bitsPerWord() const {
+    size_t count = size();
+    return count > 1 ? std::log2(static_cast<double>(count)) : 0.0;
+}
+
+void Wordlist::ensureIndexed() const {
+    std::call_once(indexed_, [this] { buildIndex(); });
+}
+
+void Wordlist::buildIndex() const {
+    const char* data = reinterpret_cast<const char*>(file_.data());
+    const size_t size = file_.size();
+    
+    file_.adviseSequential();
+    
+    // Count lines first so the index is allocated exactly once
+    size_t lines = 0;
+    for (const char* p = data; p && p < data + size;) {
+        const void* nl = std::memchr(p, '\n', static_cast<size_t>(data + size - p));
+        ++lines;
+        p = nl ? static_cast<const char*>(nl) + 1 : data + size;
+    }
+    
+    offsets_.reserve(lines);
+    lengths_.reserve(lines);
+    
+    // Open-addressed set of the words indexed so far, holding index + 1
+    // (0 is empty) so repeats are found without allocating per word. A
+    // repeated word would otherwise count twice towards bitsPerWord() and
+    // be drawn twice as often
+    size_t capacity = 2;
+    while (capacity < lines * 2) {
+        capacity *= 2;
+    }
+    std::vector<uint32_t> seen(capacity, 0);
+    std::hash<std::string_view> hash;
+    
+    size_t pos = 0;
+    while (pos < size) {
+        const void* nl = std::memchr(data + pos, '\n', size - pos);
+        size_t end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data) : size;
+        
+        // Trim surrounding whitespace (including CR from CRLF files)
+        size_t start = pos;
+        size_t stop = end;
+        while (start < stop && std::isspace(static_cast<unsigned char>(data[start]))) {
+            ++start;
+        }
+        while (stop > start && std::isspace(static_cast<unsigned char>(data[stop - 1]))) {
+            --stop;
+        }
+        
+        // Skip a leading dice roll ("11111<TAB>word"): digits, then
+        // whitespace, then the rest of the line as it is
+        size_t digits = start;
+        while (digits < stop && std::isdigit(static_cast<unsigned char>(data[digits]))) {
+            ++digits;
+        }
+        if (digits > start && digits < stop && (data[digits] == '\t' || data[digits] == ' ')) {
+            start = digits;
+            while (start < stop && (data[start] == '\t' || data[start] == ' ')) {
+                ++start;
+            }
+        }
+        
+        size_t length = stop - start;
+        if (length > MAX_WORD_LENGTH) {
+            ++oversized_;
+        } else if (length > 0) {
+            size_t slot = hash(std::string_view(data + start, length)) & (capacity - 1);
+            bool repeated = false;
+            for (; seen[slot] != 0; slot = (slot + 1) & (capacity - 1)) {
+                size_t other = seen[slot] - 1;
+                if (lengths_[other] == length && std::memcmp(data + offsets_[other], data + start, length) == 0) {
+                    repeated = true;
+                    break;
+                }
+            }
+            
+            if (repeated) {
+                ++duplicates_;
+            } else {
+                seen[slot] = static_cast<uint32_t>(offsets_.size() + 1);
+                offsets_.push_back(static_cast<uint32_t>(start));
+                lengths_.push_back(static_cast<uint8_t>(length));
+            }
+        }
+        
+        pos = end + 1;
+    }
+    
+    if (oversized_ > 0) {
+        qWarning("Wordlist: skipped %zu words longer than %zu characters",
+                 oversized_, MAX_WORD_LENGTH);
+    }
+    if (offsets_.size() < 2) {
+        throw std::runtime_error("Wordlist must contain at least two distinct words");
+    }
+    
+    file_.adviseRandom();
+}
+
+} // namespace core
+} // namespace crimson
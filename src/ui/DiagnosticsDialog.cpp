@@ -0,0 +1,188 @@
+#include "ui/DiagnosticsDialog.h"
+#include "core/Metrics.h"
+#include "core/Trace.h"
+
+#include <QtWidgets/QFileDialog>
+#include <QtWidgets/QHeaderView>
+#include <QtWidgets/QMessageBox>
+#include <QtCore/QStandardPaths>
+
+namespace crimson {
+namespace ui {
+
+namespace {
+    constexpr int REFRESH_INTERVAL_MS = 2000;
+    
+    // Seconds as the most readable of s, ms or µs
+    QString formatDuration(double seconds) {
+        if (seconds >= 1.0) {
+            return QString::number(seconds, 'f', 2) + " s";
+        }
+        if (seconds >= 1e-3) {
+            return QString::number(seconds * 1e3, 'f', 2) + " ms";
+        }
+        return QString::number(seconds * 1e6, 'f', 1) + " µs";
+    }
+}
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget* parent)
+    : QDialog(parent)
+    , refresh_timer_(new QTimer(this)) {
+    
+    setupUI();
+    onRefresh();
+    
+    connect(refresh_timer_, &QTimer::timeout, this, &DiagnosticsDialog::onRefresh);
+    refresh_timer_->start(REFRESH_INTERVAL_MS);
+}
+
+void DiagnosticsDialog::setupUI() {
+    setWindowTitle("Diagnostics");
+    setModal(true);
+    resize(900, 500);
+    
+    main_layout_ = new QVBoxLayout(this);
+    main_layout_->setSpacing(15);
+    
+    summary_label_ = new QLabel;
+    summary_label_->setStyleSheet("color: #666;");
+    main_layout_->addWidget(summary_label_);
+    
+    const QStringList headers = {
+        "Operation", "Calls", "Failures", "Mean", "p50", "p90", "p99", "p99.9", "Max"
+    };
+    table_ = new QTableWidget(0, headers.size());
+    table_->setHorizontalHeaderLabels(headers);
+    table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table_->setSelectionBehavior(QAbstractItemView::SelectRows);
+    table_->verticalHeader()->hide();
+    table_->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    main_layout_->addWidget(table_);
+    
+    // Action buttons
+    button_layout_ = new QHBoxLayout;
+    button_layout_->setSpacing(10);
+    
+    refresh_btn_ = new QPushButton("Refresh");
+    connect(refresh_btn_, &QPushButton::clicked, this, &DiagnosticsDialog::onRefresh);
+    button_layout_->addWidget(refresh_btn_);
+    
+    reset_btn_ = new QPushButton("Reset");
+    connect(reset_btn_, &QPushButton::clicked, this, &DiagnosticsDialog::onReset);
+    button_layout_->addWidget(reset_btn_);
+    
+    trace_check_ = new QCheckBox("Record trace");
+    trace_check_->setChecked(crimson::core::Trace::enabled());
+    trace_check_->setToolTip("Record where vault and crypto operations spend their time");
+    connect(trace_check_, &QCheckBox::toggled, this, &DiagnosticsDialog::onTraceToggled);
+    button_layout_->addWidget(trace_check_);
+    
+    export_trace_btn_ = new QPushButton("Export Trace...");
+    connect(export_trace_btn_, &QPushButton::clicked, this, &DiagnosticsDialog::onExportTrace);
+    button_layout_->addWidget(export_trace_btn_);
+    
+    button_layout_->addStretch();
+    
+    export_prometheus_btn_ = new QPushButton("Export Prometheus...");
+    connect(export_prometheus_btn_, &QPushButton::clicked, this, &DiagnosticsDialog::onExportPrometheus);
+    button_layout_->addWidget(export_prometheus_btn_);
+    
+    export_json_btn_ = new QPushButton("Export JSON...");
+    connect(export_json_btn_, &QPushButton::clicked, this, &DiagnosticsDialog::onExportJson);
+    button_layout_->addWidget(export_json_btn_);
+    
+    close_btn_ = new QPushButton("Close");
+    connect(close_btn_, &QPushButton::clicked, this, &QDialog::accept);
+    button_layout_->addWidget(close_btn_);
+    
+    main_layout_->addLayout(button_layout_);
+}
+
+void DiagnosticsDialog::onRefresh() {
+    const auto operations = crimson::core::MetricsRegistry::global().summaries();
+    
+    table_->setRowCount(static_cast<int>(operations.size()));
+    uint64_t calls = 0;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        const auto& op = operations[i];
+        const QString cells[] = {
+            QString::fromStdString(op.name),
+            QString::number(op.count),
+            QString::number(op.failures),
+            formatDuration(op.meanSeconds),
+            formatDuration(op.p50Seconds),
+            formatDuration(op.p90Seconds),
+            formatDuration(op.p99Seconds),
+            formatDuration(op.p999Seconds),
+            formatDuration(op.maxSeconds)
+        };
+        for (int column = 0; column < table_->columnCount(); ++column) {
+            auto* item = new QTableWidgetItem(cells[column]);
+            if (column > 0) {
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            }
+            table_->setItem(static_cast<int>(i), column, item);
+        }
+        calls += op.count;
+    }
+    
+    summary_label_->setText(QString("%1 operations, %2 calls since start or last reset")
+                                .arg(operations.size())
+                                .arg(calls));
+}
+
+void DiagnosticsDialog::onReset() {
+    crimson::core::MetricsRegistry::global().reset();
+    onRefresh();
+}
+
+void DiagnosticsDialog::onExportPrometheus() {
+    exportTo(true);
+}
+
+void DiagnosticsDialog::onExportJson() {
+    exportTo(false);
+}
+
+void DiagnosticsDialog::onTraceToggled(bool enabled) {
+    if (enabled) {
+        crimson::core::Trace::clear();   // Start the recording afresh
+    }
+    crimson::core::Trace::setEnabled(enabled);
+}
+
+void DiagnosticsDialog::onExportTrace() {
+    QString path = QFileDialog::getSaveFileName(
+        this,
+        "Export Trace",
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/crimsonlock-trace.json",
+        "Chrome Trace (*.json);;All Files (*)"
+    );
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    if (!crimson::core::Trace::writeFile(path.toStdString())) {
+        QMessageBox::warning(this, "Export Failed", "Could not write " + path);
+    }
+}
+
+void DiagnosticsDialog::exportTo(bool prometheus) {
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QString path = QFileDialog::getSaveFileName(
+        this,
+        prometheus ? "Export Prometheus Metrics" : "Export JSON Metrics",
+        directory + (prometheus ? "/crimsonlock.prom" : "/crimsonlock-metrics.json"),
+        prometheus ? "Prometheus Textfile (*.prom);;All Files (*)" : "JSON Files (*.json);;All Files (*)"
+    );
+    if (path.isEmpty()) {
+        return;
+    }
+    
+    if (!crimson::core::MetricsRegistry::global().writeFile(path.toStdString(), prometheus)) {
+        QMessageBox::warning(this, "Export Failed", "Could not write " + path);
+    }
+}
+
+} // namespace ui
+} // namespace crimson
@@ -1,7 +1,9 @@
 #include "ui/MainWindow.h"
 #include "ui/VaultCreationDialog.h"
 #include "ui/VaultViewDialog.h"
+#include "ui/DiagnosticsDialog.h"
 #include "core/SecureVault.h"
+#include "core/AsyncVault.h"
 
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
@@ -17,10 +19,23 @@
 namespace crimson {
 namespace ui {
 
+namespace {
+    // Result of a vault operation that reports failure as false
+    bool succeeded(std::future<bool>& result) {
+        try {
+            return result.get();
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+}
+
 MainWindow::MainWindow(QWidget* parent)
     : QMainWindow(parent)
     , vault_(std::make_unique<crimson::core::SecureVault>())
+    , async_vault_(std::make_unique<crimson::core::AsyncVault>(*vault_))
     , auto_lock_timer_(new QTimer(this))
+    , pending_(false)
     , central_widget_(nullptr)
     , main_layout_(nullptr)
     , welcome_widget_(nullptr)
@@ -181,7 +196,7 @@ void MainWindow::setupMenuBar() {
     vaultMenu->addAction("&View Entries...", this, &MainWindow::onViewVault, QKeySequence("Ctrl+V"));
     
     auto* toolsMenu = menuBar()->addMenu("&Tools");
-    toolsMenu->addAction("&Settings...", this, &MainWindow::onSettings);
+    toolsMenu->addAction("&Diagnostics...", this, &MainWindow::onSettings);
     
     auto* helpMenu = menuBar()->addMenu("&Help");
     helpMenu->addAction("&About...", this, &MainWindow::onAbout);
@@ -252,15 +267,22 @@ void MainWindow::onCreateVault() {
         return;
     }
     
-    if (vault_->createVault(masterPassword.toStdString(), vaultPath.toStdString())) {
-        showInfo("Vault Created", 
-            "Vault created successfully!\n\n"
-            "Your vault is now ready to use. Remember your master password - "
-            "it cannot be recovered if lost!");
-        showVaultScreen();
-    } else {
-        showCriticalError("Creation Failed", "Failed to create vault. Please try again.");
+    if (!beginPending("Creating vault...")) {
+        return;
     }
+    async_vault_->createVault(masterPassword.toStdString(), vaultPath.toStdString(), this,
+        [this](std::future<bool> created) {
+            endPending();
+            if (succeeded(created)) {
+                showInfo("Vault Created", 
+                    "Vault created successfully!\n\n"
+                    "Your vault is now ready to use. Remember your master password - "
+                    "it cannot be recovered if lost!");
+                showVaultScreen();
+            } else {
+                showCriticalError("Creation Failed", "Failed to create vault. Please try again.");
+            }
+        });
 }
 
 void MainWindow::onOpenVault() {
@@ -275,23 +297,31 @@ void MainWindow::onOpenVault() {
         return;
     }
     
+    // Read the file while the password is typed; unlock then only waits on the KDF
+    vault_->prefetch(vaultPath.toStdString());
+    
     QString masterPassword = getSecurePasswordInput(
         "Open Vault", 
         "Enter your master password:"
     );
     
-    if (masterPassword.isEmpty()) {
+    // Not opening after all: free whatever the prefetch decoded
+    if (masterPassword.isEmpty() || !beginPending("Unlocking vault...")) {
+        vault_->cancelPrefetch();
         return;
     }
-    
-    if (vault_->openVault(masterPassword.toStdString(), vaultPath.toStdString())) {
-        showInfo("Vault Opened", "Vault unlocked successfully!");
-        showVaultScreen();
-    } else {
-        showCriticalError("Authentication Failed", 
-            "Incorrect password or corrupted vault file.\n"
-            "Please check your password and try again.");
-    }
+    async_vault_->openVault(masterPassword.toStdString(), vaultPath.toStdString(), this,
+        [this](std::future<bool> opened) {
+            endPending();
+            if (succeeded(opened)) {
+                showInfo("Vault Opened", "Vault unlocked successfully!");
+                showVaultScreen();
+            } else {
+                showCriticalError("Authentication Failed", 
+                    "Incorrect password or corrupted vault file.\n"
+                    "Please check your password and try again.");
+            }
+        });
 }
 
 void MainWindow::onCreateEntry() {
@@ -300,19 +330,23 @@ void MainWindow::onCreateEntry() {
         return;
     }
     
-    VaultCreationDialog dialog(this);
+    VaultCreationDialog dialog(async_vault_.get(), this);
     if (dialog.exec() == QDialog::Accepted) {
         auto entry = dialog.getEntry();
-        if (!entry.id.empty()) {
-            if (vault_->saveEntry(entry)) {
-                showInfo("Entry Saved", 
-                    QString("Entry '%1' has been saved to the vault.\n\n"
-                            "The credentials were displayed only once and are now encrypted.")
-                    .arg(QString::fromStdString(entry.label)));
-                updateSecurityStatus();
-            } else {
-                showCriticalError("Save Failed", "Failed to save entry to vault.");
-            }
+        if (!entry.id.empty() && beginPending("Saving entry...")) {
+            QString label = QString::fromStdString(entry.label);
+            async_vault_->saveEntry(entry, this, [this, label](std::future<bool> saved) {
+                endPending();
+                if (succeeded(saved)) {
+                    showInfo("Entry Saved", 
+                        QString("Entry '%1' has been saved to the vault.\n\n"
+                                "The credentials were displayed only once and are now encrypted.")
+                        .arg(label));
+                    updateSecurityStatus();
+                } else {
+                    showCriticalError("Save Failed", "Failed to save entry to vault.");
+                }
+            });
         }
     }
 }
@@ -323,22 +357,29 @@ void MainWindow::onViewVault() {
         return;
     }
     
-    VaultViewDialog dialog(vault_.get(), this);
+    VaultViewDialog dialog(async_vault_.get(), this);
     dialog.exec();
     updateSecurityStatus();
 }
 
 void MainWindow::onLockVault() {
-    if (vault_->isOpen()) {
-        vault_->closeVault();
+    if (!vault_->isOpen() || !beginPending("Locking vault...")) {
+        return;
+    }
+    
+    // Queued behind any save still in flight, which lands first
+    async_vault_->closeVault(this, [this](std::future<void> closed) {
+        endPending();
+        closed.wait();
         showWelcomeScreen();
         showInfo("Vault Locked", "Vault has been locked and all sensitive data cleared from memory.");
-    }
+    });
 }
 
 void MainWindow::onSettings() {
-    // Settings functionality coming in future release
-    showInfo("Settings", "Settings functionality coming in future release.");
+    // Only diagnostics so far: operation latencies and their export
+    DiagnosticsDialog dialog(this);
+    dialog.exec();
 }
 
 void MainWindow::onAbout() {
@@ -358,18 +399,42 @@ void MainWindow::onAbout() {
 }
 
 void MainWindow::checkAutoLock() {
-    if (vault_->isOpen() && vault_->shouldAutoLock()) {
+    if (!pending_ && vault_->isOpen() && vault_->shouldAutoLock()) {
         onLockVault();
     }
 }
 
 void MainWindow::closeEvent(QCloseEvent* event) {
-    if (vault_->isOpen()) {
-        vault_->closeVault();
-    }
+    // Lets pending saves finish before the vault is locked
+    async_vault_->closeVault().wait();
     event->accept();
 }
 
+bool MainWindow::beginPending(const QString& message) {
+    if (pending_) {
+        return false;
+    }
+    
+    pending_ = true;
+    central_widget_->setEnabled(false);
+    menuBar()->setEnabled(false);
+    statusBar()->showMessage(message);
+    QApplication::setOverrideCursor(Qt::BusyCursor);
+    return true;
+}
+
+void MainWindow::endPending() {
+    if (!pending_) {
+        return;
+    }
+    
+    pending_ = false;
+    QApplication::restoreOverrideCursor();
+    central_widget_->setEnabled(true);
+    menuBar()->setEnabled(true);
+    updateSecurityStatus();
+}
+
 void MainWindow::showCriticalError(const QString& title, const QString& message) {
     QMessageBox::critical(this, title, message);
 }
@@ -1,5 +1,5 @@
 #include "ui/VaultCreationDialog.h"
-#include "core/PasswordGenerator.h"
+#include "core/AsyncVault.h"
 #include "core/VaultEntry.h"
 
 #include <QtWidgets/QApplication>
@@ -11,8 +11,10 @@
 namespace crimson {
 namespace ui {
 
-VaultCreationDialog::VaultCreationDialog(QWidget* parent)
+VaultCreationDialog::VaultCreationDialog(crimson::core::AsyncVault* vault, QWidget* parent)
     : QDialog(parent)
+    , async_vault_(vault)
+    , generating_(false)
     , credentials_generated_(false)
     , entry_saved_(false)
     , password_hide_timer_(new QTimer(this))
@@ -165,31 +167,34 @@ void VaultCreationDialog::onGenerateCredentials() {
         return;
     }
     
-    try {
-        crimson::core::PasswordGenerator generator;
+    // Create the entry from the vault's pre-generated credential pool, off
+    // the GUI thread: it takes the vault's writer lock, which a save in
+    // flight can hold for as long as the file takes to write
+    generating_ = true;
+    updateButtonStates();
         
-        // Create the entry
-        entry_.id = crimson::core::VaultEntry::generateUuid();
-        entry_.label = label_input_->text().toStdString();
-        entry_.username = generator.generateUsername();
-        entry_.password = generator.generatePassword(64, true);
-        entry_.created_at = crimson::core::VaultEntry::getCurrentTimestamp();
-        entry_.device_fingerprint = crimson::core::VaultEntry::getDeviceFingerprint();
+    async_vault_->createEntry(label_input_->text().toStdString(), this,
+        [this](std::future<crimson::core::VaultEntry> created) {
+            generating_ = false;
         
-        // Display credentials
-        username_display_->setText(QString::fromStdString(entry_.username));
-        password_display_->setText(QString::fromStdString(entry_.password));
+            try {
+                entry_ = created.get();
         
-        credentials_generated_ = true;
-        setCredentialsVisible(true);
-        security_warning_->show();
+                // Display credentials
+                username_display_->setText(QString::fromStdString(entry_.username));
+                password_display_->setText(QString::fromStdString(entry_.password));
         
-        updateButtonStates();
+                credentials_generated_ = true;
+                setCredentialsVisible(true);
+                security_warning_->show();
         
-    } catch (const std::exception& e) {
-        QMessageBox::critical(this, "Generation Failed", 
-            QString("Failed to generate credentials: %1").arg(e.what()));
-    }
+            } catch (const std::exception& e) {
+                QMessageBox::critical(this, "Generation Failed", 
+                    QString("Failed to generate credentials: %1").arg(e.what()));
+            }
+            
+            updateButtonStates();
+        });
 }
 
 void VaultCreationDialog::onSaveEntry() {
@@ -251,15 +256,19 @@ void VaultCreationDialog::setCredentialsVisible(bool visible) {
 
 void VaultCreationDialog::updateButtonStates() {
     bool hasLabel = !label_input_->text().trimmed().isEmpty();
-    bool canGenerate = hasLabel && !credentials_generated_;
+    bool canGenerate = hasLabel && !credentials_generated_ && !generating_;
     bool canSave = credentials_generated_;
     
     generate_btn_->setEnabled(canGenerate);
     save_btn_->setEnabled(canSave);
+    label_input_->setEnabled(!credentials_generated_ && !generating_);
     
     if (credentials_generated_) {
-        label_input_->setEnabled(false);
         generate_btn_->setText("Credentials Generated");
+    } else if (generating_) {
+        generate_btn_->setText("Generating...");
+    } else {
+        generate_btn_->setText("Generate Secure Credentials");
     }
 }
 
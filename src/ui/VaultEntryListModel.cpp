@@ -0,0 +1,155 @@
+#include "ui/VaultEntryListModel.h"
+#include "core/SecureVault.h"
+#include <algorithm>
+#include <climits>
+
+namespace crimson {
+namespace ui {
+
+namespace {
+    QString toQString(std::string_view text) {
+        return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+    }
+    
+    QString idToQString(const crimson::core::EntryId& id) {
+        return QString::fromStdString(id.toString());
+    }
+}
+
+VaultEntryListModel::VaultEntryListModel(crimson::core::SecureVault* vault, QObject* parent)
+    : QAbstractListModel(parent)
+    , vault_(vault)
+    , fetched_rows_(0) {
+}
+
+int VaultEntryListModel::rowCount(const QModelIndex& parent) const {
+    if (parent.isValid()) {
+        return 0;
+    }
+    return isFiltered() ? static_cast<int>(results_.size()) : fetched_rows_;
+}
+
+QVariant VaultEntryListModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    
+    if (isFiltered()) {
+        const auto& result = results_[static_cast<size_t>(index.row())];
+        switch (role) {
+        case Qt::DisplayRole:
+            return QString::fromStdString(result.second);
+        case Qt::ToolTipRole:
+            return QString("Entry ID: %1").arg(idToQString(result.first));
+        case EntryIdRole:
+            return idToQString(result.first);
+        default:
+            return QVariant();
+        }
+    }
+    
+    try {
+        crimson::core::EntryView entry = vault_->getEntryViewAt(static_cast<size_t>(index.row()));
+        switch (role) {
+        case Qt::DisplayRole:
+            return toQString(entry.label);
+        case Qt::ToolTipRole:
+            return QString("Entry ID: %1").arg(idToQString(entry.id));
+        case EntryIdRole:
+            return idToQString(entry.id);
+        default:
+            return QVariant();
+        }
+    } catch (const std::exception&) {
+        return QVariant();
+    }
+}
+
+bool VaultEntryListModel::canFetchMore(const QModelIndex& parent) const {
+    return !parent.isValid() && !isFiltered() && fetched_rows_ < totalCount();
+}
+
+void VaultEntryListModel::fetchMore(const QModelIndex& parent) {
+    if (parent.isValid() || isFiltered()) {
+        return;
+    }
+    
+    int remaining = totalCount() - fetched_rows_;
+    int page = std::min(remaining, FETCH_PAGE_SIZE);
+    if (page <= 0) {
+        return;
+    }
+    
+    beginInsertRows(QModelIndex(), fetched_rows_, fetched_rows_ + page - 1);
+    fetched_rows_ += page;
+    endInsertRows();
+}
+
+crimson::core::EntryId VaultEntryListModel::entryIdAt(int row) const {
+    if (row < 0 || row >= rowCount()) {
+        return crimson::core::EntryId();
+    }
+    
+    if (isFiltered()) {
+        return results_[static_cast<size_t>(row)].first;
+    }
+    
+    try {
+        return vault_->getEntryIdAt(static_cast<size_t>(row));
+    } catch (const std::exception&) {
+        return crimson::core::EntryId();
+    }
+}
+
+int VaultEntryListModel::totalCount() const {
+    return static_cast<int>(std::min<size_t>(vault_->getEntryCount(), INT_MAX));
+}
+
+void VaultEntryListModel::removeDeletedEntry(const crimson::core::EntryId& entryId, size_t position) {
+    if (vault_->hasEntry(entryId)) {
+        return;
+    }
+    
+    if (isFiltered()) {
+        auto it = std::find_if(results_.begin(), results_.end(),
+            [&entryId](const std::pair<crimson::core::EntryId, std::string>& result) {
+                return result.first == entryId;
+            });
+        if (it == results_.end()) {
+            return;
+        }
+        
+        int row = static_cast<int>(it - results_.begin());
+        beginRemoveRows(QModelIndex(), row, row);
+        results_.erase(it);
+        endRemoveRows();
+    } else if (position < static_cast<size_t>(fetched_rows_)) {
+        int row = static_cast<int>(position);
+        beginRemoveRows(QModelIndex(), row, row);
+        --fetched_rows_;
+        endRemoveRows();
+    }
+}
+
+void VaultEntryListModel::reload() {
+    beginResetModel();
+    fetched_rows_ = 0;
+    results_.clear();
+    if (isFiltered()) {
+        results_ = vault_->search(filter_, SEARCH_LIMIT);
+    }
+    endResetModel();
+}
+
+void VaultEntryListModel::setFilter(const QString& query) {
+    std::string filter = query.trimmed().toStdString();
+    if (filter == filter_) {
+        return;
+    }
+    
+    filter_ = std::move(filter);
+    reload();
+}
+
+} // namespace ui
+} // namespace crimson
@@ -7,9 +7,22 @@
 namespace crimson {
 namespace ui {
 
-VaultViewDialog::VaultViewDialog(crimson::core::SecureVault* vault, QWidget* parent)
+namespace {
+    // Pause in typing before the filter is applied
+    constexpr int SEARCH_DEBOUNCE_MS = 150;
+    
+    QString toQString(std::string_view text) {
+        return QString::fromUtf8(text.data(), static_cast<int>(text.size()));
+    }
+}
+
+VaultViewDialog::VaultViewDialog(crimson::core::AsyncVault* vault, QWidget* parent)
     : QDialog(parent)
-    , vault_(vault)
+    , async_vault_(vault)
+    , vault_(&vault->vault())
+    , deleting_(false)
+    , search_timer_(new QTimer(this))
+    , entry_model_(new VaultEntryListModel(vault_, this))
     , password_hide_timer_(new QTimer(this))
     , clipboard_clear_timer_(new QTimer(this)) {
     
@@ -23,6 +36,9 @@ VaultViewDialog::VaultViewDialog(crimson::core::SecureVault* vault, QWidget* par
     clipboard_clear_timer_->setSingleShot(true);
     connect(clipboard_clear_timer_, &QTimer::timeout, this, &VaultViewDialog::clearClipboard);
     
+    search_timer_->setSingleShot(true);
+    connect(search_timer_, &QTimer::timeout, this, &VaultViewDialog::applySearchFilter);
+    
     updateButtonStates();
 }
 
@@ -78,15 +94,27 @@ void VaultViewDialog::setupEntryList() {
     list_group_ = new QGroupBox("Vault Entries");
     list_layout_ = new QVBoxLayout(list_group_);
     
-    // Entry list
-    entry_list_ = new QListWidget;
+    // Search filter (applied after a short pause in typing)
+    search_input_ = new QLineEdit;
+    search_input_->setPlaceholderText("Search labels and usernames...");
+    search_input_->setClearButtonEnabled(true);
+    connect(search_input_, &QLineEdit::textChanged, this, &VaultViewDialog::onSearchTextChanged);
+    list_layout_->addWidget(search_input_);
+    
+    // Entry list (rows are paged in from the vault as the view scrolls)
+    entry_list_ = new QListView;
+    entry_list_->setModel(entry_model_);
+    entry_list_->setUniformItemSizes(true);
+    entry_list_->setSelectionMode(QAbstractItemView::SingleSelection);
+    entry_list_->setEditTriggers(QAbstractItemView::NoEditTriggers);
     entry_list_->setStyleSheet(
-        "QListWidget { font-size: 14px; }"
-        "QListWidget::item { padding: 10px; border-bottom: 1px solid #eee; }"
-        "QListWidget::item:selected { background-color: #2E86AB; color: white; }"
-        "QListWidget::item:hover { background-color: #f0f8ff; }"
+        "QListView { font-size: 14px; }"
+        "QListView::item { padding: 10px; border-bottom: 1px solid #eee; }"
+        "QListView::item:selected { background-color: #2E86AB; color: white; }"
+        "QListView::item:hover { background-color: #f0f8ff; }"
     );
-    connect(entry_list_, &QListWidget::currentRowChanged, this, &VaultViewDialog::onEntrySelectionChanged);
+    connect(entry_list_->selectionModel(), &QItemSelectionModel::currentRowChanged,
+            this, &VaultViewDialog::onEntrySelectionChanged);
     
     list_layout_->addWidget(entry_list_);
     
@@ -195,22 +223,9 @@ void VaultViewDialog::setupEntryDetails() {
 }
 
 void VaultViewDialog::loadEntries() {
-    entry_list_->clear();
-    
     try {
-        auto labels = vault_->getEntryLabels();
-        
-        for (const auto& [id, label] : labels) {
-            auto* item = new QListWidgetItem(QString::fromStdString(label));
-            item->setData(Qt::UserRole, QString::fromStdString(id));
-            item->setToolTip(QString("Entry ID: %1").arg(QString::fromStdString(id)));
-            entry_list_->addItem(item);
-        }
-        
-        security_status_->setText(
-            QString("%1 entries loaded • All passwords encrypted and secure")
-            .arg(labels.size())
-        );
+        entry_model_->reload();
+        updateEntryCountStatus();
         
     } catch (const std::exception& e) {
         QMessageBox::critical(this, "Load Error", 
@@ -218,11 +233,29 @@ void VaultViewDialog::loadEntries() {
     }
 }
 
+void VaultViewDialog::updateEntryCountStatus() {
+    if (entry_model_->isFiltered()) {
+        security_status_->setText(
+            QString("%1 of %2 entries match • All passwords encrypted and secure")
+            .arg(entry_model_->rowCount())
+            .arg(entry_model_->totalCount())
+        );
+        return;
+    }
+    
+    security_status_->setText(
+        QString("%1 entries loaded • All passwords encrypted and secure")
+        .arg(entry_model_->totalCount())
+    );
+}
+
 void VaultViewDialog::onEntrySelectionChanged() {
-    auto* current = entry_list_->currentItem();
-    if (current) {
-        QString entryId = current->data(Qt::UserRole).toString();
-        displayEntryDetails(entryId.toStdString());
+    QModelIndex current = entry_list_->currentIndex();
+    crimson::core::EntryId entryId = current.isValid() ? entry_model_->entryIdAt(current.row())
+                                                        : crimson::core::EntryId();
+    
+    if (!entryId.isNull()) {
+        displayEntryDetails(entryId);
     } else {
         clearEntryDetails();
     }
@@ -230,14 +263,14 @@ void VaultViewDialog::onEntrySelectionChanged() {
     updateButtonStates();
 }
 
-void VaultViewDialog::displayEntryDetails(const std::string& entryId) {
+void VaultViewDialog::displayEntryDetails(const crimson::core::EntryId& entryId) {
     try {
         current_entry_id_ = entryId;
-        auto entry = vault_->getEntry(entryId);
+        crimson::core::EntryView entry = vault_->getEntryView(entryId);
         
-        entry_label_display_->setText(QString(" %1").arg(QString::fromStdString(entry.label)));
-        username_display_->setText(QString::fromStdString(entry.username));
-        created_at_display_->setText(QString::fromStdString(entry.created_at));
+        entry_label_display_->setText(QString(" %1").arg(toQString(entry.label)));
+        username_display_->setText(toQString(entry.username));
+        created_at_display_->setText(QString::fromStdString(entry.created_at.toIso()));
         
         // Reset password display
         password_display_->setText("••••••••••••••••");
@@ -253,7 +286,7 @@ void VaultViewDialog::displayEntryDetails(const std::string& entryId) {
 }
 
 void VaultViewDialog::clearEntryDetails() {
-    current_entry_id_.clear();
+    current_entry_id_ = crimson::core::EntryId();
     entry_label_display_->setText("Select an entry to view details");
     username_display_->clear();
     password_display_->clear();
@@ -265,44 +298,74 @@ void VaultViewDialog::onRefreshEntries() {
     clearEntryDetails();
 }
 
+void VaultViewDialog::onSearchTextChanged() {
+    search_timer_->start(SEARCH_DEBOUNCE_MS);
+}
+
+void VaultViewDialog::applySearchFilter() {
+    entry_list_->setCurrentIndex(QModelIndex());
+    entry_model_->setFilter(search_input_->text());
+    updateEntryCountStatus();
+    clearEntryDetails();
+    updateButtonStates();
+}
+
 void VaultViewDialog::onDeleteEntry() {
-    if (current_entry_id_.empty()) {
+    if (current_entry_id_.isNull()) {
         return;
     }
     
-    auto* current = entry_list_->currentItem();
-    if (!current) {
+    QModelIndex current = entry_list_->currentIndex();
+    if (!current.isValid()) {
         return;
     }
     
-    QString label = current->text();
+    QString label = current.data(Qt::DisplayRole).toString();
     
     if (showConfirmation("Delete Entry", 
         QString("Are you sure you want to delete the entry '%1'?\n\nThis action cannot be undone.").arg(label))) {
         
-        try {
-            if (vault_->deleteEntry(current_entry_id_)) {
-                QMessageBox::information(this, "Entry Deleted", "Entry has been permanently deleted.");
-                loadEntries();
-                clearEntryDetails();
-            } else {
-                QMessageBox::critical(this, "Delete Failed", "Failed to delete entry.");
+        crimson::core::EntryId entryId = entry_model_->entryIdAt(current.row());
+        size_t position = vault_->findEntry(entryId);
+        deleting_ = true;
+        security_status_->setText("Deleting entry...");
+        updateButtonStates();
+        
+        async_vault_->deleteEntry(entryId, this, [this, entryId, position](std::future<bool> deleted) {
+            deleting_ = false;
+            
+            // The vault drops the entry from memory even if persisting
+            // fails, so the row goes whenever the entry is gone. The
+            // filter may have changed meanwhile, so the row is found
+            // again rather than taken from the selection
+            entry_model_->removeDeletedEntry(entryId, position);
+            entry_list_->setCurrentIndex(QModelIndex());
+            clearEntryDetails();
+            updateEntryCountStatus();
+            updateButtonStates();
+            
+            try {
+                if (deleted.get()) {
+                    QMessageBox::information(this, "Entry Deleted", "Entry has been permanently deleted.");
+                } else {
+                    QMessageBox::critical(this, "Delete Failed", "Failed to delete entry.");
+                }
+            } catch (const std::exception& e) {
+                QMessageBox::critical(this, "Delete Error", 
+                    QString("Failed to delete entry: %1").arg(e.what()));
             }
-        } catch (const std::exception& e) {
-            QMessageBox::critical(this, "Delete Error", 
-                QString("Failed to delete entry: %1").arg(e.what()));
-        }
+        });
     }
 }
 
 void VaultViewDialog::onCopyUsername() {
-    if (!current_entry_id_.empty()) {
+    if (!current_entry_id_.isNull()) {
         copyToClipboard(username_display_->text(), "username");
     }
 }
 
 void VaultViewDialog::onCopyPassword() {
-    if (current_entry_id_.empty()) {
+    if (current_entry_id_.isNull()) {
         return;
     }
     
@@ -317,7 +380,7 @@ void VaultViewDialog::onCopyPassword() {
 }
 
 void VaultViewDialog::onShowPasswordTemporary() {
-    if (current_entry_id_.empty()) {
+    if (current_entry_id_.isNull()) {
         return;
     }
     
@@ -351,9 +414,10 @@ void VaultViewDialog::onClose() {
 }
 
 void VaultViewDialog::updateButtonStates() {
-    bool hasSelection = !current_entry_id_.empty();
+    bool hasSelection = !current_entry_id_.isNull();
     
-    delete_btn_->setEnabled(hasSelection);
+    delete_btn_->setEnabled(hasSelection && !deleting_);
+    refresh_btn_->setEnabled(!deleting_);
     copy_username_btn_->setEnabled(hasSelection);
     copy_password_btn_->setEnabled(hasSelection);
     show_password_btn_->setEnabled(hasSelection);